@@ -0,0 +1,102 @@
+/**
+ * @file calibration.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Piecewise linear sensor calibration from integer lookup tables,
+ *        indexed by the raw ADC code.
+ * @version 0.1
+ * @date 2023-09-09
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdint.h>
+
+
+/*
+Every sensor maps its raw 16 bit code, as AnalogIn::read_u16(), to volts or
+amps through CALIBRATION_POINTS breakpoints, one every 2^CALIBRATION_SHIFT
+codes. The upper bits of the code pick the segment, and the lower bits
+interpolate within it:
+
+    k = code >> CALIBRATION_SHIFT
+    r = code & (2^CALIBRATION_SHIFT - 1)
+    y = (p[k] + ((p[k + 1] - p[k]) r >> CALIBRATION_SHIFT)) lsb
+
+The last breakpoint sits at code 65536, one past full scale, so every code
+has a segment and the lookup needs no branch. The breakpoints are integers in
+units of `lsb`, chosen per table such that (p[k + 1] - p[k]) r cannot
+overflow 32 bits; the interpolation is a single integer multiply.
+
+The functions are inline in this header, so that the lookup and the multiply
+stay in the hot path of the control ISR without a call, and so that every
+mbed project including the tables, fw/tests included, links without a
+translation unit outside its source root.
+
+A linear fit of the sensor is the special case of evenly spaced points. More
+points than a line follow the offset of the op-amps near the rails, the
+gain error of the dividers, and the nonlinearity of the Hall sensors. The
+tables are fitted to bench measurements by sw/calibration_fit.py, which
+writes calibration_tables.hpp.
+*/
+
+/** @brief Codes per segment, log2. */
+#define CALIBRATION_SHIFT 12
+
+/** @brief Breakpoints of a table. */
+#define CALIBRATION_POINTS ((1 << (16 - CALIBRATION_SHIFT)) + 1)
+
+/** @brief Definition of the calibration of one sensor. */
+typedef struct CalibrationTable {
+    /** @brief Value at every 2^CALIBRATION_SHIFT codes, in lsb. */
+    int32_t points[CALIBRATION_POINTS];
+
+    /** @brief Unit of the points (V or A). */
+    float lsb;
+} CalibrationTable_t;
+
+/** @brief Definition of the calibration of the sensors of a converter channel. */
+typedef struct CalibrationSet {
+    CalibrationTable_t arrVoltage;
+    CalibrationTable_t arrCurrent;
+    CalibrationTable_t battVoltage;
+    CalibrationTable_t battCurrent;
+} CalibrationSet_t;
+
+/**
+ * @brief CalibrationLookup interpolates the table at a raw code.
+ *
+ * @param table Calibration of the sensor.
+ * @param code  Raw code, as AnalogIn::read_u16().
+ * @return Calibrated value, in units of the lsb of the table.
+ */
+static inline int32_t CalibrationLookup(const CalibrationTable_t * table, uint16_t code) {
+    uint32_t k = code >> CALIBRATION_SHIFT;
+    int32_t r = code & ((1 << CALIBRATION_SHIFT) - 1);
+    int32_t y = table->points[k];
+    return y + (((table->points[k + 1] - y) * r) >> CALIBRATION_SHIFT);
+}
+
+/**
+ * @brief CalibrationApply interpolates the table at a raw code.
+ *
+ * @param table Calibration of the sensor.
+ * @param code  Raw code, as AnalogIn::read_u16().
+ * @return Calibrated value (V or A).
+ */
+static inline float CalibrationApply(const CalibrationTable_t * table, uint16_t code) {
+    return (float) CalibrationLookup(table, code) * table->lsb;
+}
+
+/**
+ * @brief CalibrationCode converts a fraction of full scale, as
+ *        AnalogIn::read(), to a raw code.
+ *
+ * @param fraction Fraction of full scale, from 0 to 1.
+ * @return Raw code, as AnalogIn::read_u16().
+ */
+static inline uint16_t CalibrationCode(float fraction) {
+    if (fraction <= 0.0f) return 0;
+    if (fraction >= 1.0f) return 65535;
+    return (uint16_t) (fraction * 65535.0f + 0.5f);
+}
@@ -0,0 +1,53 @@
+/**
+ * @file calibration_tables.hpp
+ * @author Generated by sw/calibration_fit.py. Do not edit by hand.
+ * @brief Sensor calibration tables of every converter channel.
+ * @note Source: linear defaults, linear defaults
+ */
+#pragma once
+
+/** Device Specific imports. */
+#include "./calibration.hpp"
+
+
+#define CALIBRATION_CHANNELS 2
+
+/** Calibration of every converter channel, by raw code. */
+static constexpr CalibrationSet_t CALIBRATION[CALIBRATION_CHANNELS] = {
+    { // Channel 0, linear defaults
+        { // .arrVoltage, linear default
+            { 0, 71251, 142502, 213753, 285004, 356255, 427507, 498758, 570009, 641260, 712511, 783762, 855013, 926264, 997515, 1068766, 1140017 },
+            0.0001f
+        },
+        { // .arrCurrent, linear default
+            { 4200, 366081, 727961, 1089842, 1451722, 1813603, 2175483, 2537364, 2899244, 3261125, 3623005, 3984886, 4346766, 4708647, 5070527, 5432408, 5794288 },
+            1e-06f
+        },
+        { // .battVoltage, linear default
+            { 393, 105395, 210396, 315398, 420399, 525401, 630403, 735404, 840406, 945407, 1050409, 1155411, 1260412, 1365414, 1470415, 1575417, 1680419 },
+            0.0001f
+        },
+        { // .battCurrent, linear default
+            { 16700, 379206, 741711, 1104217, 1466722, 1829228, 2191733, 2554239, 2916744, 3279250, 3641755, 4004261, 4366766, 4729272, 5091777, 5454283, 5816789 },
+            1e-06f
+        },
+    },
+    { // Channel 1, linear defaults
+        { // .arrVoltage, linear default
+            { 0, 71251, 142502, 213753, 285004, 356255, 427507, 498758, 570009, 641260, 712511, 783762, 855013, 926264, 997515, 1068766, 1140017 },
+            0.0001f
+        },
+        { // .arrCurrent, linear default
+            { 4200, 366081, 727961, 1089842, 1451722, 1813603, 2175483, 2537364, 2899244, 3261125, 3623005, 3984886, 4346766, 4708647, 5070527, 5432408, 5794288 },
+            1e-06f
+        },
+        { // .battVoltage, linear default
+            { 393, 105395, 210396, 315398, 420399, 525401, 630403, 735404, 840406, 945407, 1050409, 1155411, 1260412, 1365414, 1470415, 1575417, 1680419 },
+            0.0001f
+        },
+        { // .battCurrent, linear default
+            { 16700, 379206, 741711, 1104217, 1466722, 1829228, 2191733, 2554239, 2916744, 3279250, 3641755, 4004261, 4366766, 4729272, 5091777, 5454283, 5816789 },
+            1e-06f
+        },
+    },
+};
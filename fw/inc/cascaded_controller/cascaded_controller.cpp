@@ -0,0 +1,106 @@
+/**
+ * @file cascaded_controller.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Cascaded dual-loop controller driver.
+ * @version 0.1
+ * @date 2023-08-20
+ * @copyright Copyright (c) 2023
+ */
+
+/** Device Specific imports. */
+#include "./cascaded_controller.hpp"
+
+
+PILoop_t PILoopInit(float max, float min, float p, float i, float aw) {
+    PILoop_t output = {
+        max,
+        min,
+        p,
+        i,
+        aw,
+        0.0f,
+        min
+    };
+    return output;
+}
+
+float PILoopPropose(const PILoop_t * loop, float error) {
+    float output = loop->p * error + loop->integral + loop->i * error;
+
+    /* Constrain the output to prevent hardware failure down the road. */
+    if (output > loop->max) output = loop->max;
+    else if (output < loop->min) output = loop->min;
+    return output;
+}
+
+void PILoopCommit(PILoop_t * loop, float error, float applied) {
+    float unclamped = loop->p * error + loop->integral + loop->i * error;
+
+    /* Integrate, and bleed off the difference to the applied output. */
+    loop->integral += loop->i * error + loop->aw * (applied - unclamped);
+    loop->output = applied;
+}
+
+float PILoopStep(PILoop_t * loop, float error) {
+    float output = PILoopPropose(loop, error);
+    PILoopCommit(loop, error, output);
+    return output;
+}
+
+void PILoopReset(PILoop_t * loop, float output) {
+    if (output > loop->max) output = loop->max;
+    else if (output < loop->min) output = loop->min;
+    loop->integral = output;
+    loop->output = output;
+}
+
+CascadedController_t CascadedControllerInit(
+    PILoop_t outer,
+    PILoop_t inner,
+    enum OuterLoopMode mode,
+    uint16_t decimation
+) {
+    CascadedController_t output = {
+        outer,
+        inner,
+        mode,
+        decimation == 0 ? (uint16_t) 1 : decimation,
+        0,
+        0.0f,
+        outer.min
+    };
+    return output;
+}
+
+void CascadedControllerSetReference(CascadedController_t * controller, float voltage) {
+    controller->voltageReference = voltage;
+}
+
+bool CascadedControllerOuterDue(CascadedController_t * controller) {
+    bool due = controller->tick == 0;
+    if (++controller->tick >= controller->decimation) controller->tick = 0;
+    return due;
+}
+
+float CascadedControllerStepInner(CascadedController_t * controller, float current) {
+    return PILoopStep(&controller->inner, controller->currentReference - current);
+}
+
+float CascadedControllerStep(CascadedController_t * controller, float voltage, float current) {
+    /* Outer loop. Runs on the first tick and every `decimation` ticks after. */
+    if (CascadedControllerOuterDue(controller)) {
+        float error = controller->voltageReference - voltage;
+        if (controller->mode == ARRAY_VOLTAGE) error = -error;
+        controller->currentReference = PILoopStep(&controller->outer, error);
+    }
+
+    /* Inner loop. */
+    return CascadedControllerStepInner(controller, current);
+}
+
+void CascadedControllerReset(CascadedController_t * controller, float current, float duty) {
+    PILoopReset(&controller->outer, current);
+    PILoopReset(&controller->inner, duty);
+    controller->currentReference = controller->outer.output;
+    controller->tick = 0;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file cascaded_controller.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Cascaded dual-loop controller driver. An outer voltage loop generates
+ *        an inductor current reference for a fast inner current loop, which in
+ *        turn generates the boost duty cycle.
+ * @version 0.1
+ * @date 2023-08-20
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+The overall structure of the cascaded controller is as follows:
+
+                    outer loop (decimated)          inner loop (PWM synchronous)
+               ---------------------------     ---------------------------
+v_ref -(+)---> |  PI, clamp [i_min,i_max] | -> |  PI, clamp [d_min,d_max] | -> duty
+        ^      ---------------------------  ^  ---------------------------     |
+        |                                   |                                  v
+        |                                   ------------------------- i_L <- boost
+        ---------------------------------------------------------- v_sense <- stage
+
+The inner loop runs every control tick. The outer loop runs once every
+`decimation` control ticks and holds its current reference in between. Because
+the outer loop output is clamped to [i_min, i_max], the inductor current is
+always limited by construction, regardless of the voltage error.
+
+Both loops use back-calculation anti-windup: when the output saturates, the
+difference between the clamped and unclamped output is fed back into the
+integrator so that it unwinds instead of accumulating.
+
+The sign of the outer loop depends on the regulated quantity:
+- ARRAY_VOLTAGE:   more inductor current pulls the array voltage down, so the
+                   current reference increases when v_sense is above v_ref.
+- BATTERY_VOLTAGE: more inductor current pushes the battery voltage up, so the
+                   current reference increases when v_sense is below v_ref.
+*/
+
+/** @brief Regulated quantity of the outer loop. */
+enum OuterLoopMode { ARRAY_VOLTAGE, BATTERY_VOLTAGE };
+
+/** @brief Definition of a configuration and state for a single PI loop. */
+typedef struct PILoop {
+    /** @brief The maximum value a control output signal can be. */
+    float max;
+
+    /** @brief The minimum value a control output signal can be. */
+    float min;
+
+    /** Tuned by user or external algorithm. */
+    /* Proportional term. */
+    float p;
+
+    /* Integral term, already scaled by the loop sample period. */
+    float i;
+
+    /* Back-calculation anti-windup gain. 0 disables anti-windup. */
+    float aw;
+
+    /** @brief Integrator state. */
+    float integral;
+
+    /** @brief Last clamped output of the loop. */
+    float output;
+} PILoop_t;
+
+/** @brief Definition of a cascaded dual-loop controller. */
+typedef struct CascadedController {
+    /** @brief Outer voltage loop. Output is the inductor current reference. */
+    PILoop_t outer;
+
+    /** @brief Inner current loop. Output is the boost duty cycle. */
+    PILoop_t inner;
+
+    /** @brief Regulated quantity of the outer loop. */
+    enum OuterLoopMode mode;
+
+    /** @brief Number of inner loop ticks per outer loop tick. */
+    uint16_t decimation;
+
+    /** @brief Inner loop ticks since the last outer loop tick. */
+    uint16_t tick;
+
+    /** @brief Voltage reference of the outer loop. */
+    float voltageReference;
+
+    /** @brief Current reference of the inner loop. */
+    float currentReference;
+} CascadedController_t;
+
+/**
+ * @brief PILoopInit initializes a PILoop_t struct for later use.
+ *
+ * @param max The maximum output value of the loop. Clamped.
+ * @param min The minimum output value of the loop. Clamped.
+ * @param p   The proportional term of the loop.
+ * @param i   The integral term of the loop, scaled by the loop sample period.
+ * @param aw  The back-calculation anti-windup gain of the loop.
+ * @return PI loop parameters with a cleared state.
+ */
+PILoop_t PILoopInit(float max, float min, float p, float i, float aw);
+
+/**
+ * @brief PILoopStep runs the error into the loop and returns the clamped
+ *        output.
+ *
+ * @param loop  PI loop parameters and state.
+ * @param error Error of the loop, oriented so that a positive error should
+ *              increase the output.
+ * @return The clamped output of the loop.
+ */
+float PILoopStep(PILoop_t * loop, float error);
+
+/**
+ * @brief PILoopPropose returns the clamped output the loop would produce for
+ *        `error`, without updating the loop state.
+ *
+ * @param loop  PI loop parameters and state.
+ * @param error Error of the loop, oriented so that a positive error should
+ *              increase the output.
+ * @return The clamped output the loop proposes.
+ */
+float PILoopPropose(const PILoop_t * loop, float error);
+
+/**
+ * @brief PILoopCommit updates the loop state given the output that was
+ *        actually applied, which may differ from what the loop proposed (i.e.
+ *        when another loop won arbitration). The integrator is pulled towards
+ *        the applied output by the anti-windup gain.
+ *
+ * @param loop    PI loop parameters and state.
+ * @param error   Error of the loop, as passed to PILoopPropose.
+ * @param applied Output that was applied to the plant.
+ */
+void PILoopCommit(PILoop_t * loop, float error, float applied);
+
+/**
+ * @brief PILoopReset presets the loop state so that the next output is
+ *        `output` for zero error. Used for bumpless transfer.
+ *
+ * @param loop   PI loop parameters and state.
+ * @param output Output to preset the loop to. Clamped.
+ */
+void PILoopReset(PILoop_t * loop, float output);
+
+/**
+ * @brief CascadedControllerInit initializes a CascadedController_t struct for
+ *        later use.
+ *
+ * @param outer      Outer voltage loop. Its limits are the inductor current
+ *                   limits (A).
+ * @param inner      Inner current loop. Its limits are the duty cycle limits.
+ * @param mode       Regulated quantity of the outer loop.
+ * @param decimation Number of inner loop ticks per outer loop tick. Must be
+ *                   nonzero.
+ * @return Cascaded controller parameters.
+ */
+CascadedController_t CascadedControllerInit(
+    PILoop_t outer,
+    PILoop_t inner,
+    enum OuterLoopMode mode,
+    uint16_t decimation
+);
+
+/**
+ * @brief CascadedControllerSetReference sets the voltage reference of the
+ *        outer loop.
+ *
+ * @param controller Cascaded controller parameters and state.
+ * @param voltage    New voltage reference (V).
+ */
+void CascadedControllerSetReference(CascadedController_t * controller, float voltage);
+
+/**
+ * @brief CascadedControllerStep runs a single inner loop tick, and an outer
+ *        loop tick if one is due.
+ *
+ * @param controller Cascaded controller parameters and state.
+ * @param voltage    Sensed regulated voltage (V).
+ * @param current    Sensed inductor current (A).
+ * @return The next boost duty cycle.
+ * @note Call at a fixed rate, ideally synchronous to the PWM period.
+ */
+float CascadedControllerStep(CascadedController_t * controller, float voltage, float current);
+
+/**
+ * @brief CascadedControllerOuterDue advances the tick counter and returns
+ *        whether an outer loop tick is due. Used when the current reference is
+ *        generated externally, i.e. by a ControlArbiter_t.
+ *
+ * @param controller Cascaded controller parameters and state.
+ * @return True once every `decimation` calls, starting with the first.
+ */
+bool CascadedControllerOuterDue(CascadedController_t * controller);
+
+/**
+ * @brief CascadedControllerStepInner runs a single inner loop tick against
+ *        `currentReference`.
+ *
+ * @param controller Cascaded controller parameters and state.
+ * @param current    Sensed inductor current (A).
+ * @return The next boost duty cycle.
+ */
+float CascadedControllerStepInner(CascadedController_t * controller, float current);
+
+/**
+ * @brief CascadedControllerReset presets both loops for bumpless transfer from
+ *        an operating point that is already established, i.e. when handing
+ *        over from open loop control.
+ *
+ * @param controller Cascaded controller parameters and state.
+ * @param current    Current inductor current (A).
+ * @param duty       Current boost duty cycle.
+ */
+void CascadedControllerReset(CascadedController_t * controller, float current, float duty);
@@ -0,0 +1,265 @@
+/**
+ * @file channel_control.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Sensing, control and tracking of one converter channel.
+ * @version 0.1
+ * @date 2023-09-11
+ * @copyright Copyright (c) 2023
+ */
+
+/** Device Specific imports. */
+#include "./channel_control.hpp"
+
+
+void ChannelControlInit(
+    ChannelControl_t * cc,
+    ChannelOptions_t options,
+    CascadedController_t controller,
+    ControlArbiter_t arbiter,
+    ExplicitMPC_t mpc,
+    MPPT_t mppt,
+    GlobalScan_t scan,
+    ChangeDetector_t detector,
+    EfficiencyMeter_t meter,
+    ModelPredictor_t predictor
+) {
+    /* The scans drive the current reference, which the MPC does not follow. */
+    options.scan = options.scan && !options.mpc;
+    options.detect = options.detect && options.scan;
+    cc->options = options;
+    cc->controller = controller;
+    cc->arbiter = arbiter;
+    cc->mpc = mpc;
+    cc->mppt = mppt;
+    cc->scan = scan;
+    cc->detector = detector;
+    cc->meter = meter;
+    cc->predictor = predictor;
+    cc->request = mppt.id;
+    cc->mpptTick = 0;
+    /* The first tracker step scans. */
+    cc->scanTick = options.scanPeriod > 0 ? options.scanPeriod - 1 : 0;
+    cc->events = 0;
+}
+
+void ChannelControlStart(ChannelControl_t * cc, uint16_t phase) {
+    uint16_t decimation = cc->controller.decimation;
+    CascadedControllerReset(&cc->controller, cc->arrCurrent.getResult(), cc->controller.inner.min);
+    cc->controller.tick = (decimation - phase % decimation) % decimation;
+    ControlArbiterReset(&cc->arbiter, cc->arrCurrent.getResult());
+    ExplicitMPCReset(&cc->mpc, cc->arrVoltage.getResult());
+}
+
+bool ChannelControlSense(ChannelControl_t * cc, const ChannelSample_t * sample) {
+    cc->events = 0;
+    if (cc->mppt.fv.measuring) {
+        /* With the gates off only the array voltage matters; it is kept out
+           of the filters. */
+        if (!(sample->fresh & CHANNEL_ARR_VOLTAGE)) return false;
+        if (!FractionalVocSample(&cc->mppt.fv, sample->arrVoltage)) return false;
+
+        if (cc->options.predict) {
+            ModelPredictorSetVoc(
+                &cc->predictor,
+                sample->arrVoltage,
+                cc->mpptVoltage.getResult(),
+                cc->mpptCurrent.getResult()
+            );
+        }
+        /* Fractional V_oc continues from k V_oc, the others from where they
+           were. The loops held their state through the window, so the array
+           falls back to the operating point within a few ticks. */
+        float reference = cc->mppt.id == MPPT_FRACTIONAL_VOC
+            ? cc->mppt.fv.reference
+            : cc->arbiter.limiters[LOOP_MPPT].reference;
+        ControlArbiterSetReference(&cc->arbiter, LOOP_MPPT, reference);
+        MPPTReset(&cc->mppt, reference);
+        ChangeDetectorReset(&cc->detector);
+        cc->mpptTick = 0;
+        cc->events |= CHANNEL_CLOSED;
+        return false;
+    }
+
+    if (sample->fresh & CHANNEL_ARR_VOLTAGE) cc->arrVoltage.addSample(sample->arrVoltage);
+    if (sample->fresh & CHANNEL_ARR_CURRENT) cc->arrCurrent.addSample(sample->arrCurrent);
+    if (sample->fresh & CHANNEL_BATT_VOLTAGE) cc->battVoltage.addSample(sample->battVoltage);
+    if (cc->options.battCurrentSensor) {
+        if (sample->fresh & CHANNEL_BATT_CURRENT) cc->battCurrent.addSample(sample->battCurrent);
+    } else if ((sample->fresh & CHANNEL_BATT_VOLTAGE) && cc->battVoltage.getResult() > 0.0f) {
+        cc->battCurrent.addSample(
+            cc->arrVoltage.getResult() * cc->arrCurrent.getResult() / cc->battVoltage.getResult()
+        );
+    }
+    return true;
+}
+
+/** @brief Outer loop tick of the tracker, before the arbiter steps. */
+static void ChannelControlTrack(ChannelControl_t * cc) {
+    ControlArbiter_t * arbiter = &cc->arbiter;
+    GlobalScan_t * scan = &cc->scan;
+    MPPT_t * mppt = &cc->mppt;
+
+    /* The tracker only moves while the MPPT loop is in control; otherwise it
+       follows the operating point so it can take over bumplessly. */
+    cc->mpptVoltage.addSample(cc->arrVoltage.getResult());
+    cc->mpptCurrent.addSample(cc->arrCurrent.getResult());
+    bool metering = false;
+    if (cc->options.meter) {
+        /* A sweep holds the tracker, and ends early when another loop takes
+           over. It only starts while nothing else moves the operating point. */
+        EfficiencyMeter_t * meter = &cc->meter;
+        if (EfficiencyMeterRunning(meter)) {
+            if (arbiter->active != LOOP_MPPT) EfficiencyMeterAbort(meter);
+            uint32_t sweeps = meter->sweeps;
+            float reference = EfficiencyMeterStep(meter, cc->arrVoltage.getResult(), cc->arrCurrent.getResult());
+            ControlArbiterSetReference(arbiter, LOOP_MPPT, reference);
+            if (meter->sweeps != sweeps) cc->events |= CHANNEL_SWEPT;
+            if (!EfficiencyMeterRunning(meter)) cc->mpptTick = 0;
+            metering = true;
+        } else if (
+            EfficiencyMeterDue(meter) &&
+            arbiter->active == LOOP_MPPT &&
+            !GlobalScanRunning(scan) &&
+            cc->detector.state == CHANGE_IDLE &&
+            !mppt->fv.request
+        ) {
+            EfficiencyMeterStart(meter, arbiter->limiters[LOOP_MPPT].reference);
+            metering = true;
+        }
+    }
+    if (cc->request != mppt->id && !GlobalScanRunning(scan) && !metering) {
+        /* Continue from the reference the last strategy left. */
+        MPPTSelect(mppt, cc->request, arbiter->limiters[LOOP_MPPT].reference);
+        cc->request = mppt->id;
+        cc->mpptTick = 0;
+    }
+
+    bool averaged = mppt->strategy->averaged;
+    uint16_t decimation = averaged ? cc->options.decimation : 1;
+    if (++cc->mpptTick < decimation || GlobalScanRunning(scan) || metering) return;
+    cc->mpptTick = 0;
+
+    /* The averages would remove the dither ripple extremum seeking
+       demodulates. The raw sample variance sets the decision thresholds of
+       incremental conductance. */
+    MPPTSample_t sample = {
+        averaged ? cc->mpptVoltage.getResult() : cc->arrVoltage.getResult(),
+        averaged ? cc->mpptCurrent.getResult() : cc->arrCurrent.getResult(),
+        cc->arrVoltage.getVariance(),
+        cc->arrCurrent.getVariance()
+    };
+    float reference = sample.voltage;
+    bool held = false;
+    bool tracking = arbiter->active == LOOP_MPPT;
+    if (cc->options.detect && averaged && tracking) {
+        /* Hold the reference while the detector classifies a change, then scan
+           on shading, or predict on a uniform change. */
+        switch (ChangeDetectorStep(
+            &cc->detector,
+            cc->mpptVoltage.getResult(),
+            cc->mpptCurrent.getResult(),
+            arbiter->limiters[LOOP_MPPT].reference
+        )) {
+            case CHANGE_HOLD:
+                reference = cc->detector.reference;
+                held = true;
+                break;
+            case CHANGE_UNIFORM:
+                /* Unless the model disagreed with the last scan. */
+                if (cc->options.predict && cc->predictor.enabled) ModelPredictorReset(&cc->predictor);
+                cc->events |= CHANNEL_UNIFORM;
+                break;
+            case CHANGE_SHADING:
+                cc->scanTick = cc->options.scanPeriod;
+                cc->events |= CHANNEL_SHADING;
+                break;
+            default:
+                break;
+        }
+    }
+    /* A due scan goes first; it finds the global MPP the prediction would
+       only approach, and a hold would postpone it. */
+    if (cc->options.scan) cc->scanTick += decimation;
+    bool scanning = cc->options.scan && !held && tracking && cc->scanTick >= cc->options.scanPeriod;
+    if (cc->options.predict && !held && !scanning && averaged && tracking) {
+        /* Jump to the predicted MPP, and hold there until the array settled,
+           instead of stepping the tracker. */
+        held = ModelPredictorStep(&cc->predictor, cc->mpptVoltage.getResult(), cc->mpptCurrent.getResult());
+        if (held) reference = cc->predictor.vmpp;
+    }
+    if (scanning) {
+        cc->scanTick = 0;
+        GlobalScanStart(scan, cc->mpptVoltage.getResult(), cc->mpptCurrent.getResult());
+    } else if (!held && tracking) {
+        reference = MPPTStep(mppt, &sample);
+        cc->events |= CHANNEL_STEPPED;
+    } else {
+        MPPTReset(mppt, reference);
+    }
+    ControlArbiterSetReference(arbiter, LOOP_MPPT, reference);
+    /* Open the array when fractional V_oc or a scan asks for V_oc. */
+    if (mppt->fv.request && tracking && !GlobalScanRunning(scan)) {
+        FractionalVocStart(&mppt->fv);
+        cc->events |= CHANNEL_OPENED;
+    }
+}
+
+float ChannelControlStep(ChannelControl_t * cc) {
+    ControlArbiter_t * arbiter = &cc->arbiter;
+    GlobalScan_t * scan = &cc->scan;
+
+    /* All limiters are evaluated in the same tick; the most restrictive wins. */
+    if (CascadedControllerOuterDue(&cc->controller)) {
+        cc->events |= CHANNEL_OUTER;
+        if (cc->options.track) ChannelControlTrack(cc);
+        float measurements[NUM_CONTROL_LOOPS] = {
+            cc->arrVoltage.getResult(),
+            cc->battVoltage.getResult(),
+            cc->battCurrent.getResult()
+        };
+        /* The scan drives the current reference itself; the battery limits
+           only end it early. */
+        if (!GlobalScanRunning(scan)) {
+            cc->controller.currentReference = ControlArbiterStep(arbiter, measurements);
+        } else if (
+            measurements[LOOP_BATT_CV] >= arbiter->limiters[LOOP_BATT_CV].reference ||
+            measurements[LOOP_BATT_CC] >= arbiter->limiters[LOOP_BATT_CC].reference
+        ) {
+            GlobalScanAbort(scan);
+        }
+    }
+    if (GlobalScanRunning(scan) || scan->state == SCAN_DONE) {
+        cc->controller.currentReference = GlobalScanStep(
+            scan,
+            cc->arrVoltage.getResult(),
+            cc->arrCurrent.getResult()
+        );
+        if (scan->state == SCAN_DONE) {
+            /* Hand the best point to the arbiter and the tracker. */
+            ControlArbiterReset(arbiter, scan->currentBest);
+            ControlArbiterSetReference(arbiter, LOOP_MPPT, scan->voltageBest);
+            MPPTReset(&cc->mppt, scan->voltageBest);
+            ChangeDetectorReset(&cc->detector);
+            FractionalVocLearn(&cc->mppt.fv, scan->voltageBest, scan->peaks);
+            /* Predictions only help if the model agrees with the global MPP. */
+            if (cc->options.predict) ModelPredictorCheck(&cc->predictor, scan->voltageBest, scan->currentBest);
+            scan->state = SCAN_IDLE;
+            cc->mpptTick = 0;
+            cc->events |= CHANNEL_SCANNED;
+        }
+    }
+
+    if (cc->options.mpc) {
+        /* The array current sensor sits on the inductor side of the input
+           capacitor; the MPC estimates the array current from it. */
+        return ExplicitMPCStep(
+            &cc->mpc,
+            cc->arrVoltage.getResult(),
+            arbiter->limiters[LOOP_MPPT].reference,
+            cc->arrCurrent.getResult(),
+            cc->battVoltage.getResult(),
+            cc->controller.currentReference
+        );
+    }
+    return CascadedControllerStepInner(&cc->controller, cc->arrCurrent.getResult());
+}
@@ -0,0 +1,248 @@
+/**
+ * @file channel_control.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Sensing, control and tracking of one converter channel: the sensor
+ *        filters, the cascaded controller or the explicit MPC, the control
+ *        arbiter, and the maximum power point tracker with its global scans,
+ *        change detector, model predictor, efficiency meter and open circuit
+ *        measurements. Free of hardware, so that fw/src/main.cpp runs it from
+ *        the control ISR and fw/tests/host_sim runs the same code against its
+ *        plant models.
+ * @version 0.1
+ * @date 2023-09-11
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Device Specific imports. */
+#include "../Filter/SmaFilter.h"
+#include "../cascaded_controller/cascaded_controller.hpp"
+#include "../control_arbiter/control_arbiter.hpp"
+#include "../mpc/explicit_mpc.hpp"
+#include "../mppt/change_detector.hpp"
+#include "../mppt/efficiency_meter.hpp"
+#include "../mppt/global_scan.hpp"
+#include "../mppt/model_predictor.hpp"
+#include "../mppt/mppt_strategy.hpp"
+
+
+/*
+Every inner loop tick, the caller converts the sensors of the channel and
+hands them to ChannelControlSense, then, while tracking, applies the duty
+cycle ChannelControlStep returns:
+
+1. ChannelControlSense adds every fresh sample to its 4 sample moving
+   average. A channel without a battery current sensor estimates its battery
+   current from the power balance, v_arr i_arr / v_batt, at every battery
+   voltage sample. The estimate ignores the converter loss, so it reads high
+   and the charge current limit errs on the safe side; unlike the duty cycle
+   times the inductor current, it holds wherever the ADC samples the ripple.
+2. On outer loop ticks, ChannelControlStep averages the filtered array voltage
+   and current over the last CHANNEL_MPPT_WINDOW outer loop ticks, and every
+   `decimation` outer loop ticks steps the tracker on these averages, or every
+   outer loop tick on the filters for a strategy that is not averaged. While
+   the MPPT loop is in control, the change detector may hold the reference
+   first, then a due global scan starts in place of the step, or else the
+   predictor may jump to the predicted MPP; a sweep of the efficiency meter
+   holds the tracker. Then the arbiter min-selects between the MPPT loop and the
+   battery limits.
+3. While a global scan runs, it drives the current reference every inner loop
+   tick, and the battery limits only end it early. Its best point goes to the
+   arbiter, the tracker, fractional V_oc and the predictor when done.
+4. The inner current loop, or the explicit MPC, gives the duty cycle.
+
+Fractional V_oc asks for a measurement every `interval` steps while it is
+selected, and after every scan whatever the strategy. ChannelControlStep then
+raises CHANNEL_OPENED, and the caller disables the gate driver. Until the
+window closes, ChannelControlSense only takes the array voltage, raw, and
+returns false; the filters and the loops hold their state, and the caller
+skips ChannelControlStep. The tick the window closes it raises CHANNEL_CLOSED,
+and the caller enables the gate driver again.
+
+The options replace compile time switches, so that every combination builds
+and the host simulation covers the configurations the firmware runs.
+*/
+
+#define CHANNEL_MPPT_WINDOW 32 // Outer loop ticks averaged for the tracker.
+
+/** @brief Sensors of a channel, as bits of ChannelSample_t::fresh. */
+enum ChannelSensor {
+    CHANNEL_ARR_VOLTAGE=1 << 0,
+    CHANNEL_ARR_CURRENT=1 << 1,
+    CHANNEL_BATT_VOLTAGE=1 << 2,
+    CHANNEL_BATT_CURRENT=1 << 3
+};
+
+/** @brief What the last ChannelControlSense and ChannelControlStep did, as bits. */
+enum ChannelEvent {
+    /** @brief The outer stage ran. */
+    CHANNEL_OUTER=1 << 0,
+    /** @brief The tracker stepped. */
+    CHANNEL_STEPPED=1 << 1,
+    /** @brief A global scan completed. */
+    CHANNEL_SCANNED=1 << 2,
+    /** @brief A V_oc window opened; disable the gate driver. */
+    CHANNEL_OPENED=1 << 3,
+    /** @brief The V_oc window closed; enable the gate driver. */
+    CHANNEL_CLOSED=1 << 4,
+    /** @brief The change detector classified a uniform change. */
+    CHANNEL_UNIFORM=1 << 5,
+    /** @brief The change detector classified partial shading. */
+    CHANNEL_SHADING=1 << 6,
+    /** @brief The efficiency meter completed a sweep. */
+    CHANNEL_SWEPT=1 << 7
+};
+
+/** @brief Definition of the sensor samples of one inner loop tick. */
+typedef struct ChannelSample {
+    /** @brief Array voltage and current (V, A). */
+    float arrVoltage;
+    float arrCurrent;
+
+    /** @brief Battery voltage and current (V, A). */
+    float battVoltage;
+    float battCurrent;
+
+    /** @brief ChannelSensor bits of the samples converted this tick. */
+    uint8_t fresh;
+} ChannelSample_t;
+
+/** @brief Definition of the features a channel runs. */
+typedef struct ChannelOptions {
+    /** @brief Whether the tracker moves the MPPT loop reference, or holds it. */
+    bool track;
+
+    /**
+     * @brief Whether global scans run, every scanPeriod outer loop ticks. Only
+     *        with the cascaded PI loops.
+     */
+    bool scan;
+    uint32_t scanPeriod;
+
+    /**
+     * @brief Whether the change detector classifies the changes the averaged
+     *        strategies see, and starts a scan on shading. Only with scans;
+     *        scanPeriod is then the backstop.
+     */
+    bool detect;
+
+    /** @brief Whether the averaged strategies jump to the predicted MPP. */
+    bool predict;
+
+    /** @brief Whether the efficiency meter sweeps in place of tracker steps. */
+    bool meter;
+
+    /** @brief Whether the explicit MPC replaces both loops of the controller. */
+    bool mpc;
+
+    /** @brief Whether the battery current is sensed, rather than estimated. */
+    bool battCurrentSensor;
+
+    /** @brief Outer loop ticks per step of the averaged strategies. */
+    uint16_t decimation;
+} ChannelOptions_t;
+
+/**
+ * @brief Definition of the control of a channel. The outer loop of the
+ *        controller is unused; the arbiter drives the current reference
+ *        instead.
+ */
+typedef struct ChannelControl {
+    /** @brief Features of the channel. */
+    ChannelOptions_t options;
+
+    /** @brief 4 sample filters of the sensors, every inner loop tick. */
+    SmaFilter arrVoltage{4};
+    SmaFilter arrCurrent{4};
+    SmaFilter battVoltage{4};
+    SmaFilter battCurrent{4};
+
+    /** @brief Averages of the filtered array sensors, every outer loop tick. */
+    SmaFilter mpptVoltage{CHANNEL_MPPT_WINDOW};
+    SmaFilter mpptCurrent{CHANNEL_MPPT_WINDOW};
+
+    /** @brief Control loops. */
+    CascadedController_t controller;
+    ControlArbiter_t arbiter;
+    ExplicitMPC_t mpc;
+
+    /** @brief Tracker and what runs around it. */
+    MPPT_t mppt;
+    GlobalScan_t scan;
+    ChangeDetector_t detector;
+    EfficiencyMeter_t meter;
+    ModelPredictor_t predictor;
+
+    /** @brief Strategy to switch to at the next tracker step. */
+    enum MPPTStrategyID request;
+
+    /** @brief Outer loop ticks since the last tracker step, and global scan. */
+    uint16_t mpptTick;
+    uint32_t scanTick;
+
+    /** @brief ChannelEvent bits of the last tick. */
+    uint8_t events;
+} ChannelControl_t;
+
+/**
+ * @brief ChannelControlInit initializes a ChannelControl_t struct for later
+ *        use. Its filters hold their buffers, so it is initialized in place.
+ *
+ * @param cc         Channel to initialize.
+ * @param options    Features of the channel.
+ * @param controller Cascaded controller; its inner loop gives the duty cycle.
+ * @param arbiter    Arbiter of the MPPT loop and the battery limits.
+ * @param mpc        Explicit MPC, unused without options.mpc.
+ * @param mppt       Tracker, with the strategy to start with.
+ * @param scan       Global scan, unused without options.scan.
+ * @param detector   Change detector, unused without options.detect.
+ * @param meter      Efficiency meter, unused without options.meter.
+ * @param predictor  Model predictor, unused without options.predict.
+ */
+void ChannelControlInit(
+    ChannelControl_t * cc,
+    ChannelOptions_t options,
+    CascadedController_t controller,
+    ControlArbiter_t arbiter,
+    ExplicitMPC_t mpc,
+    MPPT_t mppt,
+    GlobalScan_t scan,
+    ChangeDetector_t detector,
+    EfficiencyMeter_t meter,
+    ModelPredictor_t predictor
+);
+
+/**
+ * @brief ChannelControlStart starts control from the current operating point.
+ *
+ * @param cc    Channel to start.
+ * @param phase Inner loop ticks the outer stage runs after that of the first
+ *              channel.
+ */
+void ChannelControlStart(ChannelControl_t * cc, uint16_t phase);
+
+/**
+ * @brief ChannelControlSense filters the sensor samples of an inner loop
+ *        tick, or takes the array voltage into an open V_oc window.
+ *
+ * @param cc     Channel to sense.
+ * @param sample Samples of the tick.
+ * @return Whether to step the channel; false while the array is open.
+ * @note Call every inner loop tick, whether tracking or not.
+ */
+bool ChannelControlSense(ChannelControl_t * cc, const ChannelSample_t * sample);
+
+/**
+ * @brief ChannelControlStep runs the controller, and on outer loop ticks the
+ *        tracker and the arbiter.
+ *
+ * @param cc Channel to step.
+ * @return The next boost duty cycle.
+ * @note Call every inner loop tick ChannelControlSense returns true, while
+ *       tracking.
+ */
+float ChannelControlStep(ChannelControl_t * cc);
@@ -0,0 +1,56 @@
+/**
+ * @file compensator.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Generic N-pole/N-zero digital compensator.
+ * @version 0.1
+ * @date 2023-08-24
+ * @copyright Copyright (c) 2023
+ */
+
+/** Device Specific imports. */
+#include "./compensator.hpp"
+
+
+Compensator_t CompensatorInit(CompensatorCoefficients_t coeffs, float max, float min) {
+    Compensator_t output = {
+        coeffs,
+        max,
+        min,
+        { 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f }
+    };
+    CompensatorReset(&output, min);
+    return output;
+}
+
+float CompensatorStep(Compensator_t * comp, float error) {
+    const float * b = comp->coeffs.b;
+    const float * a = comp->coeffs.a;
+    float * x = comp->x;
+    float * y = comp->y;
+
+    /* Accumulate from the oldest tap down, shifting the history as we go. */
+    float output = 0.0f;
+    for (uint8_t k = comp->coeffs.order; k > 0; --k) {
+        x[k] = x[k - 1];
+        y[k] = y[k - 1];
+        output += b[k] * x[k] - a[k] * y[k];
+    }
+    x[0] = error;
+    output += b[0] * error;
+
+    /* Constrain the output to prevent hardware failure down the road. */
+    if (output > comp->max) output = comp->max;
+    else if (output < comp->min) output = comp->min;
+    y[0] = output;
+    return output;
+}
+
+void CompensatorReset(Compensator_t * comp, float output) {
+    if (output > comp->max) output = comp->max;
+    else if (output < comp->min) output = comp->min;
+    for (uint8_t k = 0; k <= COMPENSATOR_MAX_ORDER; ++k) {
+        comp->x[k] = 0.0f;
+        comp->y[k] = output;
+    }
+}
@@ -0,0 +1,259 @@
+/**
+ * @file compensator.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Generic N-pole/N-zero digital compensator (2p2z Type II, 3p3z Type
+ *        III). Coefficients are placed from continuous pole and zero
+ *        frequencies and discretized at compile time.
+ * @version 0.1
+ * @date 2023-08-24
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+The compensator is designed in the continuous domain as
+
+                     (1 + s/wz_1) ... (1 + s/wz_m)
+    H(s) = K * ----------------------------------------
+               s^i (1 + s/wp_1) ... (1 + s/wp_n)
+
+where i is 1 with an origin pole (integrator) and 0 without. The common shapes
+are:
+
+- Type II  (2p2z): K (1 + s/wz) / (s (1 + s/wp))
+- Type III (3p3z): K (1 + s/wz_1)(1 + s/wz_2) / (s (1 + s/wp_1)(1 + s/wp_2))
+
+CompensatorDiscretize maps H(s) to H(z) with the bilinear (Tustin) transform
+s = (2/T)(z - 1)/(z + 1). Each pole and zero is prewarped first,
+w' = (2/T) tan(w T / 2), so that the discrete corner lands at the designed
+frequency instead of being pulled down towards Nyquist. The discretization is
+constexpr, so a design written as a constant costs nothing at runtime:
+
+    constexpr CompensatorCoefficients_t COMP = CompensatorTypeII(K, fz, fp, fs);
+
+The runtime evaluates the difference equation in direct form I,
+
+    y[n] = b0 x[n] + sum_{k=1}^{N} (b_k x[n-k] - a_k y[n-k])
+
+in a single loop over the history buffer, which shifts the history as it
+accumulates. The output is clamped before it is written into the history, so
+the compensator cannot wind up while saturated.
+*/
+
+/** @brief Maximum number of poles (and zeros) of a compensator. */
+#define COMPENSATOR_MAX_ORDER 3
+
+/** @brief Definition of a continuous compensator design. */
+typedef struct CompensatorDesign {
+    /** @brief Gain K of the continuous transfer function. */
+    double gain;
+
+    /** @brief Whether the design has a pole at the origin. */
+    bool integrator;
+
+    /** @brief Number of zeros in `zeros`. */
+    uint8_t numZeros;
+
+    /** @brief Zero frequencies (Hz). */
+    double zeros[COMPENSATOR_MAX_ORDER];
+
+    /** @brief Number of poles in `poles`, excluding the integrator. */
+    uint8_t numPoles;
+
+    /** @brief Pole frequencies (Hz). */
+    double poles[COMPENSATOR_MAX_ORDER];
+
+    /** @brief Sample rate of the compensator (Hz). */
+    double sampleRate;
+} CompensatorDesign_t;
+
+/** @brief Definition of discrete compensator coefficients, a[0] = 1. */
+typedef struct CompensatorCoefficients {
+    /** @brief Numerator coefficients of z^-k. */
+    float b[COMPENSATOR_MAX_ORDER + 1];
+
+    /** @brief Denominator coefficients of z^-k. */
+    float a[COMPENSATOR_MAX_ORDER + 1];
+
+    /** @brief Order of the difference equation. */
+    uint8_t order;
+} CompensatorCoefficients_t;
+
+/** @brief Definition of a discrete compensator. */
+typedef struct Compensator {
+    /** @brief Difference equation coefficients. */
+    CompensatorCoefficients_t coeffs;
+
+    /** @brief The maximum value a control output signal can be. */
+    float max;
+
+    /** @brief The minimum value a control output signal can be. */
+    float min;
+
+    /** @brief Input history, x[0] is the most recent error. */
+    float x[COMPENSATOR_MAX_ORDER + 1];
+
+    /** @brief Output history, y[0] is the most recent clamped output. */
+    float y[COMPENSATOR_MAX_ORDER + 1];
+} Compensator_t;
+
+/** Compile time helpers. std::tan is not constexpr. */
+constexpr double COMPENSATOR_PI = 3.14159265358979323846;
+
+constexpr double CompensatorTan(double x) {
+    /* Taylor series of sin and cos; |x| < pi / 2 for any corner below Nyquist. */
+    double term = x;
+    double sin = x;
+    double cos = 1.0;
+    double cosTerm = 1.0;
+    for (int k = 1; k < 16; ++k) {
+        term *= -x * x / ((2 * k) * (2 * k + 1));
+        cosTerm *= -x * x / ((2 * k - 1) * (2 * k));
+        sin += term;
+        cos += cosTerm;
+    }
+    return sin / cos;
+}
+
+/**
+ * @brief CompensatorDiscretize places the poles and zeros of a continuous
+ *        design and discretizes it with a prewarped Tustin transform.
+ *
+ * @param design Continuous design. Every frequency must be nonzero and below
+ *               Nyquist. numPoles plus the integrator must not exceed
+ *               COMPENSATOR_MAX_ORDER, and numZeros must not exceed that.
+ * @return Coefficients of the discrete compensator, with a[0] = 1.
+ */
+constexpr CompensatorCoefficients_t CompensatorDiscretize(const CompensatorDesign_t design) {
+    /* Polynomials in z^-1. */
+    double num[COMPENSATOR_MAX_ORDER + 1] = { design.gain, 0.0, 0.0, 0.0 };
+    double den[COMPENSATOR_MAX_ORDER + 1] = { 1.0, 0.0, 0.0, 0.0 };
+    uint8_t order = design.numPoles + (design.integrator ? 1 : 0);
+    double t = 1.0 / design.sampleRate;
+
+    /*
+     * (1 + s/w') -> ((1 + c) + (1 - c) z^-1) / (1 + z^-1), c = 2 / (T w').
+     * 1/s        -> (T/2) (1 + z^-1) / (1 - z^-1).
+     * The (1 + z^-1) of each zero cancels one from a pole or the integrator,
+     * so num gets the zero factors and order - numZeros factors of (1 + z^-1),
+     * and den gets the pole factors and (1 - z^-1).
+     */
+    uint8_t numOrder = 0;
+    uint8_t denOrder = 0;
+    for (uint8_t n = 0; n < order; ++n) {
+        double f0 = 1.0;
+        double f1 = 1.0;
+        if (n < design.numZeros) {
+            double w = (2.0 / t) * CompensatorTan(COMPENSATOR_PI * design.zeros[n] * t);
+            double c = 2.0 / (t * w);
+            f0 = 1.0 + c;
+            f1 = 1.0 - c;
+        }
+        for (uint8_t k = numOrder + 1; k > 0; --k) num[k] = num[k] * f0 + num[k - 1] * f1;
+        num[0] *= f0;
+        ++numOrder;
+
+        double g0 = 1.0;
+        double g1 = -1.0;
+        if (n < design.numPoles) {
+            double w = (2.0 / t) * CompensatorTan(COMPENSATOR_PI * design.poles[n] * t);
+            double c = 2.0 / (t * w);
+            g0 = 1.0 + c;
+            g1 = 1.0 - c;
+        } else {
+            for (uint8_t k = 0; k <= COMPENSATOR_MAX_ORDER; ++k) num[k] *= t / 2.0;
+        }
+        for (uint8_t k = denOrder + 1; k > 0; --k) den[k] = den[k] * g0 + den[k - 1] * g1;
+        den[0] *= g0;
+        ++denOrder;
+    }
+
+    CompensatorCoefficients_t output = {
+        { 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f },
+        order
+    };
+    for (uint8_t k = 0; k <= order; ++k) {
+        output.b[k] = (float) (num[k] / den[0]);
+        output.a[k] = (float) (den[k] / den[0]);
+    }
+    return output;
+}
+
+/**
+ * @brief CompensatorTypeII designs a 2p2z compensator:
+ *        K (1 + s/wz) / (s (1 + s/wp)).
+ *
+ * @param gain       Gain K of the continuous transfer function.
+ * @param zero       Zero frequency (Hz).
+ * @param pole       Pole frequency (Hz).
+ * @param sampleRate Sample rate of the compensator (Hz).
+ * @return Coefficients of the discrete compensator.
+ */
+constexpr CompensatorCoefficients_t CompensatorTypeII(
+    double gain,
+    double zero,
+    double pole,
+    double sampleRate
+) {
+    return CompensatorDiscretize({ gain, true, 1, { zero, 0.0, 0.0 }, 1, { pole, 0.0, 0.0 }, sampleRate });
+}
+
+/**
+ * @brief CompensatorTypeIII designs a 3p3z compensator:
+ *        K (1 + s/wz1)(1 + s/wz2) / (s (1 + s/wp1)(1 + s/wp2)).
+ *
+ * @param gain       Gain K of the continuous transfer function.
+ * @param zero1      First zero frequency (Hz).
+ * @param zero2      Second zero frequency (Hz).
+ * @param pole1      First pole frequency (Hz).
+ * @param pole2      Second pole frequency (Hz).
+ * @param sampleRate Sample rate of the compensator (Hz).
+ * @return Coefficients of the discrete compensator.
+ */
+constexpr CompensatorCoefficients_t CompensatorTypeIII(
+    double gain,
+    double zero1,
+    double zero2,
+    double pole1,
+    double pole2,
+    double sampleRate
+) {
+    return CompensatorDiscretize({ gain, true, 2, { zero1, zero2, 0.0 }, 2, { pole1, pole2, 0.0 }, sampleRate });
+}
+
+/**
+ * @brief CompensatorInit initializes a Compensator_t struct for later use.
+ *
+ * @param coeffs Discrete coefficients, i.e. from CompensatorTypeII.
+ * @param max    The maximum output value of the compensator. Clamped.
+ * @param min    The minimum output value of the compensator. Clamped.
+ * @return Compensator with a cleared history, resting at `min`.
+ */
+Compensator_t CompensatorInit(CompensatorCoefficients_t coeffs, float max, float min);
+
+/**
+ * @brief CompensatorStep runs the error into the compensator and returns the
+ *        clamped output.
+ *
+ * @param comp  Compensator coefficients and history.
+ * @param error Error, oriented so that a positive error should increase the
+ *              output.
+ * @return The clamped output of the compensator.
+ */
+float CompensatorStep(Compensator_t * comp, float error);
+
+/**
+ * @brief CompensatorReset presets the history so that the output holds at
+ *        `output` for zero error. Used for bumpless transfer. Exact only for
+ *        designs with an integrator; otherwise the output decays to 0.
+ *
+ * @param comp   Compensator coefficients and history.
+ * @param output Output to preset the compensator to. Clamped.
+ */
+void CompensatorReset(Compensator_t * comp, float output);
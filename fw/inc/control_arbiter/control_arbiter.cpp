@@ -0,0 +1,76 @@
+/**
+ * @file control_arbiter.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Min-select arbitration between the MPPT loop and the battery limit
+ *        loops.
+ * @version 0.1
+ * @date 2023-08-21
+ * @copyright Copyright (c) 2023
+ */
+
+/** Device Specific imports. */
+#include "./control_arbiter.hpp"
+
+
+ControlLimiter_t ControlLimiterInit(PILoop_t loop, float reference, float direction) {
+    ControlLimiter_t output = {
+        loop,
+        reference,
+        direction < 0.0f ? -1.0f : 1.0f,
+        loop.min
+    };
+    return output;
+}
+
+ControlArbiter_t ControlArbiterInit(
+    ControlLimiter_t mppt,
+    ControlLimiter_t battCV,
+    ControlLimiter_t battCC
+) {
+    ControlArbiter_t output = {
+        { mppt, battCV, battCC },
+        LOOP_MPPT,
+        0,
+        mppt.loop.min
+    };
+    return output;
+}
+
+void ControlArbiterSetReference(ControlArbiter_t * arbiter, enum ControlLoopID id, float reference) {
+    arbiter->limiters[id].reference = reference;
+}
+
+float ControlArbiterStep(ControlArbiter_t * arbiter, const float measurements[NUM_CONTROL_LOOPS]) {
+    float errors[NUM_CONTROL_LOOPS];
+    enum ControlLoopID active = LOOP_MPPT;
+
+    /* Evaluate every loop and select the lowest proposal. */
+    for (uint8_t id = 0; id < NUM_CONTROL_LOOPS; ++id) {
+        ControlLimiter_t * limiter = &arbiter->limiters[id];
+        errors[id] = limiter->direction * (limiter->reference - measurements[id]);
+        limiter->proposal = PILoopPropose(&limiter->loop, errors[id]);
+        if (limiter->proposal < arbiter->limiters[active].proposal) {
+            active = (enum ControlLoopID) id;
+        }
+    }
+    float output = arbiter->limiters[active].proposal;
+
+    /* Every loop tracks the applied output for bumpless handover. */
+    for (uint8_t id = 0; id < NUM_CONTROL_LOOPS; ++id) {
+        PILoopCommit(&arbiter->limiters[id].loop, errors[id], output);
+    }
+
+    if (active != arbiter->active) ++arbiter->handovers;
+    arbiter->active = active;
+    arbiter->output = output;
+    return output;
+}
+
+void ControlArbiterReset(ControlArbiter_t * arbiter, float current) {
+    for (uint8_t id = 0; id < NUM_CONTROL_LOOPS; ++id) {
+        PILoopReset(&arbiter->limiters[id].loop, current);
+        arbiter->limiters[id].proposal = arbiter->limiters[id].loop.output;
+    }
+    arbiter->active = LOOP_MPPT;
+    arbiter->output = arbiter->limiters[LOOP_MPPT].loop.output;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file control_arbiter.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Min-select arbitration between the MPPT loop and the battery limit
+ *        loops. Each loop proposes an inductor current reference and the most
+ *        restrictive proposal is applied.
+ * @version 0.1
+ * @date 2023-08-21
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Device Specific imports. */
+#include "../cascaded_controller/cascaded_controller.hpp"
+
+
+/*
+The arbiter replaces the single outer loop of the cascaded controller:
+
+                   ---------------
+arr_v  vs MPPT  -> | PI (array)  | --\
+                   ---------------    \    -------
+batt_v vs CV    -> | PI (batt v) | ----+-> | min | -> i_ref -> inner current loop
+                   ---------------    /    -------
+batt_i vs CC    -> | PI (batt i) | --/        |
+                   ---------------            v
+                        ^                  active loop
+                        |                     |
+                        -----------------------  (applied i_ref fed back)
+
+Every loop is evaluated on every outer tick. The lowest proposal wins since
+less inductor current is always the safe direction for a boost charger. Ties go
+to the loop with the lower ControlLoopID, so the tracker keeps control until a
+limit is actually reached.
+
+Handover is bumpless because every loop commits against the applied output:
+with an anti-windup gain of 1.0, each losing loop's integrator is back-calculated
+so that its proposal sits at the applied output, ready to take over without a
+jump or an unwind delay.
+*/
+
+/** @brief Loops participating in arbitration, in priority order for ties. */
+enum ControlLoopID {
+    LOOP_MPPT=0,
+    LOOP_BATT_CV=1,
+    LOOP_BATT_CC=2,
+    NUM_CONTROL_LOOPS=3
+};
+
+/** @brief Definition of a single limiter loop. */
+typedef struct ControlLimiter {
+    /** @brief PI loop. Output is the proposed inductor current reference. */
+    PILoop_t loop;
+
+    /** @brief Reference (setpoint or limit) of the loop. */
+    float reference;
+
+    /**
+     * @brief +1.0 if the current reference must increase when the measurement
+     *        is below the reference, -1.0 if it must increase when the
+     *        measurement is above the reference.
+     */
+    float direction;
+
+    /** @brief Last proposal of the loop, for telemetry. */
+    float proposal;
+} ControlLimiter_t;
+
+/** @brief Definition of a min-select control arbiter. */
+typedef struct ControlArbiter {
+    /** @brief Limiter loops, indexed by ControlLoopID. */
+    ControlLimiter_t limiters[NUM_CONTROL_LOOPS];
+
+    /** @brief Loop that won the last arbitration. */
+    enum ControlLoopID active;
+
+    /** @brief Number of handovers between loops since init. */
+    uint32_t handovers;
+
+    /** @brief Last applied current reference (A). */
+    float output;
+} ControlArbiter_t;
+
+/**
+ * @brief ControlLimiterInit initializes a ControlLimiter_t struct for later
+ *        use.
+ *
+ * @param loop      PI loop. Its limits are the inductor current limits (A).
+ * @param reference Reference (setpoint or limit) of the loop.
+ * @param direction +1.0 or -1.0, see ControlLimiter_t.
+ * @return Limiter parameters.
+ */
+ControlLimiter_t ControlLimiterInit(PILoop_t loop, float reference, float direction);
+
+/**
+ * @brief ControlArbiterInit initializes a ControlArbiter_t struct for later
+ *        use.
+ *
+ * @param mppt   Array voltage loop, tracking the MPPT setpoint.
+ * @param battCV Battery constant voltage limit loop.
+ * @param battCC Battery charge current limit loop.
+ * @return Arbiter parameters.
+ */
+ControlArbiter_t ControlArbiterInit(
+    ControlLimiter_t mppt,
+    ControlLimiter_t battCV,
+    ControlLimiter_t battCC
+);
+
+/**
+ * @brief ControlArbiterSetReference updates the reference of a single loop,
+ *        i.e. the array voltage setpoint from the tracker.
+ *
+ * @param arbiter   Arbiter parameters and state.
+ * @param id        Loop to update.
+ * @param reference New reference of the loop.
+ */
+void ControlArbiterSetReference(ControlArbiter_t * arbiter, enum ControlLoopID id, float reference);
+
+/**
+ * @brief ControlArbiterStep evaluates all loops and applies the most
+ *        restrictive proposal.
+ *
+ * @param arbiter      Arbiter parameters and state.
+ * @param measurements Measurement of each loop, indexed by ControlLoopID.
+ * @return The inductor current reference (A) for the inner loop.
+ * @note Call from the control ISR at the outer loop rate.
+ */
+float ControlArbiterStep(ControlArbiter_t * arbiter, const float measurements[NUM_CONTROL_LOOPS]);
+
+/**
+ * @brief ControlArbiterReset presets every loop to `current` for bumpless
+ *        transfer from an already established operating point.
+ *
+ * @param arbiter Arbiter parameters and state.
+ * @param current Current inductor current (A).
+ */
+void ControlArbiterReset(ControlArbiter_t * arbiter, float current);
@@ -0,0 +1,156 @@
+/**
+ * @file fra.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief On-device frequency response analyzer.
+ * @version 0.1
+ * @date 2023-08-22
+ * @copyright Copyright (c) 2023
+ */
+
+/** General imports. */
+#include <math.h>
+#include <string.h>
+
+/** Device Specific imports. */
+#include "./fra.hpp"
+
+#define PI_F 3.14159265f
+
+
+/** Updates the reference sine and cosine for the current sample. */
+static void FRAUpdateReference(FRA_t * fra) {
+    float theta = 2.0f * PI_F * fra->sample / fra->periods[fra->index];
+    fra->sin = sinf(theta);
+    fra->cos = cosf(theta);
+}
+
+/** Enters `state` for the current point. */
+static void FRAEnter(FRA_t * fra, enum FRAState state) {
+    fra->state = state;
+    fra->sample = 0;
+    fra->cyclesLeft = state == FRA_SETTLE ? fra->settleCycles : fra->measureCycles;
+    fra->xi = fra->xq = fra->yi = fra->yq = 0.0f;
+    FRAUpdateReference(fra);
+}
+
+FRA_t FRAInit(
+    enum FRAMode mode,
+    float sampleRate,
+    float fStart,
+    float fStop,
+    uint8_t numPoints,
+    float amplitude,
+    uint16_t settleCycles,
+    uint16_t measureCycles
+) {
+    FRA_t fra;
+    memset(&fra, 0, sizeof(fra));
+    fra.mode = mode;
+    fra.sampleRate = sampleRate;
+    fra.amplitude = amplitude;
+    fra.settleCycles = settleCycles;
+    fra.measureCycles = measureCycles == 0 ? 1 : measureCycles;
+    fra.state = FRA_IDLE;
+
+    if (numPoints > FRA_MAX_POINTS) numPoints = FRA_MAX_POINTS;
+    if (numPoints == 0) numPoints = 1;
+
+    /* Log-spaced points, snapped to an integer number of samples per period.
+       Points that snap onto the previous one are dropped. */
+    float ratio = numPoints > 1 ? powf(fStop / fStart, 1.0f / (numPoints - 1)) : 1.0f;
+    float frequency = fStart;
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < numPoints; ++i, frequency *= ratio) {
+        float samples = roundf(sampleRate / frequency);
+        if (samples < 4.0f) samples = 4.0f;
+        if (samples > 65535.0f) samples = 65535.0f;
+        uint16_t period = (uint16_t) samples;
+        if (count > 0 && fra.periods[count - 1] == period) continue;
+
+        fra.periods[count] = period;
+        fra.points[count].frequency = sampleRate / period;
+        ++count;
+    }
+    fra.numPoints = count;
+    return fra;
+}
+
+void FRAStart(FRA_t * fra) {
+    fra->index = 0;
+    FRAEnter(fra, FRA_SETTLE);
+}
+
+float FRAPerturbation(const FRA_t * fra) {
+    if (!FRARunning(fra)) return 0.0f;
+    return fra->amplitude * fra->sin;
+}
+
+void FRAStep(FRA_t * fra, float x, float y) {
+    if (!FRARunning(fra)) return;
+
+    if (fra->state == FRA_MEASURE) {
+        fra->xi += x * fra->sin;
+        fra->xq += x * fra->cos;
+        fra->yi += y * fra->sin;
+        fra->yq += y * fra->cos;
+    }
+
+    if (++fra->sample < fra->periods[fra->index]) {
+        FRAUpdateReference(fra);
+        return;
+    }
+    fra->sample = 0;
+    FRAUpdateReference(fra);
+    if (--fra->cyclesLeft > 0) return;
+
+    if (fra->state == FRA_SETTLE) {
+        FRAEnter(fra, FRA_MEASURE);
+        return;
+    }
+
+    /* H = Y / X, with each phasor as I + jQ. */
+    float xMag2 = fra->xi * fra->xi + fra->xq * fra->xq;
+    float hRe = (fra->yi * fra->xi + fra->yq * fra->xq) / xMag2;
+    float hIm = (fra->yq * fra->xi - fra->yi * fra->xq) / xMag2;
+    FRAPoint_t * point = &fra->points[fra->index];
+    point->gain = 10.0f * log10f(hRe * hRe + hIm * hIm);
+    point->phase = atan2f(hIm, hRe) * 180.0f / PI_F;
+
+    /* Next point, or done. The perturbation stays continuous across points
+       since every period ends at a zero crossing. */
+    if (++fra->index >= fra->numPoints) {
+        fra->index = fra->numPoints - 1;
+        fra->state = FRA_DONE;
+        return;
+    }
+    FRAEnter(fra, FRA_SETTLE);
+}
+
+bool FRARunning(const FRA_t * fra) {
+    return fra->state == FRA_SETTLE || fra->state == FRA_MEASURE;
+}
+
+size_t FRASerialize(const FRA_t * fra, uint8_t * buffer, size_t size) {
+    size_t length = 12 + fra->numPoints * sizeof(FRAPoint_t) + 2;
+    if (size < length) return 0;
+
+    uint32_t magic = FRA_MAGIC;
+    uint16_t cycles = fra->measureCycles;
+    memcpy(&buffer[0], &magic, 4);
+    buffer[4] = (uint8_t) fra->mode;
+    buffer[5] = fra->numPoints;
+    memcpy(&buffer[6], &cycles, 2);
+    memcpy(&buffer[8], &fra->sampleRate, 4);
+    memcpy(&buffer[12], fra->points, fra->numPoints * sizeof(FRAPoint_t));
+
+    /* Fletcher-16. */
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    for (size_t i = 0; i < length - 2; ++i) {
+        sum1 = (sum1 + buffer[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    uint16_t checksum = (sum2 << 8) | sum1;
+    memcpy(&buffer[length - 2], &checksum, 2);
+    return length;
+}
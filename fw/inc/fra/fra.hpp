@@ -0,0 +1,186 @@
+/**
+ * @file fra.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief On-device frequency response analyzer. Injects a sinusoidal
+ *        perturbation into the loop and measures the response with synchronous
+ *        I/Q detection over a log-spaced frequency list.
+ * @version 0.1
+ * @date 2023-08-22
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*
+The analyzer measures H(f) = Y(f) / X(f) between two signals sampled in the
+control ISR:
+
+                     perturbation
+                          |
+                          v
+controller -> y_ctrl --> (+) --> x --> plant --> y_plant
+                                              |
+                     ------------------------- (feedback)
+
+- FRA_PLANT:     perturb duty,  x = applied duty,     y = sensed voltage.
+                 H is the duty to voltage plant response.
+- FRA_LOOP:      perturb duty,  x = applied duty,     y = controller duty.
+                 -H is the loop gain, broken at the duty command.
+- FRA_REFERENCE: perturb v_ref, x = voltage reference, y = sensed voltage.
+                 H is the closed loop reference tracking response.
+
+Every point is snapped to an integer number of samples per period, so the I/Q
+sums over whole periods reject DC and the harmonics of the perturbation
+exactly. Each point first settles for `settleCycles` periods, then integrates
+for `measureCycles` periods.
+*/
+
+/** @brief Maximum number of points in a sweep. */
+#define FRA_MAX_POINTS 32
+
+/** @brief Magic word at the start of a serialized table. "FRA1". */
+#define FRA_MAGIC 0x31415246
+
+/** @brief Injection point and measured pair of the sweep. */
+enum FRAMode { FRA_PLANT=0, FRA_LOOP=1, FRA_REFERENCE=2 };
+
+/** @brief State of the sweep. */
+enum FRAState { FRA_IDLE, FRA_SETTLE, FRA_MEASURE, FRA_DONE };
+
+/** @brief Definition of a single measured point. */
+typedef struct FRAPoint {
+    /** @brief Frequency of the point, after snapping (Hz). */
+    float frequency;
+
+    /** @brief Gain of Y/X (dB). */
+    float gain;
+
+    /** @brief Phase of Y/X (deg), in (-180, 180]. */
+    float phase;
+} FRAPoint_t;
+
+/** @brief Definition of a frequency response analyzer. */
+typedef struct FRA {
+    /** @brief Injection point and measured pair. */
+    enum FRAMode mode;
+
+    /** @brief Sample rate of the ISR calling the analyzer (Hz). */
+    float sampleRate;
+
+    /** @brief Peak amplitude of the perturbation. */
+    float amplitude;
+
+    /** @brief Periods to wait for transients to decay at each point. */
+    uint16_t settleCycles;
+
+    /** @brief Periods to integrate over at each point. */
+    uint16_t measureCycles;
+
+    /** @brief Measured points, ordered by frequency. */
+    FRAPoint_t points[FRA_MAX_POINTS];
+
+    /** @brief Number of samples per period of each point. */
+    uint16_t periods[FRA_MAX_POINTS];
+
+    /** @brief Number of points in the sweep. */
+    uint8_t numPoints;
+
+    /** @brief Point currently being measured. */
+    uint8_t index;
+
+    /** @brief State of the sweep. */
+    enum FRAState state;
+
+    /** @brief Sample index within the current period. */
+    uint16_t sample;
+
+    /** @brief Periods remaining in the current state. */
+    uint16_t cyclesLeft;
+
+    /** @brief Reference sine and cosine at the current sample. */
+    float sin;
+    float cos;
+
+    /** @brief I/Q accumulators of X and Y. */
+    float xi;
+    float xq;
+    float yi;
+    float yq;
+} FRA_t;
+
+/**
+ * @brief FRAInit initializes a FRA_t struct for later use.
+ *
+ * @param mode          Injection point and measured pair.
+ * @param sampleRate    Sample rate of the ISR calling the analyzer (Hz).
+ * @param fStart        First frequency of the sweep (Hz).
+ * @param fStop         Last frequency of the sweep (Hz). Should not exceed a
+ *                      quarter of the sample rate.
+ * @param numPoints     Number of log-spaced points. At most FRA_MAX_POINTS.
+ * @param amplitude     Peak amplitude of the perturbation.
+ * @param settleCycles  Periods to settle at each point.
+ * @param measureCycles Periods to integrate over at each point.
+ * @return Analyzer parameters, idle.
+ */
+FRA_t FRAInit(
+    enum FRAMode mode,
+    float sampleRate,
+    float fStart,
+    float fStop,
+    uint8_t numPoints,
+    float amplitude,
+    uint16_t settleCycles,
+    uint16_t measureCycles
+);
+
+/** @brief FRAStart starts (or restarts) the sweep from the first point. */
+void FRAStart(FRA_t * fra);
+
+/**
+ * @brief FRAPerturbation returns the perturbation to add to the injection
+ *        point for the current sample. 0 when the analyzer is not running.
+ *
+ * @param fra Analyzer parameters and state.
+ * @return Perturbation for this sample.
+ */
+float FRAPerturbation(const FRA_t * fra);
+
+/**
+ * @brief FRAStep accumulates the measured pair for the current sample and
+ *        advances to the next sample.
+ *
+ * @param fra Analyzer parameters and state.
+ * @param x   Input side signal for this sample, including the perturbation.
+ * @param y   Output side signal for this sample.
+ * @note Call once per ISR tick, after FRAPerturbation has been applied.
+ */
+void FRAStep(FRA_t * fra, float x, float y);
+
+/**
+ * @brief FRARunning returns whether the sweep is in progress.
+ *
+ * @param fra Analyzer parameters and state.
+ * @return True if settling or measuring.
+ */
+bool FRARunning(const FRA_t * fra);
+
+/**
+ * @brief FRASerialize packs the measured points into a compact little endian
+ *        binary table:
+ *
+ *        uint32 magic (FRA_MAGIC), uint8 mode, uint8 numPoints,
+ *        uint16 measureCycles, float sampleRate,
+ *        numPoints x { float frequency, float gain (dB), float phase (deg) },
+ *        uint16 Fletcher-16 checksum of all preceding bytes.
+ *
+ * @param fra    Analyzer parameters and state.
+ * @param buffer Output buffer.
+ * @param size   Size of the output buffer.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+size_t FRASerialize(const FRA_t * fra, uint8_t * buffer, size_t size);
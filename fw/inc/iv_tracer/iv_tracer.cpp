@@ -0,0 +1,165 @@
+/**
+ * @file iv_tracer.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief On-device I-V curve tracer.
+ * @version 0.1
+ * @date 2023-09-06
+ * @copyright Copyright (c) 2023
+ */
+
+/** General imports. */
+#include <math.h>
+#include <string.h>
+
+/** Device Specific imports. */
+#include "./iv_tracer.hpp"
+
+
+/** Quantizes a value to a 16 bit fraction of full scale. */
+static uint16_t IVTracerQuantize(float value, float scale) {
+    float code = value / scale * 65535.0f + 0.5f;
+    if (code < 0.0f) return 0;
+    if (code > 65535.0f) return 65535;
+    return (uint16_t) code;
+}
+
+/** Enters `state`. */
+static void IVTracerEnter(IVTracer_t * tracer, enum IVTracerState state) {
+    tracer->state = state;
+    tracer->samples = 0;
+}
+
+IVTracer_t IVTracerInit(
+    float dutyStart,
+    float dutyStop,
+    uint16_t points,
+    uint16_t settle,
+    float iStart,
+    float iStop,
+    float iMax,
+    float vMax,
+    float vScale,
+    float iScale,
+    float tolerance,
+    uint8_t window,
+    float sampleRate
+) {
+    IVTracer_t output;
+    memset(&output, 0, sizeof(output));
+    if (points > IV_TRACER_MAX_POINTS) points = IV_TRACER_MAX_POINTS;
+    if (points < 2) points = 2;
+    output.dutyStart = dutyStart;
+    output.dutyStop = dutyStop;
+    output.dutyStep = (dutyStart - dutyStop) / (points - 1);
+    output.settle = settle;
+    output.points = points;
+    output.iStart = iStart;
+    output.iStop = iStop;
+    output.iMax = iMax;
+    output.vMax = vMax;
+    output.vScale = vScale;
+    output.iScale = iScale;
+    output.tolerance = tolerance;
+    output.window = window;
+    output.sampleRate = sampleRate;
+    output.state = TRACE_IDLE;
+    output.end = TRACE_END_POINTS;
+    return output;
+}
+
+void IVTracerStart(IVTracer_t * tracer, float duty) {
+    tracer->duty = duty;
+    tracer->count = 0;
+    tracer->voc = 0.0f;
+    tracer->previous = 0.0f;
+    tracer->end = TRACE_END_POINTS;
+    IVTracerEnter(tracer, TRACE_LEAD);
+}
+
+float IVTracerStep(IVTracer_t * tracer, float voltage, float current) {
+    if (tracer->state != TRACE_OPEN && (current > tracer->iMax || voltage > tracer->vMax)) {
+        tracer->end = TRACE_END_ABORTED;
+        IVTracerEnter(tracer, TRACE_DONE);
+        return tracer->duty;
+    }
+
+    switch (tracer->state) {
+        case TRACE_LEAD:
+            if (tracer->duty < tracer->dutyStart && current < tracer->iStart) {
+                tracer->duty += tracer->dutyStep;
+                if (tracer->duty > tracer->dutyStart) tracer->duty = tracer->dutyStart;
+            } else if (++tracer->samples >= tracer->settle) {
+                tracer->dutyFirst = tracer->duty;
+                IVTracerEnter(tracer, TRACE_SWEEP);
+            }
+            break;
+        case TRACE_SWEEP:
+            tracer->curve[tracer->count].voltage = IVTracerQuantize(voltage, tracer->vScale);
+            tracer->curve[tracer->count].current = IVTracerQuantize(current, tracer->iScale);
+            ++tracer->count;
+            if (current <= tracer->iStop) {
+                tracer->end = TRACE_END_CURRENT;
+                IVTracerEnter(tracer, TRACE_OPEN);
+            } else if (tracer->count >= tracer->points) {
+                tracer->end = TRACE_END_POINTS;
+                IVTracerEnter(tracer, TRACE_OPEN);
+            } else {
+                tracer->duty -= tracer->dutyStep;
+            }
+            break;
+        case TRACE_OPEN:
+            /* The first sample is taken before the gates are off. */
+            if (
+                ++tracer->samples >= 3 &&
+                (fabsf(voltage - tracer->previous) <= tracer->tolerance || tracer->samples >= tracer->window)
+            ) {
+                tracer->voc = voltage;
+                IVTracerEnter(tracer, TRACE_DONE);
+            }
+            tracer->previous = voltage;
+            break;
+        default:
+            break;
+    }
+    return tracer->duty;
+}
+
+bool IVTracerRunning(const IVTracer_t * tracer) {
+    return tracer->state == TRACE_LEAD || tracer->state == TRACE_SWEEP || tracer->state == TRACE_OPEN;
+}
+
+bool IVTracerOpen(const IVTracer_t * tracer) {
+    return tracer->state == TRACE_OPEN;
+}
+
+size_t IVTracerSerialize(const IVTracer_t * tracer, uint8_t * buffer, size_t size) {
+    size_t length = IV_TRACER_RECORD_SIZE(tracer->count);
+    if (size < length) return 0;
+
+    uint32_t magic = IV_TRACER_MAGIC;
+    float header[6] = {
+        tracer->sampleRate,
+        tracer->vScale,
+        tracer->iScale,
+        tracer->dutyFirst,
+        tracer->dutyStep,
+        tracer->voc
+    };
+    memcpy(&buffer[0], &magic, 4);
+    memcpy(&buffer[4], &tracer->count, 2);
+    buffer[6] = (uint8_t) tracer->end;
+    buffer[7] = tracer->window;
+    memcpy(&buffer[8], header, sizeof(header));
+    memcpy(&buffer[32], tracer->curve, tracer->count * sizeof(IVTracerPoint_t));
+
+    /* Fletcher-16. */
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    for (size_t i = 0; i < length - 2; ++i) {
+        sum1 = (sum1 + buffer[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    uint16_t checksum = (sum2 << 8) | sum1;
+    memcpy(&buffer[length - 2], &checksum, 2);
+    return length;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file iv_tracer.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief On-device I-V curve tracer. Ramps the duty cycle open loop from near
+ *        short circuit to open circuit, captures the array voltage and current
+ *        every sample into RAM, and packs them into a compact binary record.
+ * @version 0.1
+ * @date 2023-09-06
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*
+In continuous conduction the boost converter holds the array at
+
+    v_arr = (1 - d) v_batt
+
+so a duty ramp sweeps the array along its I-V curve. At the highest duty the
+array sits far below its MPP, at nearly its short circuit current. The tracer
+bypasses the control loops and drives the duty directly, one step per sample:
+
+1. TRACE_LEAD:  ramps the duty from the operating point up to dutyStart at the
+                sweep rate, so that the input capacitor discharges into the
+                inductor slowly, and waits `settle` samples there. In full sun
+                the short circuit current can exceed the current limits of the
+                converter and the sensor; the ramp then stops early, once the
+                current reaches iStart.
+2. TRACE_SWEEP: ramps the duty down towards dutyStop, capturing a point every
+                sample. Ends when the current falls to iStop, before the
+                synchronous converter would drive current back into the array,
+                or after `points` samples.
+3. TRACE_OPEN:  asks the caller to disable the gate driver, and samples the
+                array voltage until it settles like FractionalVocSample, for
+                at most `window` samples. The settled voltage is V_oc, the last
+                point of the curve.
+
+The trace aborts at once if the current exceeds iMax or the voltage exceeds
+vMax. The caller then re-enables the gate driver, and the control loops
+continue from their state before the trace.
+
+The current sensor sits on the inductor side of the input capacitor; the
+array current is i_L + C dv/dt. At the default sweep of ~100 ms, the
+capacitor current is a few mA, and sw/iv_tracer.py corrects for it.
+
+Points are stored as 16 bit fractions of the full scale of each sensor, so a
+trace of IV_TRACER_MAX_POINTS takes 4 kB of RAM and about as much on the wire.
+*/
+
+/** @brief Maximum number of points in a trace. */
+#define IV_TRACER_MAX_POINTS 1024
+
+/** @brief Magic word at the start of a serialized record. "IVT1". */
+#define IV_TRACER_MAGIC 0x31545649
+
+/** @brief Size of a serialized record with n points (bytes). */
+#define IV_TRACER_RECORD_SIZE(n) (32 + 4 * (n) + 2)
+
+/** @brief State of the trace. */
+enum IVTracerState { TRACE_IDLE, TRACE_LEAD, TRACE_SWEEP, TRACE_OPEN, TRACE_DONE };
+
+/** @brief How the sweep ended. */
+enum IVTracerEnd { TRACE_END_CURRENT=0, TRACE_END_POINTS=1, TRACE_END_ABORTED=2 };
+
+/** @brief Definition of a captured point, as fractions of full scale. */
+typedef struct IVTracerPoint {
+    uint16_t voltage;
+    uint16_t current;
+} IVTracerPoint_t;
+
+/** @brief Definition of an I-V curve tracer. */
+typedef struct IVTracer {
+    /** @brief Duty cycle at the start and the end of the sweep. */
+    float dutyStart;
+    float dutyStop;
+
+    /** @brief Duty cycle step per sample. */
+    float dutyStep;
+
+    /** @brief Samples to settle at dutyStart. */
+    uint16_t settle;
+
+    /** @brief Maximum points of the sweep. */
+    uint16_t points;
+
+    /** @brief Current that ends the lead in, and the sweep (A). */
+    float iStart;
+    float iStop;
+
+    /** @brief Current and voltage that abort the trace (A, V). */
+    float iMax;
+    float vMax;
+
+    /** @brief Full scale of the voltage and current sensors (V, A). */
+    float vScale;
+    float iScale;
+
+    /** @brief Change between open circuit samples that counts as settled (V). */
+    float tolerance;
+
+    /** @brief Maximum samples with the gates off. */
+    uint8_t window;
+
+    /** @brief Sample rate of the ISR calling the tracer (Hz). */
+    float sampleRate;
+
+    /** @brief State of the trace. */
+    enum IVTracerState state;
+
+    /** @brief How the sweep ended. */
+    enum IVTracerEnd end;
+
+    /** @brief Duty cycle applied, and that of the first point. */
+    float duty;
+    float dutyFirst;
+
+    /** @brief Samples into the current state. */
+    uint16_t samples;
+
+    /** @brief Last open circuit sample, and the settled one (V). */
+    float previous;
+    float voc;
+
+    /** @brief Captured points. */
+    IVTracerPoint_t curve[IV_TRACER_MAX_POINTS];
+
+    /** @brief Number of captured points. */
+    uint16_t count;
+} IVTracer_t;
+
+/**
+ * @brief IVTracerInit initializes an IVTracer_t struct for later use.
+ *
+ * @param dutyStart  Duty cycle at the start of the sweep, near short circuit.
+ * @param dutyStop   Lowest duty cycle of the sweep.
+ * @param points     Points of the sweep from dutyStart to dutyStop. At most
+ *                   IV_TRACER_MAX_POINTS.
+ * @param settle     Samples to settle at dutyStart.
+ * @param iStart     Current that ends the lead in early (A). Below iMax and
+ *                   the full scale of the current sensor.
+ * @param iStop      Current that ends the sweep (A).
+ * @param iMax       Current that aborts the trace (A).
+ * @param vMax       Voltage that aborts the trace (V).
+ * @param vScale     Full scale of the voltage sensor (V).
+ * @param iScale     Full scale of the current sensor (A).
+ * @param tolerance  Change between consecutive open circuit samples that
+ *                   counts as settled (V).
+ * @param window     Maximum samples with the gates off.
+ * @param sampleRate Sample rate of the ISR calling the tracer (Hz).
+ * @return Tracer parameters, idle.
+ */
+IVTracer_t IVTracerInit(
+    float dutyStart,
+    float dutyStop,
+    uint16_t points,
+    uint16_t settle,
+    float iStart,
+    float iStop,
+    float iMax,
+    float vMax,
+    float vScale,
+    float iScale,
+    float tolerance,
+    uint8_t window,
+    float sampleRate
+);
+
+/**
+ * @brief IVTracerStart starts a trace from the duty cycle of the operating
+ *        point.
+ *
+ * @param tracer Tracer parameters and state.
+ * @param duty   Duty cycle applied before the trace.
+ */
+void IVTracerStart(IVTracer_t * tracer, float duty);
+
+/**
+ * @brief IVTracerStep observes the array and returns the duty cycle for the
+ *        next sample.
+ *
+ * @param tracer  Tracer parameters and state.
+ * @param voltage Raw array voltage sample (V).
+ * @param current Raw inductor current sample (A).
+ * @return Duty cycle to apply. Meaningless while IVTracerOpen().
+ * @note Call once per ISR tick while IVTracerRunning(), in place of the
+ *       control loops.
+ */
+float IVTracerStep(IVTracer_t * tracer, float voltage, float current);
+
+/**
+ * @brief IVTracerRunning returns whether a trace is in progress.
+ *
+ * @param tracer Tracer parameters and state.
+ * @return True from the lead in until the open circuit voltage settled.
+ */
+bool IVTracerRunning(const IVTracer_t * tracer);
+
+/**
+ * @brief IVTracerOpen returns whether the gate driver should be disabled.
+ *
+ * @param tracer Tracer parameters and state.
+ * @return True while measuring the open circuit voltage.
+ */
+bool IVTracerOpen(const IVTracer_t * tracer);
+
+/**
+ * @brief IVTracerSerialize packs the captured curve into a compact little
+ *        endian binary record:
+ *
+ *        uint32 magic (IV_TRACER_MAGIC), uint16 count, uint8 end,
+ *        uint8 window, float sampleRate, float vScale, float iScale,
+ *        float duty (of the first point), float dutyStep,
+ *        float voc (V, 0 if aborted),
+ *        count x { uint16 voltage, uint16 current } (fractions of vScale and
+ *        iScale, over 65535),
+ *        uint16 Fletcher-16 checksum of all preceding bytes.
+ *
+ * @param tracer Tracer parameters and state.
+ * @param buffer Output buffer, at least IV_TRACER_RECORD_SIZE(count) bytes.
+ * @param size   Size of the output buffer.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+size_t IVTracerSerialize(const IVTracer_t * tracer, uint8_t * buffer, size_t size);
@@ -0,0 +1,95 @@
+/**
+ * @file explicit_mpc.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Explicit model predictive controller for the boost stage.
+ * @version 0.1
+ * @date 2023-08-23
+ * @copyright Copyright (c) 2023
+ */
+
+/** Device Specific imports. */
+#include "./explicit_mpc.hpp"
+#include "./mpc_table.hpp"
+
+
+/** Returns whether region `r` contains theta. */
+static bool ExplicitMPCContains(uint16_t r, const float theta[MPC_NUM_PARAMETERS]) {
+    for (uint16_t facet = MPC_OFFSETS[r]; facet < MPC_OFFSETS[r + 1]; ++facet) {
+        float sum = 0.0f;
+        for (uint8_t j = 0; j < MPC_NUM_PARAMETERS; ++j) {
+            sum += MPC_H[facet][j] * theta[j];
+        }
+        if (sum > MPC_K[facet]) return false;
+    }
+    return true;
+}
+
+ExplicitMPC_t ExplicitMPCInit(float capacitance) {
+    ExplicitMPC_t output = {
+        capacitance * (float) MPC_SAMPLE_RATE,
+        0.0f,
+        0,
+        0,
+        MPC_DUTY_MIN
+    };
+    return output;
+}
+
+void ExplicitMPCReset(ExplicitMPC_t * mpc, float arrVoltage) {
+    mpc->voltagePrev = arrVoltage;
+}
+
+float ExplicitMPCStep(
+    ExplicitMPC_t * mpc,
+    float arrVoltage,
+    float arrReference,
+    float indCurrent,
+    float battVoltage,
+    float currentLimit
+) {
+    float arrCurrent = indCurrent + mpc->capacitance * (arrVoltage - mpc->voltagePrev);
+    mpc->voltagePrev = arrVoltage;
+    float theta[MPC_NUM_PARAMETERS] = {
+        arrVoltage - arrReference,
+        indCurrent - arrCurrent,
+        arrCurrent,
+        arrReference,
+        battVoltage,
+        currentLimit
+    };
+    for (uint8_t j = 0; j < MPC_NUM_PARAMETERS; ++j) {
+        if (theta[j] > MPC_THETA_MAX[j]) theta[j] = MPC_THETA_MAX[j];
+        else if (theta[j] < MPC_THETA_MIN[j]) theta[j] = MPC_THETA_MIN[j];
+    }
+
+    /* Bounded search, starting from the last region hit. */
+    uint16_t r = mpc->region;
+    bool found = false;
+    for (uint16_t n = 0; n < MPC_NUM_REGIONS; ++n) {
+        if (ExplicitMPCContains(r, theta)) {
+            found = true;
+            break;
+        }
+        if (++r >= MPC_NUM_REGIONS) r = 0;
+    }
+
+    if (!found) {
+        ++mpc->misses;
+        mpc->duty = MPC_DUTY_MIN;
+        return mpc->duty;
+    }
+    mpc->region = r;
+
+    /* Affine law for the switch node voltage, then duty. */
+    float vSw = MPC_G[r];
+    for (uint8_t j = 0; j < MPC_NUM_PARAMETERS; ++j) {
+        vSw += MPC_F[r][j] * theta[j];
+    }
+    float duty = 1.0f - vSw / theta[4];
+
+    /* Already within range by construction; guards against float rounding. */
+    if (duty > MPC_DUTY_MAX) duty = MPC_DUTY_MAX;
+    else if (duty < MPC_DUTY_MIN) duty = MPC_DUTY_MIN;
+    mpc->duty = duty;
+    return duty;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file explicit_mpc.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Explicit model predictive controller for the boost stage. The
+ *        piecewise affine control law is solved offline by sw/mpc_design.py
+ *        and compiled into mpc_table.hpp; online, the controller finds the
+ *        region containing the current parameters and evaluates its law.
+ * @version 0.1
+ * @date 2023-08-23
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+The controller replaces both loops of the cascaded controller when tracking an
+array voltage reference. Each tick, the parameter vector
+
+    theta = [v_arr - v_ref, i_L - i_arr, i_arr, v_ref, v_out, i_lim]
+
+is clamped to the box the table was solved over. The regions are searched in
+order, starting with the region hit on the previous tick, since consecutive
+ticks almost always land in the same region. Each region is tested at most
+once, so the worst case is a pass over every facet in the table. The law of
+the region gives the switch node voltage, which maps to duty as
+d = 1 - v_sw / v_out.
+
+The current sensor sits on the inductor side of the input capacitor, so it
+measures i_L. The array current is estimated from the capacitor as
+
+    i_arr = i_L + C_i (v_arr[n] - v_arr[n - 1]) f_ctrl,
+
+like the global scan does; without it, i_L - i_arr would always be zero and
+the controller would be blind to the capacitor current.
+
+The duty cycle range and the inductor current limit i_lim are constraints of
+the offline problem, so every law respects them by construction. i_lim is a
+parameter, so the battery limit loops of the ControlArbiter_t can lower it at
+runtime. If no region contains theta (the problem is infeasible there, i.e. the
+inductor current is already above i_lim), the controller falls back to the
+minimum duty, which sheds current fastest.
+*/
+
+/** @brief Definition of an explicit MPC. */
+typedef struct ExplicitMPC {
+    /** @brief Input capacitance over the sample period (F/s). */
+    float capacitance;
+
+    /** @brief Array voltage of the last step (V). */
+    float voltagePrev;
+
+    /** @brief Region hit on the last step, searched first. */
+    uint16_t region;
+
+    /** @brief Number of steps where no region was found. */
+    uint32_t misses;
+
+    /** @brief Last duty cycle output. */
+    float duty;
+} ExplicitMPC_t;
+
+/**
+ * @brief ExplicitMPCInit initializes an ExplicitMPC_t struct for later use.
+ *
+ * @param capacitance Input capacitance (F).
+ * @return Explicit MPC state.
+ */
+ExplicitMPC_t ExplicitMPCInit(float capacitance);
+
+/**
+ * @brief ExplicitMPCReset restarts the array current estimate from an array
+ *        voltage.
+ *
+ * @param mpc        Explicit MPC state.
+ * @param arrVoltage Sensed array voltage (V).
+ */
+void ExplicitMPCReset(ExplicitMPC_t * mpc, float arrVoltage);
+
+/**
+ * @brief ExplicitMPCStep finds the region of the current parameters and
+ *        evaluates its control law.
+ *
+ * @param mpc          Explicit MPC state.
+ * @param arrVoltage   Sensed array voltage (V).
+ * @param arrReference Array voltage reference (V).
+ * @param indCurrent   Sensed inductor current (A).
+ * @param battVoltage  Sensed battery voltage (V).
+ * @param currentLimit Inductor current limit (A).
+ * @return The next boost duty cycle.
+ * @note Call at MPC_SAMPLE_RATE; the table is only valid at that rate.
+ */
+float ExplicitMPCStep(
+    ExplicitMPC_t * mpc,
+    float arrVoltage,
+    float arrReference,
+    float indCurrent,
+    float battVoltage,
+    float currentLimit
+);
@@ -0,0 +1,490 @@
+/**
+ * @file mpc_table.hpp
+ * @author Generated by sw/mpc_design.py. Do not edit by hand.
+ * @brief Explicit MPC region lookup table.
+ * @note Source: ../docs/v0.3.0/automated/design_parameters.json
+ *       L = 148.6 uH, C_i = 15.00 uF, DCR = 0.1 Ohm, ESR = 0.01 Ohm,
+ *       f_ctrl = 10400.0 Hz, N = 3, q = [0.1, 1.0], r = 0.01.
+ *       Overrides: --ci 1.5e-05.
+ */
+#pragma once
+
+/** General imports. */
+#include <stdint.h>
+
+
+#define MPC_NUM_PARAMETERS 6
+#define MPC_NUM_REGIONS 36
+#define MPC_NUM_FACETS 186
+#define MPC_SAMPLE_RATE 10400.0
+#define MPC_DUTY_MIN 0.1f
+#define MPC_DUTY_MAX 0.9f
+
+/** Parameter order: e_v, d_i, i_arr, v_ref, v_out, i_lim. */
+static const float MPC_THETA_MIN[MPC_NUM_PARAMETERS] = {
+    -15.0f, -6.0f, 0.0f, 20.0f, 70.0f, 0.0f
+};
+static const float MPC_THETA_MAX[MPC_NUM_PARAMETERS] = {
+    15.0f, 6.0f, 7.0f, 75.0f, 130.0f, 6.0f
+};
+
+/** Facets of region r are rows MPC_OFFSETS[r] to MPC_OFFSETS[r + 1]. */
+static const uint16_t MPC_OFFSETS[MPC_NUM_REGIONS + 1] = {
+    0, 8, 14, 19, 23, 28, 31, 37, 45, 49, 55, 61, 65, 73, 78, 83, 88, 94, 98, 103, 107, 110, 114, 120, 124, 132, 138, 142, 146, 152, 158, 162, 167, 171, 175, 181, 186
+};
+
+/** Region r contains theta if MPC_H[i] theta <= MPC_K[i] for its facets. */
+static const float MPC_H[MPC_NUM_FACETS][MPC_NUM_PARAMETERS] = {
+    { 0.545961267f, 0.585819923f, -0.1f, 1.0f, -0.9f, 0.0f },
+    { -0.545961267f, -0.585819923f, 0.1f, -1.0f, 0.1f, 0.0f },
+    { 0.26725473f, -1.38481419f, -0.1f, 1.0f, -0.9f, 0.0f },
+    { -0.26725473f, 1.38481419f, 0.1f, -1.0f, 0.1f, 0.0f },
+    { -0.0771446164f, 0.340135884f, -0.1f, 1.0f, -0.9f, 0.0f },
+    { 0.124414658f, -0.609016179f, 1.0f, 0.0f, 0.0f, -1.0f },
+    { -0.0314771135f, 0.136628974f, 1.0f, 0.0f, 0.0f, -1.0f },
+    { 0.00579233724f, -0.0239381211f, 1.0f, 0.0f, 0.0f, -1.0f },
+    { -0.0678774146f, -1.74441312f, -0.0386161318f, 0.386161318f, -0.347545186f, 0.0f },
+    { -0.491269426f, -0.104222679f, -0.0241475843f, 0.241475843f, -0.217328259f, 0.0f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.246615948f, -1.0f },
+    { -0.218929996f, -0.0645091654f, 1.03433447f, -0.343344655f, 0.309010189f, -1.0f },
+    { 0.0506071848f, 0.0241484962f, 0.99179157f, 0.0820842984f, -0.0738758685f, -1.0f },
+    { -0.291318935f, -0.312587075f, 0.0533589015f, -0.533589015f, 0.480230113f, 0.0f },
+    { 0.575936347f, 0.453657752f, -0.0611443022f, 0.611443022f, -0.55029872f, 0.0f },
+    { 0.309912045f, -1.5728932f, -0.0447047421f, 0.447047421f, -0.402342679f, 0.0f },
+    { -0.027832302f, 0.12055875f, 1.00472465f, -0.0472464801f, 0.0425218321f, -1.0f },
+    { 0.000831988636f, -0.00206760521f, 0.993570065f, 0.064299349f, -0.0578694141f, -1.0f },
+    { 0.0210861747f, -0.0929703849f, 0.0273333068f, -0.273333068f, 0.245999762f, 0.0f },
+    { 0.0678774146f, 1.74441312f, 0.0386161318f, -0.386161318f, 0.0386161318f, 0.0f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.027401772f, -1.0f },
+    { -0.218929996f, -0.0645091654f, 1.03433447f, -0.343344655f, 0.0343344655f, -1.0f },
+    { 0.291318935f, 0.312587075f, -0.0533589015f, 0.533589015f, -0.0533589015f, 0.0f },
+    { 0.426807041f, 1.20323262f, -0.0554154847f, 0.554154847f, -0.498739363f, 0.0f },
+    { -0.286680201f, 1.42587102f, -0.0215970529f, 0.215970529f, -0.194373476f, 0.0f },
+    { 0.157065028f, -0.778198197f, 0.987783053f, 0.122169472f, -0.109952525f, -1.0f },
+    { -0.019197608f, 0.0730011624f, 0.995405318f, 0.0459468222f, -0.04135214f, -1.0f },
+    { -0.103576702f, 0.53669578f, 0.0387557973f, -0.387557973f, 0.348802176f, 0.0f },
+    { -0.426807041f, -1.20323262f, 0.0554154847f, -0.554154847f, 0.0554154847f, 0.0f },
+    { -0.019197608f, 0.0730011624f, 0.995405318f, 0.0459468222f, -0.00459468222f, -1.0f },
+    { 0.103576702f, -0.53669578f, -0.0387557973f, 0.387557973f, -0.0387557973f, 0.0f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, -0.9f, -3.64939903f },
+    { -1.0f, 1.63672313f, -3.54939903f, -1.0f, 0.1f, 3.64939903f },
+    { 0.545961267f, -2.74909709f, 2.14014229f, 1.0f, -0.9f, -2.24014229f },
+    { 0.124414658f, -0.626469302f, 2.25300165f, 0.0f, 0.0f, -2.25300165f },
+    { -0.0314771135f, 0.158497766f, 0.700441642f, 0.0f, 0.0f, -0.700441642f },
+    { -0.884140193f, 4.32791192f, -7.10639892f, 0.0f, 0.0f, 7.10639892f },
+    { 0.601967009f, 0.342722442f, -1.87925278f, 1.0f, -0.9f, 1.77925278f },
+    { -0.601967009f, -0.342722442f, 1.87925278f, -1.0f, 0.1f, -1.77925278f },
+    { 0.25693596f, -1.34002473f, 0.227818188f, 1.0f, -0.9f, -0.327818188f },
+    { -0.25693596f, 1.34002473f, -0.227818188f, -1.0f, 0.1f, 0.327818188f },
+    { -0.0620998162f, 0.274832704f, -0.577959968f, 1.0f, -0.9f, 0.477959968f },
+    { 0.109068093f, -0.542403162f, 1.48754679f, 0.0f, 0.0f, -1.48754679f },
+    { -0.0141514204f, 0.0626293824f, 1.6335955f, 0.0f, 0.0f, -1.6335955f },
+    { 0.0870380479f, -0.377795732f, -2.76512164f, 0.0f, 0.0f, 2.76512164f },
+    { 0.54834203f, 0.575980893f, 0.31101933f, 1.0f, -0.9f, -0.41101933f },
+    { 0.123762287f, -0.60632011f, 0.88737342f, 0.0f, 0.0f, -0.88737342f },
+    { -0.027930934f, 0.121973598f, 1.61221911f, 0.0f, 0.0f, -1.61221911f },
+    { -0.0154761481f, 0.0639586218f, -2.67183132f, 0.0f, 0.0f, 2.67183132f },
+    { 0.151152678f, -1.69794594f, -0.0278500484f, 0.278500484f, -0.250650435f, 0.0f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.246615948f, -1.0f },
+    { -0.278948123f, -0.0772419951f, 1.03138437f, -0.313843678f, 0.28245931f, -1.0f },
+    { 0.0280349158f, 0.0193597953f, 0.990682065f, 0.093179346f, -0.0838614114f, -1.0f },
+    { -0.435738432f, -0.343225634f, 0.0462601857f, -0.462601857f, 0.416341672f, 0.0f },
+    { 0.190395383f, 0.0403923302f, 0.00935858885f, -0.0935858885f, 0.0842272996f, 0.0f },
+    { 0.498683842f, 0.845736539f, -0.050000646f, 0.50000646f, -0.450005814f, 0.0f },
+    { 0.137369511f, -0.680237938f, 0.986299291f, 0.13700709f, -0.123306381f, -1.0f },
+    { 0.0175707776f, -0.109875001f, 0.998175264f, 0.018247359f, -0.0164226231f, -1.0f },
+    { -0.143160465f, 0.728735714f, 1.01434094f, -0.143409438f, 0.129068494f, -1.0f },
+    { -0.21203086f, 1.0761179f, 0.0305854034f, -0.305854034f, 0.27526863f, 0.0f },
+    { 0.138329185f, -0.688012552f, 0.0104210292f, -0.104210292f, 0.0937892625f, 0.0f },
+    { -0.449603644f, 0.96656557f, -0.000443508893f, 0.00443508893f, -0.00399158004f, 0.0f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.246615948f, -1.0f },
+    { -0.313551339f, -0.883947922f, 0.0407106672f, -0.407106672f, 0.366396005f, 0.0f },
+    { 0.0362186428f, 0.930799676f, 0.0206051437f, -0.206051437f, 0.185446293f, 0.0f },
+    { 0.6176483f, 0.273322373f, -3.68945172f, 1.0f, -0.9f, 3.58945172f },
+    { -0.6176483f, -0.273322373f, 3.68945172f, -1.0f, 0.1f, -3.58945172f },
+    { 0.286210426f, -1.46958357f, -3.15153422f, 1.0f, -0.9f, 3.05153422f },
+    { -0.286210426f, 1.46958357f, 3.15153422f, -1.0f, 0.1f, -3.05153422f },
+    { -0.0698658653f, 0.309202601f, 0.318528338f, 1.0f, -0.9f, -0.418528338f },
+    { 0.104771141f, -0.523386313f, 1.98357338f, 0.0f, 0.0f, -1.98357338f },
+    { 0.126176015f, -0.551007087f, -7.28308558f, 0.0f, 0.0f, 7.28308558f },
+    { 0.0617712196f, -0.273378448f, -7.13067551f, 0.0f, 0.0f, 7.13067551f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, -0.9f, -3.64939903f },
+    { -0.0678774146f, 0.341785423f, 1.3544552f, 0.386161318f, -0.347545186f, -1.39307133f },
+    { 0.27401772f, -1.37977062f, 2.83943856f, 0.27401772f, -0.246615948f, -2.86684033f },
+    { -0.291318935f, 1.466888f, -1.14195641f, -0.533589015f, 0.480230113f, 1.19531532f },
+    { -1.53673606f, 7.61394977f, -9.66454378f, -1.19531532f, 1.07578378f, 9.78407531f },
+    { -0.474679471f, -0.0963063626f, 0.300979731f, 0.268384569f, -0.241546112f, -0.327818188f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.246615948f, -1.0f },
+    { -0.194256626f, -0.0527356436f, 1.51787926f, -0.303324719f, 0.272992247f, -1.48754679f },
+    { -0.302805403f, -0.318068134f, -0.171751076f, -0.55221994f, 0.496997946f, 0.22697307f },
+    { -0.139935022f, -0.0667735295f, -2.74242433f, -0.22697307f, 0.204275763f, 2.76512164f },
+    { 0.621312869f, 0.257104233f, -1.6992018f, 0.68847154f, -0.619624386f, 1.63035464f },
+    { 0.293051592f, -1.49986025f, 0.563944617f, 0.418426107f, -0.376583496f, -0.605787227f },
+    { -0.0163347338f, 0.0722919863f, 1.61327551f, 0.0351581299f, -0.0316423169f, -1.61679133f },
+    { 0.0173660931f, -0.0768564326f, 0.161625384f, -0.27964806f, 0.251683254f, -0.133660578f },
+    { 0.0787377506f, -0.341061434f, -2.84237211f, 0.133660578f, -0.12029452f, 2.82900605f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, -0.9f, -3.64939903f },
+    { -1.0f, 1.63672313f, -3.54939903f, -1.0f, 0.1f, 3.64939903f },
+    { 1.0f, -5.03533355f, 10.3622443f, 1.0f, -0.9f, -10.4622443f },
+    { 0.124414658f, -0.626469302f, 3.52345642f, 0.0f, 0.0f, -3.52345642f },
+    { -1.99196931f, 9.90620105f, -27.1678681f, -0.0f, -0.0f, 27.1678681f },
+    { -0.884140193f, 4.45194078f, -16.0107285f, 0.0f, 0.0f, 16.0107285f },
+    { -0.464335549f, -1.06052605f, 2.00128688f, -0.464335549f, 0.0464335549f, -1.95485332f },
+    { -0.0620646641f, 0.312516285f, 1.59111212f, -0.186479322f, 0.0186479322f, -1.57246419f },
+    { 0.101100374f, -0.527279255f, 0.089642976f, 0.393484721f, -0.0393484721f, -0.128991448f },
+    { 0.0538955064f, -0.204944002f, -2.79450824f, -0.128991448f, 0.0128991448f, 2.80740738f },
+    { 0.86684033f, 1.9798328f, -3.73608306f, 0.86684033f, -0.086684033f, 3.64939903f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.027401772f, -1.0f },
+    { -0.223712461f, -0.0566815943f, 2.28781436f, -0.34812712f, 0.034812712f, -2.25300165f },
+    { 0.825495884f, 0.469985832f, -2.57707716f, 1.37133077f, -0.137133077f, 2.43994408f },
+    { 1.55580389f, 0.458427864f, -7.35039333f, 2.43994408f, -0.243994408f, 7.10639892f },
+    { 0.576080968f, 0.453298348f, 0.111564045f, 0.622619923f, -0.56035793f, -0.173826037f },
+    { 0.308338848f, -1.56898359f, -1.92343406f, 0.325464579f, -0.292918121f, 1.8908876f },
+    { -0.0273272375f, 0.119303596f, 1.60787827f, -0.00821311316f, 0.00739180185f, -1.60705695f },
+    { -0.00231655412f, 0.00575695287f, -2.76645465f, -0.1790324f, 0.16112916f, 2.78435789f },
+    { -0.237529611f, -0.54250927f, 1.02375296f, -0.237529611f, 0.0237529611f, -1.0f },
+    { 0.313551339f, 0.883947922f, -0.0407106672f, 0.407106672f, -0.0407106672f, 0.0f },
+    { -0.0362186428f, -0.930799676f, -0.0206051437f, 0.206051437f, -0.0206051437f, 0.0f },
+    { -0.981703769f, -0.248732388f, 2.29290879f, -0.527665037f, 0.474898533f, -2.24014229f },
+    { -0.223712461f, -0.0566815943f, 2.28781436f, -0.34812712f, 0.313314408f, -2.25300165f },
+    { -0.825495884f, -0.469985832f, 2.57707716f, -1.37133077f, 1.2341977f, -2.43994408f },
+    { 1.55580389f, 0.458427864f, -7.35039333f, 2.43994408f, -2.19594968f, 7.10639892f },
+    { 0.464335549f, 1.06052605f, -2.00128688f, 0.464335549f, -0.417901994f, 1.95485332f },
+    { -0.272354585f, 1.37139618f, -0.764387202f, 0.181684147f, -0.163515732f, 0.746218788f },
+    { 0.146781551f, -0.73909407f, 1.5209863f, 0.146781551f, -0.132103396f, -1.53566445f },
+    { -0.0620646641f, 0.312516285f, 1.59111212f, -0.186479322f, 0.16783139f, -1.57246419f },
+    { -0.101100374f, 0.527279255f, -0.089642976f, -0.393484721f, 0.354136248f, 0.128991448f },
+    { 0.0538955064f, -0.204944002f, -2.79450824f, -0.128991448f, 0.116092303f, 2.80740738f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, -0.9f, -3.64939903f },
+    { 0.109068093f, -0.549194226f, 2.59449972f, 0.0f, 0.0f, -2.59449972f },
+    { -0.910213168f, 4.45919804f, -6.5262124f, 0.0f, 0.0f, 6.5262124f },
+    { 0.0870380479f, -0.438265602f, -1.93680634f, 0.0f, 0.0f, 1.93680634f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, -0.9f, -3.64939903f },
+    { -1.0f, 1.63672313f, -3.54939903f, -1.0f, 0.1f, 3.64939903f },
+    { 1.0f, -5.03533355f, 10.3622443f, 1.0f, -0.9f, -10.4622443f },
+    { -1.0f, 5.03533355f, -10.3622443f, -1.0f, 0.1f, 10.4622443f },
+    { 1.0f, -5.03533355f, 20.5737f, 1.0f, -0.9f, -20.6737f },
+    { -3.11522944f, 15.5621904f, -58.9788955f, -0.0f, -0.0f, 58.9788955f },
+    { -1.99196931f, 10.0302299f, -47.3847456f, -0.0f, -0.0f, 47.3847456f },
+    { -0.884140193f, 4.45194078f, -25.0390869f, 0.0f, 0.0f, 25.0390869f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.246615948f, -1.0f },
+    { -0.237529611f, -0.54250927f, 1.02375296f, -0.237529611f, 0.21377665f, -1.0f },
+    { -0.049286833f, 0.887939509f, 1.00492868f, -0.049286833f, 0.0443581497f, -1.0f },
+    { -0.405128822f, -0.687073089f, 0.0406203311f, -0.406203311f, 0.36558298f, 0.0f },
+    { -0.111043445f, 1.24738622f, 0.0204598779f, -0.204598779f, 0.184138901f, 0.0f },
+    { 0.239903565f, -0.51574877f, 0.000236651473f, -0.00236651473f, 0.00212986326f, 0.0f },
+    { 0.86684033f, 1.9798328f, -3.73608306f, 0.86684033f, -0.086684033f, 3.64939903f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.027401772f, -1.0f },
+    { 1.3789449f, 0.610212139f, -8.23697017f, 2.23257296f, -0.223257296f, 8.01371287f },
+    { 1.58978999f, 0.402802021f, -16.2581215f, 2.47393019f, -0.247393019f, 16.0107285f },
+    { -0.464335549f, -1.06052605f, 2.00128688f, -0.464335549f, 0.0464335549f, -1.95485332f },
+    { 0.146781551f, -0.73909407f, 1.5209863f, 0.146781551f, -0.0146781551f, -1.53566445f },
+    { 0.183348247f, -0.941424728f, -2.01889317f, 0.640606457f, -0.0640606457f, 1.95483252f },
+    { 0.441056262f, -2.22086539f, -11.3070775f, 1.32519646f, -0.132519646f, 11.1745578f },
+    { 0.642617161f, 0.162818669f, -3.80328829f, 0.642617161f, -0.578355445f, 3.73902657f },
+    { 0.332823303f, -1.67587634f, -3.3640489f, 0.332823303f, -0.299540973f, 3.33076657f },
+    { 0.0979292306f, -0.49310634f, 2.01476661f, 0.0979292306f, -0.0881363075f, -2.02455954f },
+    { 0.0199222365f, -0.0881690554f, -0.0908282872f, -0.285149786f, 0.256634807f, 0.119343266f },
+    { 0.123581065f, -0.539522718f, -7.27125484f, 0.0371418907f, -0.0334277017f, 7.26754065f },
+    { 0.0727041905f, -0.321764065f, -7.18052046f, -0.156485156f, 0.140836641f, 7.19616898f },
+    { 0.0963485293f, -1.7357915f, -1.96448818f, 0.0963485293f, -0.0867136764f, 1.95485332f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.246615948f, -1.0f },
+    { -0.263930815f, -0.0668716409f, 1.56205753f, -0.263930815f, 0.237537734f, -1.53566445f },
+    { -0.439455888f, -0.345792761f, -0.0851051834f, -0.474957526f, 0.427461773f, 0.132600936f },
+    { 0.186779119f, 0.0378950822f, -0.118430925f, -0.105605227f, 0.0950447045f, 0.128991448f },
+    { -0.0787054297f, -0.0543508324f, -2.78124815f, -0.261592384f, 0.235433146f, 2.80740738f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, -0.9f, -3.64939903f },
+    { 0.27401772f, -1.37977062f, 2.83943856f, 0.27401772f, -0.246615948f, -2.86684033f },
+    { 0.0362186428f, -0.182372947f, -0.722722413f, -0.206051437f, 0.185446293f, 0.743327557f },
+    { -1.48628091f, 7.35989125f, -10.6713477f, -1.48235967f, 1.3341237f, 10.8195836f },
+    { -1.79811981f, -0.455586143f, 10.6420563f, -1.79811981f, 1.61830783f, -10.4622443f },
+    { 0.27401772f, -0.44849114f, 0.972598228f, 0.27401772f, -0.246615948f, -1.0f },
+    { -1.3789449f, -0.610212139f, 8.23697017f, -2.23257296f, 2.00931567f, -8.01371287f },
+    { 3.54781337f, 0.963139459f, -27.7218464f, 5.53978269f, -4.98580442f, 27.1678681f },
+    { 1.58978999f, 0.402802021f, -16.2581215f, 2.47393019f, -2.22653717f, 16.0107285f },
+    { -0.49271669f, -0.124838676f, 2.916112f, -0.49271669f, 0.443445021f, -2.86684033f },
+    { -1.62572708f, -0.672738865f, 4.44613094f, -1.80145444f, 1.62130899f, -4.2659855f },
+    { 0.523826347f, 0.13272087f, -1.22347094f, 0.281556267f, -0.25340064f, 1.19531532f },
+    { 2.72924944f, 0.755741497f, -10.0911423f, 3.07067018f, -2.76360317f, 9.78407531f },
+    { -0.261825891f, 4.71699111f, 5.33847139f, -0.261825891f, 0.235643302f, -5.3122888f },
+    { -0.371465946f, 1.87045494f, 3.75463375f, -0.371465946f, 0.334319352f, -3.71748716f },
+    { -1.73698075f, 8.83863425f, 10.8353779f, -1.833456f, 1.6501104f, -10.6520323f },
+    { 3.28211881f, -16.7071069f, -23.2549363f, 3.28782681f, -2.95904413f, 22.9261537f },
+    { 0.464335549f, 1.06052605f, -2.00128688f, 0.464335549f, -0.417901994f, 1.95485332f },
+    { 0.146781551f, -0.73909407f, 1.5209863f, 0.146781551f, -0.132103396f, -1.53566445f },
+    { -0.136694647f, 0.688303139f, 1.38165648f, -0.136694647f, 0.123025182f, -1.36798702f },
+    { -0.220022465f, 1.12609165f, -0.423408329f, -0.314153364f, 0.282738028f, 0.454823665f },
+    { 0.145325415f, -0.731761937f, 0.407868614f, -0.096944665f, 0.0872501985f, -0.398174148f },
+    { -0.0545490486f, 0.341110503f, -3.09886746f, -0.0566495176f, 0.0509845659f, 3.10453241f },
+    { 0.464335549f, 1.06052605f, -2.00128688f, 0.464335549f, -0.417901994f, 1.95485332f },
+    { -0.49885331f, 2.51189281f, 5.04221583f, -0.49885331f, 0.448967979f, -4.9923305f },
+    { 0.146781551f, -0.73909407f, 1.5209863f, 0.146781551f, -0.132103396f, -1.53566445f },
+    { -0.183348247f, 0.941424728f, 2.01889317f, -0.640606457f, 0.576545812f, -1.95483252f },
+    { 0.441056262f, -2.22086539f, -11.3070775f, 1.32519646f, -1.19267681f, 11.1745578f },
+};
+static const float MPC_K[MPC_NUM_FACETS] = {
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+};
+
+/** Switch node voltage law of region r: v_sw = MPC_F[r] theta + MPC_G[r]. */
+static const float MPC_F[MPC_NUM_REGIONS][MPC_NUM_PARAMETERS] = {
+    { 0.545961267f, 0.585819923f, -0.1f, 1.0f, 0.0f, 0.0f },
+    { -1.24514607e-17f, -1.37976867e-16f, 1.38777878e-17f, 0.0f, 0.9f, 0.0f },
+    { 0.575936347f, 0.453657752f, -0.0611443022f, 0.611443022f, 0.34970128f, 0.0f },
+    { -1.24514607e-17f, -1.37976867e-16f, 1.38777878e-17f, 0.0f, 0.1f, 0.0f },
+    { 0.426807041f, 1.20323262f, -0.0554154847f, 0.554154847f, 0.401260637f, 0.0f },
+    { 0.426807041f, 1.20323262f, -0.0554154847f, 0.554154847f, 0.0445845153f, 0.0f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, 0.0f, -3.64939903f },
+    { 0.601967009f, 0.342722442f, -1.87925278f, 1.0f, 0.0f, 1.77925278f },
+    { 0.54834203f, 0.575980893f, 0.31101933f, 1.0f, 0.0f, -0.41101933f },
+    { 2.33918679e-17f, -2.24123747e-16f, 1.38777878e-17f, 0.0f, 0.9f, 0.0f },
+    { 0.498683842f, 0.845736539f, -0.050000646f, 0.50000646f, 0.449994186f, 0.0f },
+    { -1.24514607e-17f, -1.37976867e-16f, 0.0f, -2.22044605e-16f, 0.9f, 0.0f },
+    { 0.6176483f, 0.273322373f, -3.68945172f, 1.0f, 0.0f, 3.58945172f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, -6.66393091e-17f, -3.64939903f },
+    { -8.23349164e-17f, -1.97193534e-16f, -1.38777878e-16f, -2.22044605e-16f, 0.9f, 1.65896552e-16f },
+    { 0.621312869f, 0.257104233f, -1.6992018f, 0.68847154f, 0.280375614f, 1.63035464f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, 0.0f, -3.64939903f },
+    { 0.464335549f, 1.06052605f, -2.00128688f, 0.464335549f, 0.0535664451f, 1.95485332f },
+    { -1.24514607e-17f, -1.37976867e-16f, 6.9388939e-16f, -4.4408921e-16f, 0.1f, -6.54043557e-16f },
+    { 0.576080968f, 0.453298348f, 0.111564045f, 0.622619923f, 0.33964207f, -0.173826037f },
+    { -1.24514607e-17f, -1.37976867e-16f, 0.0f, -2.22044605e-16f, 0.1f, 0.0f },
+    { -1.24514607e-17f, -1.37976867e-16f, 6.9388939e-16f, -4.4408921e-16f, 0.9f, -6.54043557e-16f },
+    { 0.464335549f, 1.06052605f, -2.00128688f, 0.464335549f, 0.482098006f, 1.95485332f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, 0.0f, -3.64939903f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, 0.0f, -3.64939903f },
+    { -1.68777626e-17f, -2.5831024e-16f, 1.38777878e-17f, 0.0f, 0.9f, 0.0f },
+    { -5.87004809e-16f, -1.08322118e-16f, 3.89965837e-15f, -6.66133815e-16f, 0.1f, -5.04717703e-15f },
+    { 0.464335549f, 1.06052605f, -2.00128688f, 0.464335549f, 0.0535664451f, 1.95485332f },
+    { 0.642617161f, 0.162818669f, -3.80328829f, 0.642617161f, 0.321644555f, 3.73902657f },
+    { 3.30538494e-17f, -2.12444611e-18f, 4.16333634e-17f, 1.11022302e-16f, 0.9f, -1.30492301e-16f },
+    { 1.0f, -1.63672313f, 3.54939903f, 1.0f, -1.61970257e-17f, -3.64939903f },
+    { -5.87004809e-16f, -1.08322118e-16f, 3.89965837e-15f, -6.66133815e-16f, 0.9f, -5.04717703e-15f },
+    { -5.59121638e-16f, -2.39195407e-16f, -8.32667268e-16f, -2.22044605e-16f, 0.9f, -1.77063719e-15f },
+    { -0.261825891f, 4.71699111f, 5.33847139f, -0.261825891f, 1.1356433f, -5.3122888f },
+    { 0.464335549f, 1.06052605f, -2.00128688f, 0.464335549f, 0.482098006f, 1.95485332f },
+    { 0.464335549f, 1.06052605f, -2.00128688f, 0.464335549f, 0.482098006f, 1.95485332f },
+};
+static const float MPC_G[MPC_NUM_REGIONS] = {
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+    0.0f,
+};
@@ -0,0 +1,112 @@
+/**
+ * @file change_detector.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Change point detector for the array conditions.
+ * @version 0.1
+ * @date 2023-09-04
+ * @copyright Copyright (c) 2023
+ */
+
+/** General imports. */
+#include <math.h>
+
+/** Device Specific imports. */
+#include "./change_detector.hpp"
+
+
+ChangeDetector_t ChangeDetectorInit(
+    float drift,
+    float threshold,
+    float settle,
+    uint16_t settleSteps,
+    float probe,
+    float rhoMin,
+    float rhoMax
+) {
+    ChangeDetector_t output = {
+        drift,
+        threshold,
+        settle,
+        settleSteps,
+        probe,
+        rhoMin,
+        rhoMax,
+        CHANGE_IDLE,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0,
+        0
+    };
+    return output;
+}
+
+/** @brief Change in the conditions between steps, see the header. */
+static float Change(ChangeDetector_t * cd, float current, float power) {
+    float r = 0.0f;
+    if (cd->current > 0.0f && cd->power > 0.0f && current > 0.0f && power > 0.0f) {
+        float rI = logf(current / cd->current);
+        float rP = logf(power / cd->power);
+        if (rI * rP > 0.0f) r = fabsf(rI) < fabsf(rP) ? rI : rP;
+    }
+    cd->current = current;
+    cd->power = power;
+    return r;
+}
+
+enum ChangeEvent ChangeDetectorStep(ChangeDetector_t * cd, float voltage, float current, float reference) {
+    float r = Change(cd, current, voltage * current);
+
+    switch (cd->state) {
+        case CHANGE_IDLE:
+            cd->sumUp += r - cd->drift;
+            if (cd->sumUp < 0.0f) cd->sumUp = 0.0f;
+            cd->sumDown += -r - cd->drift;
+            if (cd->sumDown < 0.0f) cd->sumDown = 0.0f;
+            if (cd->sumUp <= 0.0f && cd->sumDown <= 0.0f) cd->currentBefore = current;
+            if (cd->sumUp < cd->threshold && cd->sumDown < cd->threshold) return CHANGE_NONE;
+
+            ++cd->detections;
+            cd->state = CHANGE_SETTLING;
+            cd->reference = reference;
+            cd->steps = 0;
+            return CHANGE_HOLD;
+        case CHANGE_SETTLING: {
+            bool settled = fabsf(r) <= cd->settle && fabsf(voltage - cd->reference) <= 0.5f * cd->probe;
+            if (!settled && ++cd->steps < cd->settleSteps) return CHANGE_HOLD;
+
+            cd->state = CHANGE_PROBING;
+            cd->voltageProbe = voltage;
+            cd->currentProbe = current;
+            cd->reference -= cd->probe;
+            return CHANGE_HOLD;
+        }
+        case CHANGE_PROBING: {
+            float dV = voltage - cd->voltageProbe;
+            float dI = current - cd->currentProbe;
+            cd->rho = dV != 0.0f && cd->currentBefore > 0.0f
+                ? -(dI / dV) * (cd->voltageProbe / cd->currentBefore)
+                : 0.0f;
+            ChangeDetectorReset(cd);
+            Change(cd, current, voltage * current);
+            return cd->rho >= cd->rhoMin && cd->rho <= cd->rhoMax ? CHANGE_UNIFORM : CHANGE_SHADING;
+        }
+    }
+    return CHANGE_NONE;
+}
+
+void ChangeDetectorReset(ChangeDetector_t * cd) {
+    cd->state = CHANGE_IDLE;
+    cd->sumUp = 0.0f;
+    cd->sumDown = 0.0f;
+    cd->current = 0.0f;
+    cd->power = 0.0f;
+    cd->currentBefore = 0.0f;
+    cd->steps = 0;
+}
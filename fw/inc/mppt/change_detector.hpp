@@ -0,0 +1,175 @@
+/**
+ * @file change_detector.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Change point detector for the array conditions. Detects irradiance
+ *        changes from the array current and power with a CUSUM test, and
+ *        classifies them as uniform or partial shading, so that global scans
+ *        run on events rather than on a timer.
+ * @version 0.1
+ * @date 2023-09-04
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+The detector steps at the tracker rate on the averaged array voltage and
+current. A change in irradiance at the held voltage scales the array current
+and power alike. The tracker's own steps do not: around the MPP they hardly
+change the power, and on the flat part of the curve below it they hardly
+change the current. With the log ratios of both between steps,
+r_I = ln(I_k / I_k-1) and r_P = ln(P_k / P_k-1), the change statistic
+
+    r = sign(r_P) min(|r_I|, |r_P|)    if r_I and r_P agree in sign, else 0
+
+follows the conditions and mostly ignores the tracker. A step in irradiance
+moves it by tens of percent at once, and a cloud edge by a few percent per
+step. The two-sided CUSUM
+
+    S+ = max(0, S+ + r - drift),    S- = max(0, S- - r - drift)
+
+absorbs changes of up to `drift` per step, and fires when either sum exceeds
+`threshold`: at once on a step, after a few steps on a steep ramp, and never
+on the slow drift of the sun, which the tracker follows anyway. The current
+of the last step with both sums at zero is the current before the change.
+
+A single operating point cannot tell a uniform change from partial shading;
+both scale the current at the held voltage. The slope can. At a given voltage
+and cell temperature the diode current does not depend on the irradiance, so
+a uniform change shifts the I-V curve by the change in photo current and
+leaves dI/dV at the held voltage where it was. Before the change the tracker
+held the MPP, where dI/dV = -I/V, so the slope ratio
+
+    rho = -(dI / dV) (V / I_before)
+
+stays about 1. When substrings are shaded, the array current at the held
+voltage is pinned to their short circuit current, the unshaded substrings run
+up towards open circuit, and the current hardly changes with the voltage: rho
+drops to a few percent. Lifting a shadow off the global MPP of a shaded curve
+leaves the held voltage on the flat part of the uniform one, with the same
+signature. After a detection, the detector:
+
+1. CHANGE_HOLD: holds the reference it was detected at until r is below
+   `settle` and the array voltage is back within probe / 2 of the reference,
+   for at most `settleSteps` steps, so that neither the rest of a ramp nor
+   the sag of the voltage loop shows as slope.
+2. CHANGE_HOLD: steps the reference down by `probe`, and measures rho
+   between the two steps.
+3. Returns CHANGE_UNIFORM if rho is within [rhoMin, rhoMax], where the caller
+   can jump to the model MPP, or CHANGE_SHADING otherwise, where it starts a
+   global scan.
+
+The caller resets the detector whenever it moves the operating point itself,
+i.e. after a global scan.
+*/
+
+/** @brief Outcome of a detector step. */
+enum ChangeEvent {
+    CHANGE_NONE,    // Step the tracker.
+    CHANGE_HOLD,    // Hold the reference at cd->reference instead.
+    CHANGE_UNIFORM, // A uniform change; step the tracker, or jump to the model.
+    CHANGE_SHADING  // A change in shading; scan.
+};
+
+/** @brief State of the detector. */
+enum ChangeState { CHANGE_IDLE, CHANGE_SETTLING, CHANGE_PROBING };
+
+/** @brief Definition of a change point detector. */
+typedef struct ChangeDetector {
+    /** @brief Change per step absorbed by the CUSUM. */
+    float drift;
+
+    /** @brief CUSUM that counts as a change. */
+    float threshold;
+
+    /** @brief Change per step that counts as settled. */
+    float settle;
+
+    /** @brief Maximum steps to wait for the array to settle. */
+    uint16_t settleSteps;
+
+    /** @brief Probe step of the array voltage (V). */
+    float probe;
+
+    /** @brief Range of rho that counts as a uniform change. */
+    float rhoMin;
+    float rhoMax;
+
+    /** @brief State of the detector. */
+    enum ChangeState state;
+
+    /** @brief CUSUM of increases and decreases. */
+    float sumUp;
+    float sumDown;
+
+    /** @brief Array current and power of the last step, 0 for none. */
+    float current;
+    float power;
+
+    /** @brief Array current before the change (A). */
+    float currentBefore;
+
+    /** @brief Array voltage reference to hold (V). */
+    float reference;
+
+    /** @brief Operating point before the probe. */
+    float voltageProbe;
+    float currentProbe;
+
+    /** @brief Slope ratio of the last probe. */
+    float rho;
+
+    /** @brief Steps spent settling. */
+    uint16_t steps;
+
+    /** @brief Number of changes detected. */
+    uint32_t detections;
+} ChangeDetector_t;
+
+/**
+ * @brief ChangeDetectorInit initializes a ChangeDetector_t struct for later
+ *        use.
+ *
+ * @param drift       Change per step absorbed by the CUSUM.
+ * @param threshold   CUSUM that counts as a change.
+ * @param settle      Change per step that counts as settled.
+ * @param settleSteps Maximum steps to wait for the array to settle.
+ * @param probe       Probe step of the array voltage (V).
+ * @param rhoMin      Minimum slope ratio of a uniform change.
+ * @param rhoMax      Maximum slope ratio of a uniform change.
+ * @return Detector parameters and state.
+ */
+ChangeDetector_t ChangeDetectorInit(
+    float drift,
+    float threshold,
+    float settle,
+    uint16_t settleSteps,
+    float probe,
+    float rhoMin,
+    float rhoMax
+);
+
+/**
+ * @brief ChangeDetectorStep runs the CUSUM test, and the classification
+ *        after a detection.
+ *
+ * @param cd        Detector parameters and state.
+ * @param voltage   Averaged array voltage (V).
+ * @param current   Averaged array current (A).
+ * @param reference Array voltage reference the averages were taken at (V).
+ * @return What to do with the tracker this step.
+ * @note Call at the tracker rate, while the MPPT loop is in control.
+ */
+enum ChangeEvent ChangeDetectorStep(ChangeDetector_t * cd, float voltage, float current, float reference);
+
+/**
+ * @brief ChangeDetectorReset clears the CUSUM and any classification in
+ *        progress, and restarts from the next step.
+ *
+ * @param cd Detector parameters and state.
+ */
+void ChangeDetectorReset(ChangeDetector_t * cd);
@@ -0,0 +1,162 @@
+/**
+ * @file efficiency_meter.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief On-line tracking efficiency meter.
+ * @version 0.1
+ * @date 2023-09-05
+ * @copyright Copyright (c) 2023
+ */
+
+/** General imports. */
+#include <math.h>
+
+/** Device Specific imports. */
+#include "./efficiency_meter.hpp"
+
+
+EfficiencyMeter_t EfficiencyMeterInit(
+    float amplitude,
+    uint8_t points,
+    uint16_t settle,
+    uint16_t average,
+    uint32_t interval,
+    float tolerance,
+    float sampleRate
+) {
+    if (amplitude > EFFICIENCY_METER_AMPLITUDE_MAX) amplitude = EFFICIENCY_METER_AMPLITUDE_MAX;
+    if (points > EFFICIENCY_METER_POINTS_MAX) points = EFFICIENCY_METER_POINTS_MAX;
+    if (points < 3) points = 3;
+    if (points % 2 == 0) --points;
+    if (average < 1) average = 1;
+
+    uint32_t length = average + (uint32_t) points * (settle + average);
+    uint32_t spacing = (uint32_t) ceilf(length / EFFICIENCY_METER_DUTY_MAX);
+    if (interval < spacing) interval = spacing;
+
+    EfficiencyMeter_t output = {
+        amplitude,
+        points,
+        settle,
+        average,
+        interval,
+        tolerance,
+        1.0f / sampleRate,
+        METER_IDLE,
+        0,
+        0,
+        0.0f,
+        0.0f,
+        { 0.0f },
+        0.0f,
+        1.0f,
+        0.0f,
+        false,
+        0,
+        0,
+        0.0f
+    };
+    return output;
+}
+
+bool EfficiencyMeterDue(EfficiencyMeter_t * em) {
+    if (em->tick < em->interval) ++em->tick;
+    return em->tick >= em->interval;
+}
+
+void EfficiencyMeterStart(EfficiencyMeter_t * em, float reference) {
+    em->state = METER_CENTER;
+    em->center = reference;
+    em->point = 0;
+    em->tick = 0;
+    em->sum = 0.0f;
+}
+
+/** @brief Offset of point i from the center (V). */
+static float Offset(const EfficiencyMeter_t * em, uint8_t i) {
+    return em->amplitude * (2.0f * i / (em->points - 1) - 1.0f);
+}
+
+/** @brief Fits the parabola to the sweep and updates the estimates. */
+static void Fit(EfficiencyMeter_t * em) {
+    /* Offsets normalized to [-1, 1] keep the sums well conditioned. */
+    float n = em->points;
+    float s2 = 0.0f, s4 = 0.0f, sp = 0.0f, sxp = 0.0f, sx2p = 0.0f;
+    float best = 0.0f;
+    uint8_t iBest = 0;
+    for (uint8_t i = 0; i < em->points; ++i) {
+        float x = Offset(em, i) / em->amplitude;
+        float p = em->power[i];
+        s2 += x * x;
+        s4 += x * x * x * x;
+        sp += p;
+        sxp += x * p;
+        sx2p += x * x * p;
+        if (p > best) {
+            best = p;
+            iBest = i;
+        }
+    }
+    float b = sxp / s2;
+    float a = (n * sx2p - s2 * sp) / (n * s4 - s2 * s2);
+    float c = (sp - s2 * a) / n;
+
+    float peak = best;
+    float vertex = Offset(em, iBest) / em->amplitude;
+    em->bracketed = a < 0.0f && fabsf(b) <= -2.0f * a;
+    if (em->bracketed) {
+        vertex = -b / (2.0f * a);
+        peak = c - b * b / (4.0f * a);
+    }
+    em->offset = vertex * em->amplitude;
+    em->ratio = peak > 0.0f ? em->powerCenter / peak : 1.0f;
+    if (em->ratio > 1.0f) em->ratio = 1.0f;
+}
+
+float EfficiencyMeterStep(EfficiencyMeter_t * em, float voltage, float current) {
+    switch (em->state) {
+        case METER_IDLE:
+            return em->center;
+        case METER_CENTER:
+            em->sum += voltage * current;
+            if (++em->tick < em->average) return em->center;
+
+            em->powerCenter = em->sum / em->average;
+            em->state = METER_SWEEP;
+            em->tick = 0;
+            em->sum = 0.0f;
+            return em->center + Offset(em, 0);
+        case METER_SWEEP: {
+            if (em->tick >= em->settle) em->sum += voltage * current;
+            em->lost += (em->powerCenter - voltage * current) * em->period;
+            if (++em->tick < em->settle + em->average) return em->center + Offset(em, em->point);
+
+            em->power[em->point] = em->sum / em->average;
+            em->tick = 0;
+            em->sum = 0.0f;
+            if (++em->point < em->points) return em->center + Offset(em, em->point);
+
+            /* The middle point sits at the center again. */
+            em->state = METER_IDLE;
+            float drift = em->power[em->points / 2] - em->powerCenter;
+            if (em->powerCenter <= 0.0f || fabsf(drift) > em->tolerance * em->powerCenter) {
+                ++em->rejected;
+            } else {
+                Fit(em);
+                ++em->sweeps;
+            }
+            return em->center;
+        }
+    }
+    return em->center;
+}
+
+void EfficiencyMeterAbort(EfficiencyMeter_t * em) {
+    if (!EfficiencyMeterRunning(em)) return;
+    em->state = METER_IDLE;
+    em->tick = 0;
+    ++em->rejected;
+}
+
+bool EfficiencyMeterRunning(const EfficiencyMeter_t * em) {
+    return em->state != METER_IDLE;
+}
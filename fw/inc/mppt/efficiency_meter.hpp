@@ -0,0 +1,194 @@
+/**
+ * @file efficiency_meter.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief On-line tracking efficiency meter. Occasionally sweeps the array
+ *        voltage reference across a narrow window around the operating point,
+ *        fits a parabola to P(V), and reports the tracked power as a fraction
+ *        of the local maximum of the fit.
+ * @version 0.1
+ * @date 2023-09-05
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+Near a maximum the P-V curve is a parabola in the array voltage. Taking n
+points at the offsets
+
+    x_i = -amplitude + 2 amplitude i / (n - 1),    i = 0 .. n - 1
+
+around the reference v_0 the tracker holds, the least squares fit
+P(x) = a x^2 + b x + c has, for offsets symmetric about 0,
+
+    b = sum(x p) / S2
+    a = (n sum(x^2 p) - S2 sum(p)) / (n S4 - S2^2)
+    c = (sum(p) - S2 a) / n
+
+with S2 = sum(x^2) and S4 = sum(x^4). If a < 0 and the vertex -b / 2a lies
+within the window, the local maximum is P* = c - b^2 / 4a; otherwise the
+maximum lies outside the window, and P* is the best point measured. The
+efficiency is P(v_0) / P*, capped at 1, and the vertex offset tells on which
+side of the MPP the tracker sits.
+
+A sweep runs at the outer loop rate through the array voltage loop, and takes
+the place of the tracker steps:
+
+1. METER_CENTER: averages the power at v_0 over `average` ticks.
+2. METER_SWEEP:  for every offset, waits `settle` ticks for the voltage loop,
+                 then averages the power over `average` ticks.
+3. Returns to v_0. The sweep is rejected if the power at offset 0 differs from
+   the one at v_0 by more than `tolerance`, since the conditions changed during
+   the sweep, or if it is aborted, i.e. when a battery limit takes over.
+
+The harvest lost to a sweep is bounded by the amplitude: at
+EFFICIENCY_METER_AMPLITUDE_MAX, a crystalline array near 60 V loses under 1 %
+of its power at the ends of the window, and less in between. Sweeps are spaced
+so that they take at most EFFICIENCY_METER_DUTY_MAX of the time, which bounds
+the cost to a few hundredths of a percent of the harvest; fw/tests/host_sim
+measures under 0.01 %. The harvest actually lost against P(v_0) is accumulated
+for telemetry.
+*/
+
+/** @brief Caps on the sweep, to bound the harvest lost. */
+#define EFFICIENCY_METER_AMPLITUDE_MAX 2.0f // V
+#define EFFICIENCY_METER_POINTS_MAX 9
+#define EFFICIENCY_METER_DUTY_MAX 0.02f // Fraction of the time spent sweeping.
+
+/** @brief State of the meter. */
+enum EfficiencyMeterState { METER_IDLE, METER_CENTER, METER_SWEEP };
+
+/** @brief Definition of a tracking efficiency meter. */
+typedef struct EfficiencyMeter {
+    /** @brief Half width of the window around the operating point (V). */
+    float amplitude;
+
+    /** @brief Number of points across the window, odd. */
+    uint8_t points;
+
+    /** @brief Ticks to wait at every point before averaging. */
+    uint16_t settle;
+
+    /** @brief Ticks averaged at every point. */
+    uint16_t average;
+
+    /** @brief Ticks between the end of a sweep and the next one. */
+    uint32_t interval;
+
+    /** @brief Relative change of the power at v_0 that rejects a sweep. */
+    float tolerance;
+
+    /** @brief Tick period of the caller (s). */
+    float period;
+
+    /** @brief State of the meter. */
+    enum EfficiencyMeterState state;
+
+    /** @brief Ticks since the last sweep, or into the current point. */
+    uint32_t tick;
+
+    /** @brief Point of the sweep in progress. */
+    uint8_t point;
+
+    /** @brief Array voltage reference the tracker holds (V). */
+    float center;
+
+    /** @brief Power at the center, and at every point of the sweep (W). */
+    float powerCenter;
+    float power[EFFICIENCY_METER_POINTS_MAX];
+
+    /** @brief Power summed over the point in progress (W). */
+    float sum;
+
+    /** @brief Tracked power over the local maximum of the last sweep. */
+    float ratio;
+
+    /** @brief Offset of the local maximum of the last sweep from v_0 (V). */
+    float offset;
+
+    /** @brief Whether the local maximum of the last sweep lay in the window. */
+    bool bracketed;
+
+    /** @brief Accepted and rejected sweeps. */
+    uint32_t sweeps;
+    uint32_t rejected;
+
+    /** @brief Harvest lost to the sweeps against P(v_0) (J). */
+    float lost;
+} EfficiencyMeter_t;
+
+/**
+ * @brief EfficiencyMeterInit initializes an EfficiencyMeter_t struct for later
+ *        use. The amplitude and the number of points are capped, and the
+ *        interval raised to keep to EFFICIENCY_METER_DUTY_MAX.
+ *
+ * @param amplitude  Half width of the window around the operating point (V).
+ * @param points     Number of points across the window, odd.
+ * @param settle     Ticks to wait at every point before averaging.
+ * @param average    Ticks averaged at every point.
+ * @param interval   Ticks between sweeps.
+ * @param tolerance  Relative change of the power at the operating point that
+ *                   rejects a sweep.
+ * @param sampleRate Tick rate of the caller (Hz).
+ * @return Meter parameters, idle.
+ */
+EfficiencyMeter_t EfficiencyMeterInit(
+    float amplitude,
+    uint8_t points,
+    uint16_t settle,
+    uint16_t average,
+    uint32_t interval,
+    float tolerance,
+    float sampleRate
+);
+
+/**
+ * @brief EfficiencyMeterDue counts a tick and returns whether a sweep is due.
+ *
+ * @param em Meter parameters and state.
+ * @return True once interval ticks passed since the last sweep.
+ * @note Call every tick while no sweep is running.
+ */
+bool EfficiencyMeterDue(EfficiencyMeter_t * em);
+
+/**
+ * @brief EfficiencyMeterStart starts a sweep around the array voltage
+ *        reference the tracker holds.
+ *
+ * @param em        Meter parameters and state.
+ * @param reference Array voltage reference (V).
+ */
+void EfficiencyMeterStart(EfficiencyMeter_t * em, float reference);
+
+/**
+ * @brief EfficiencyMeterStep observes the array and returns the array voltage
+ *        reference for the next tick.
+ *
+ * @param em      Meter parameters and state.
+ * @param voltage Array voltage (V).
+ * @param current Array current (A).
+ * @return The array voltage reference (V). The center once the sweep is done,
+ *         with em->ratio and em->offset updated.
+ * @note Call every tick while EfficiencyMeterRunning().
+ */
+float EfficiencyMeterStep(EfficiencyMeter_t * em, float voltage, float current);
+
+/**
+ * @brief EfficiencyMeterAbort ends the sweep early and rejects it. The caller
+ *        returns to em->center.
+ *
+ * @param em Meter parameters and state.
+ */
+void EfficiencyMeterAbort(EfficiencyMeter_t * em);
+
+/**
+ * @brief EfficiencyMeterRunning returns whether a sweep is in progress.
+ *
+ * @param em Meter parameters and state.
+ * @return True if measuring the center or sweeping.
+ */
+bool EfficiencyMeterRunning(const EfficiencyMeter_t * em);
@@ -0,0 +1,135 @@
+/**
+ * @file extremum_seeking.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Extremum seeking maximum power point tracker with a sinusoidal
+ *        dither and lock-in demodulation.
+ * @version 0.1
+ * @date 2023-08-28
+ * @copyright Copyright (c) 2023
+ */
+
+/** Device Specific imports. */
+#include "./extremum_seeking.hpp"
+
+
+/** Compile time dither table. std::sin is not constexpr. */
+static constexpr double PI = 3.14159265358979323846;
+
+static constexpr double Sin(double x) {
+    /* Taylor series; |x| <= pi. */
+    double term = x;
+    double sum = x;
+    for (int k = 1; k < 16; ++k) {
+        term *= -x * x / ((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+typedef struct DitherTable {
+    float sin[EXTREMUM_SEEKING_PERIOD];
+} DitherTable_t;
+
+static constexpr DitherTable_t DitherTableBuild() {
+    DitherTable_t table = { { 0.0f } };
+    for (int n = 0; n < EXTREMUM_SEEKING_PERIOD; ++n) {
+        /* Fold into [-pi, pi] where the series converges. */
+        double x = 2.0 * PI * n / EXTREMUM_SEEKING_PERIOD;
+        if (x > PI) x -= 2.0 * PI;
+        table.sin[n] = (float) Sin(x);
+    }
+    return table;
+}
+
+static constexpr DitherTable_t DITHER = DitherTableBuild();
+
+/** Demodulated amplitude of the first differences per volt of dither. */
+static constexpr float DEMODULATED = (float) (EXTREMUM_SEEKING_PERIOD * Sin(PI / EXTREMUM_SEEKING_PERIOD));
+
+static_assert(EXTREMUM_SEEKING_PERIOD % 4 == 0, "The cosine is read a quarter period ahead.");
+
+ExtremumSeeking_t ExtremumSeekingInit(
+    float vMax,
+    float vMin,
+    float amplitude,
+    float stepMax,
+    float gain,
+    float reference
+) {
+    /* Valid while at least a quarter of the dither amplitude comes through. */
+    float floor = 0.25f * amplitude * DEMODULATED;
+    ExtremumSeeking_t output = {
+        vMax,
+        vMin,
+        amplitude,
+        stepMax,
+        gain,
+        floor * floor,
+        reference,
+        0.0f,
+        0,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        false
+    };
+    ExtremumSeekingReset(&output, reference);
+    return output;
+}
+
+float ExtremumSeekingStep(ExtremumSeeking_t * es, float voltage, float current) {
+    float power = voltage * current;
+    if (es->primed) {
+        float s = DITHER.sin[es->index];
+        float c = DITHER.sin[(es->index + EXTREMUM_SEEKING_PERIOD / 4) % EXTREMUM_SEEKING_PERIOD];
+        float dV = voltage - es->voltage;
+        float dP = power - es->power;
+        es->voltageI += dV * s;
+        es->voltageQ += dV * c;
+        es->powerI += dP * s;
+        es->powerQ += dP * c;
+    }
+    es->voltage = voltage;
+    es->power = power;
+    es->primed = true;
+
+    if (++es->index >= EXTREMUM_SEEKING_PERIOD) {
+        es->index = 0;
+        float magnitude = es->voltageI * es->voltageI + es->voltageQ * es->voltageQ;
+        if (magnitude >= es->floor) {
+            float slope = (es->powerI * es->voltageI + es->powerQ * es->voltageQ) / magnitude;
+            float step = es->gain * slope;
+            if (step > es->stepMax) step = es->stepMax;
+            else if (step < -es->stepMax) step = -es->stepMax;
+            es->rate = step / EXTREMUM_SEEKING_PERIOD;
+        } else {
+            es->rate = 0.0f;
+        }
+        es->voltageI = 0.0f;
+        es->voltageQ = 0.0f;
+        es->powerI = 0.0f;
+        es->powerQ = 0.0f;
+    }
+
+    /* Spread the step over the next period; the demodulation rejects a ramp. */
+    es->center += es->rate;
+    if (es->center > es->vMax - es->amplitude) es->center = es->vMax - es->amplitude;
+    else if (es->center < es->vMin + es->amplitude) es->center = es->vMin + es->amplitude;
+    return es->center + es->amplitude * DITHER.sin[es->index];
+}
+
+void ExtremumSeekingReset(ExtremumSeeking_t * es, float reference) {
+    if (reference > es->vMax - es->amplitude) reference = es->vMax - es->amplitude;
+    else if (reference < es->vMin + es->amplitude) reference = es->vMin + es->amplitude;
+    es->center = reference;
+    es->rate = 0.0f;
+    es->index = 0;
+    es->voltageI = 0.0f;
+    es->voltageQ = 0.0f;
+    es->powerI = 0.0f;
+    es->powerQ = 0.0f;
+    es->primed = false;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file extremum_seeking.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Extremum seeking maximum power point tracker. Dithers the array
+ *        voltage reference with a sinusoid and demodulates the power ripple
+ *        to estimate and climb dP/dV continuously.
+ * @version 0.1
+ * @date 2023-08-28
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+The tracker adds a dither a sin(w n) to the array voltage reference. Near a
+smooth point of the P-V curve the power follows as
+
+    p[n] ~ P(v) + dP/dV * a' sin(w n + phi)
+
+where a' and phi are the amplitude and phase the voltage loop actually
+delivers at the dither frequency. Instead of assuming them, the tracker
+demodulates both the sensed voltage and the sensed power with the same sine
+and cosine (a lock-in with I and Q channels), and takes the gradient as the
+projection of the power phasor on the voltage phasor:
+
+    dP/dV = (P_I V_I + P_Q V_Q) / (V_I^2 + V_Q^2)
+
+The sums run over exactly one dither period, which rejects the mean and every
+harmonic of the dither (i.e. the power ripple at 2w from the curvature). The
+first differences of v and p are demodulated instead of v and p themselves;
+this scales both phasors alike, leaving the ratio unchanged, and turns a
+linear drift in irradiance into a constant, which the full period also
+rejects.
+
+At the end of every period the tracker takes a step of gain * dP/dV, clamped
+to stepMax, and spreads it evenly over the next period. The center of the
+dither then ramps instead of stepping, which the first differences reject, so
+the tracker climbs continuously without waiting for the loop to settle. If the
+voltage dither did not come through (i.e. another loop holds the converter),
+the estimate is discarded and the center holds.
+
+The dither table is built at compile time with EXTREMUM_SEEKING_PERIOD samples
+per period; the dither frequency is the step rate over that, and must sit well
+within the bandwidth of the array voltage loop.
+*/
+
+/** @brief Samples per dither period. A multiple of 4, for the cosine. */
+#define EXTREMUM_SEEKING_PERIOD 32
+
+/** @brief Definition of an extremum seeking tracker. */
+typedef struct ExtremumSeeking {
+    /** @brief Maximum array voltage reference, dither included (V). */
+    float vMax;
+
+    /** @brief Minimum array voltage reference, dither included (V). */
+    float vMin;
+
+    /** @brief Dither amplitude (V). */
+    float amplitude;
+
+    /** @brief Maximum step of the center per period (V). */
+    float stepMax;
+
+    /** @brief Step per unit slope (V per W/V). */
+    float gain;
+
+    /** @brief Minimum squared voltage phasor for a valid estimate (V^2). */
+    float floor;
+
+    /** @brief Center of the dither (V). */
+    float center;
+
+    /** @brief Change of the center per sample (V). */
+    float rate;
+
+    /** @brief Position in the dither period. */
+    uint8_t index;
+
+    /** @brief Sensed voltage and power of the last sample (V, W). */
+    float voltage;
+    float power;
+
+    /** @brief Demodulated first differences of voltage and power. */
+    float voltageI;
+    float voltageQ;
+    float powerI;
+    float powerQ;
+
+    /** @brief Whether voltage and power hold a valid previous sample. */
+    bool primed;
+} ExtremumSeeking_t;
+
+/**
+ * @brief ExtremumSeekingInit initializes an ExtremumSeeking_t struct for later
+ *        use.
+ *
+ * @param vMax      Maximum array voltage reference (V).
+ * @param vMin      Minimum array voltage reference (V).
+ * @param amplitude Dither amplitude (V).
+ * @param stepMax   Maximum step of the center per period (V).
+ * @param gain      Step per unit slope (V per W/V).
+ * @param reference Initial array voltage reference (V). Clamped.
+ * @return Tracker parameters and state.
+ */
+ExtremumSeeking_t ExtremumSeekingInit(
+    float vMax,
+    float vMin,
+    float amplitude,
+    float stepMax,
+    float gain,
+    float reference
+);
+
+/**
+ * @brief ExtremumSeekingStep observes the array operating point and returns
+ *        the next array voltage reference, dither included.
+ *
+ * @param es      Tracker parameters and state.
+ * @param voltage Sensed array voltage (V).
+ * @param current Sensed array current (A).
+ * @return The next array voltage reference (V).
+ * @note Call at the rate the array voltage reference is applied, i.e. every
+ *       outer loop tick, on the sensor filters rather than long averages.
+ */
+float ExtremumSeekingStep(ExtremumSeeking_t * es, float voltage, float current);
+
+/**
+ * @brief ExtremumSeekingReset restarts tracking from `reference` at the start
+ *        of a dither period, discarding the partial demodulation.
+ *
+ * @param es        Tracker parameters and state.
+ * @param reference Array voltage reference to restart from (V). Clamped.
+ */
+void ExtremumSeekingReset(ExtremumSeeking_t * es, float reference);
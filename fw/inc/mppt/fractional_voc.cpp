@@ -0,0 +1,100 @@
+/**
+ * @file fractional_voc.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Fractional open circuit voltage tracker.
+ * @version 0.1
+ * @date 2023-09-03
+ * @copyright Copyright (c) 2023
+ */
+
+/** General imports. */
+#include <math.h>
+
+/** Device Specific imports. */
+#include "./fractional_voc.hpp"
+
+
+FractionalVoc_t FractionalVocInit(
+    float vMax,
+    float vMin,
+    float k,
+    float alpha,
+    float tolerance,
+    uint16_t window,
+    uint16_t interval,
+    float reference
+) {
+    FractionalVoc_t output = {
+        vMax,
+        vMin,
+        alpha,
+        tolerance,
+        window,
+        interval,
+        k,
+        0.0f,
+        reference,
+        0.0f,
+        0.0f,
+        false,
+        0.0f,
+        0,
+        0,
+        false,
+        false
+    };
+    return output;
+}
+
+float FractionalVocStep(FractionalVoc_t * fv) {
+    if (++fv->tick >= fv->interval || fv->voc <= 0.0f) fv->request = true;
+    return fv->reference;
+}
+
+void FractionalVocStart(FractionalVoc_t * fv) {
+    fv->measuring = true;
+    fv->request = false;
+    fv->samples = 0;
+    fv->tick = 0;
+}
+
+bool FractionalVocSample(FractionalVoc_t * fv, float voltage) {
+    if (!fv->measuring) return false;
+
+    /* The first sample may still catch the inductor current decaying. */
+    bool settled = fv->samples > 0 && fabsf(voltage - fv->previous) <= fv->tolerance;
+    fv->previous = voltage;
+    if (!settled && ++fv->samples < fv->window) return false;
+
+    fv->measuring = false;
+    if (voltage <= 0.0f) return true;
+    fv->voc = voltage;
+    if (fv->learn > 0.0f) {
+        if (fv->shaded) {
+            /* Not a uniform curve; hold the global MPP, not k V_oc. */
+            fv->shade = fv->learn / voltage;
+        } else {
+            fv->k += fv->alpha * (fv->learn / voltage - fv->k);
+            if (fv->k > FRACTIONAL_VOC_K_MAX) fv->k = FRACTIONAL_VOC_K_MAX;
+            else if (fv->k < FRACTIONAL_VOC_K_MIN) fv->k = FRACTIONAL_VOC_K_MIN;
+            fv->shade = 0.0f;
+        }
+        fv->learn = 0.0f;
+    }
+
+    float reference = (fv->shade > 0.0f ? fv->shade : fv->k) * voltage;
+    if (reference > fv->vMax) reference = fv->vMax;
+    else if (reference < fv->vMin) reference = fv->vMin;
+    fv->reference = reference;
+    return true;
+}
+
+void FractionalVocLearn(FractionalVoc_t * fv, float voltage, uint8_t peaks) {
+    fv->learn = voltage;
+    fv->shaded = peaks > 1;
+    fv->request = true;
+}
+
+void FractionalVocReset(FractionalVoc_t * fv, float reference) {
+    fv->reference = reference;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file fractional_voc.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Fractional open circuit voltage tracker. Briefly disables the gate
+ *        driver to measure the array open circuit voltage, and sets the array
+ *        voltage reference to a fraction of it.
+ * @version 0.1
+ * @date 2023-09-03
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+The MPP voltage of a crystalline array stays close to a fixed fraction k of its
+open circuit voltage over irradiance and temperature:
+
+    V_ref = k V_oc
+
+With the gate driver disabled (pwm_enable low), both switches are off. The
+inductor current freewheels into the battery through the high side body diode
+and decays to zero in tens of microseconds, after which the array only charges
+the input capacitor. Near V_oc its dynamic resistance is a fraction of an Ohm,
+so the array voltage settles to V_oc within a few hundred microseconds.
+
+A measurement is a blanking window of the inner loop:
+
+1. FractionalVocStart: the caller disables the gates and stops the control
+   loops.
+2. FractionalVocSample, every inner loop tick: the array voltage is sampled,
+   and the window ends once two consecutive samples are within `tolerance`,
+   or after `window` samples, taking the last one as V_oc. The caller then
+   re-enables the gates, and the control loops continue from their state
+   before the window.
+
+At 10.4 kHz and a window of 10 samples the gates are off for under a
+millisecond. Measuring once a second costs about 0.1 % of the harvest,
+including the recovery.
+
+k is learned from the global scans. FractionalVocLearn takes the MPP voltage a
+scan found and asks for a measurement right after; when it completes, k moves
+towards V_mpp / V_oc by `alpha`. As a tracker, FractionalVocStep asks for a
+measurement every `interval` steps and holds k V_oc in between. It is cheap and
+never dithers, but only as good as k and blind to changes between measurements,
+so it serves as a fallback. The same measurement gives the model based
+predictor its V_oc, see ModelPredictorSetVoc.
+
+k only holds for a uniform curve. If the scan saw more than one maximum, the
+global MPP sits where bypass diodes conduct, and V_mpp / V_oc says nothing
+about k; learning from it would drag k off, and k V_oc off the global MPP.
+The measurement after such a scan leaves k alone instead, and the tracker
+holds the fraction of V_oc of the global MPP until the next scan.
+*/
+
+/** @brief Range of the learned fraction k. */
+#define FRACTIONAL_VOC_K_MIN 0.60f
+#define FRACTIONAL_VOC_K_MAX 0.95f
+
+/** @brief Definition of a fractional open circuit voltage tracker. */
+typedef struct FractionalVoc {
+    /** @brief Maximum array voltage reference (V). */
+    float vMax;
+
+    /** @brief Minimum array voltage reference (V). */
+    float vMin;
+
+    /** @brief Learning rate of k from the global scans. */
+    float alpha;
+
+    /** @brief Change between consecutive samples that counts as settled (V). */
+    float tolerance;
+
+    /** @brief Maximum samples per blanking window. */
+    uint16_t window;
+
+    /** @brief Tracker steps between measurements. */
+    uint16_t interval;
+
+    /** @brief Fraction of V_oc at the MPP. */
+    float k;
+
+    /** @brief Last measured open circuit voltage, 0 for none (V). */
+    float voc;
+
+    /** @brief Array voltage reference (V). */
+    float reference;
+
+    /** @brief Fraction of V_oc at the global MPP of the last scan if it saw
+     *         more than one maximum, 0 to follow k. */
+    float shade;
+
+    /** @brief MPP voltage of a scan to learn k from, 0 for none (V). */
+    float learn;
+
+    /** @brief Whether the scan to learn from saw more than one maximum. */
+    bool shaded;
+
+    /** @brief Last sample of the current window (V). */
+    float previous;
+
+    /** @brief Samples taken in the current window. */
+    uint16_t samples;
+
+    /** @brief Tracker steps since the last measurement. */
+    uint16_t tick;
+
+    /** @brief Whether a measurement is due. */
+    bool request;
+
+    /** @brief Whether a blanking window is open. */
+    bool measuring;
+} FractionalVoc_t;
+
+/**
+ * @brief FractionalVocInit initializes a FractionalVoc_t struct for later use.
+ *
+ * @param vMax      Maximum array voltage reference (V).
+ * @param vMin      Minimum array voltage reference (V).
+ * @param k         Initial fraction of V_oc at the MPP.
+ * @param alpha     Learning rate of k from the global scans.
+ * @param tolerance Change between consecutive samples that counts as settled
+ *                  (V).
+ * @param window    Maximum samples per blanking window.
+ * @param interval  Tracker steps between measurements.
+ * @param reference Initial array voltage reference (V).
+ * @return Tracker parameters and state.
+ */
+FractionalVoc_t FractionalVocInit(
+    float vMax,
+    float vMin,
+    float k,
+    float alpha,
+    float tolerance,
+    uint16_t window,
+    uint16_t interval,
+    float reference
+);
+
+/**
+ * @brief FractionalVocStep counts a tracker step, asks for a measurement every
+ *        interval steps and on the first, and returns k times the last V_oc.
+ *
+ * @param fv Tracker parameters and state.
+ * @return Array voltage reference (V).
+ */
+float FractionalVocStep(FractionalVoc_t * fv);
+
+/**
+ * @brief FractionalVocStart opens a blanking window. The caller disables the
+ *        gate driver.
+ *
+ * @param fv Tracker parameters and state.
+ */
+void FractionalVocStart(FractionalVoc_t * fv);
+
+/**
+ * @brief FractionalVocSample takes an array voltage sample during a blanking
+ *        window.
+ *
+ * @param fv      Tracker parameters and state.
+ * @param voltage Raw array voltage sample (V).
+ * @return Whether the window closed; fv->voc and fv->reference are then
+ *         updated and the caller re-enables the gate driver.
+ * @note Call every inner loop tick while fv->measuring.
+ */
+bool FractionalVocSample(FractionalVoc_t * fv, float voltage);
+
+/**
+ * @brief FractionalVocLearn asks for a measurement to learn k from, against
+ *        the MPP voltage a global scan found.
+ *
+ * @param fv      Tracker parameters and state.
+ * @param voltage Array voltage of the global MPP (V).
+ * @param peaks   Local maxima the scan saw. With more than one, k is kept and
+ *                the tracker holds the fraction of V_oc at `voltage` instead.
+ * @note Call when the scan hands the best point back, so the measurement
+ *       follows before the conditions change.
+ */
+void FractionalVocLearn(FractionalVoc_t * fv, float voltage, uint8_t peaks);
+
+/**
+ * @brief FractionalVocReset holds an array voltage reference until the next
+ *        measurement.
+ *
+ * @param fv        Tracker parameters and state.
+ * @param reference Array voltage reference (V).
+ */
+void FractionalVocReset(FractionalVoc_t * fv, float reference);
@@ -0,0 +1,154 @@
+/**
+ * @file global_scan.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Global maximum power point scan for partially shaded arrays with
+ *        bypass diodes.
+ * @version 0.1
+ * @date 2023-08-27
+ * @copyright Copyright (c) 2023
+ */
+
+/** Device Specific imports. */
+#include "./global_scan.hpp"
+
+
+GlobalScan_t GlobalScanInit(
+    float vMin,
+    float vMax,
+    float voc,
+    uint8_t substrings,
+    float iMax,
+    float rateSlow,
+    float rateFast,
+    float energyCap,
+    float capacitance,
+    float sampleRate
+) {
+    GlobalScan_t output = {
+        vMin,
+        vMax,
+        voc / substrings,
+        substrings,
+        iMax,
+        rateSlow / sampleRate,
+        rateFast / sampleRate,
+        energyCap,
+        1.0f / sampleRate,
+        capacitance * sampleRate,
+        SCAN_IDLE,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        false,
+        1
+    };
+    return output;
+}
+
+void GlobalScanStart(GlobalScan_t * scan, float voltage, float current) {
+    scan->state = SCAN_RISE;
+    scan->reference = current;
+    scan->currentStart = current;
+    scan->powerStart = voltage * current;
+    scan->voltagePrev = voltage;
+    scan->lost = 0.0f;
+    scan->samples = 0;
+
+    /* Only move if the scan finds something better than where it started. */
+    if (voltage > scan->vMax) voltage = scan->vMax;
+    else if (voltage < scan->vMin) voltage = scan->vMin;
+    scan->voltageBest = voltage;
+    scan->currentBest = current;
+    scan->powerBest = scan->powerStart;
+    scan->powerHigh = scan->powerStart;
+    scan->powerLow = scan->powerStart;
+    scan->falling = false;
+    scan->peaks = 1;
+}
+
+/** Counts a maximum whenever the power dips and recovers. */
+static void GlobalScanCountPeaks(GlobalScan_t * scan, float power) {
+    float dip = GLOBAL_SCAN_PEAK_DIP * scan->powerBest;
+    if (!scan->falling) {
+        if (power > scan->powerHigh) scan->powerHigh = power;
+        if (power < scan->powerHigh - dip) {
+            scan->falling = true;
+            scan->powerLow = power;
+        }
+    } else {
+        if (power < scan->powerLow) scan->powerLow = power;
+        if (power > scan->powerLow + dip) {
+            scan->falling = false;
+            scan->powerHigh = power;
+            if (scan->peaks < UINT8_MAX) ++scan->peaks;
+        }
+    }
+}
+
+float GlobalScanStep(GlobalScan_t * scan, float voltage, float current) {
+    if (!GlobalScanRunning(scan)) return scan->reference;
+
+    ++scan->samples;
+    float arrCurrent = current + scan->capacitance * (voltage - scan->voltagePrev);
+    scan->voltagePrev = voltage;
+    float power = voltage * arrCurrent;
+    if (power < scan->powerStart) scan->lost += (scan->powerStart - power) * scan->period;
+    if (voltage >= scan->vMin && voltage <= scan->vMax && power > scan->powerBest) {
+        scan->voltageBest = voltage;
+        scan->currentBest = arrCurrent;
+        scan->powerBest = power;
+    }
+    /* The sweep only counts once back past the start point. */
+    bool own = scan->state == SCAN_RISE || current >= scan->currentStart;
+    if (voltage >= scan->vMin && voltage <= scan->vMax && own) GlobalScanCountPeaks(scan, power);
+
+    /* Highest window whose low edge is at or below the operating point. */
+    float x = voltage / scan->vocSubstring;
+    int k = (int) (x / GLOBAL_SCAN_WINDOW_LOW);
+    if (k > scan->substrings) k = scan->substrings;
+    float top = k * GLOBAL_SCAN_WINDOW_HIGH * scan->vocSubstring;
+    bool inside = k > 0 && voltage <= top;
+
+    bool done = scan->lost > scan->energyCap;
+    if (scan->state == SCAN_RISE) {
+        scan->reference -= inside ? scan->stepSlow : scan->stepFast;
+        if (scan->reference <= 0.0f) scan->reference = 0.0f;
+        if (voltage >= scan->vMax || scan->reference == 0.0f) {
+            /* The rise covered the curve above the start point; resume there. */
+            scan->state = SCAN_SWEEP;
+            scan->reference = scan->currentStart;
+            scan->powerHigh = scan->powerStart;
+            scan->falling = false;
+        }
+    } else {
+        /* No window below can beat the best point; prune the rest. */
+        float bound = (inside ? voltage : top) * scan->iMax;
+        if (bound <= scan->powerBest) done = true;
+
+        /* Keep the ramp within reach of the inner loop. */
+        scan->reference += inside ? scan->stepSlow : scan->stepFast;
+        if (scan->reference > current + GLOBAL_SCAN_LEAD) scan->reference = current + GLOBAL_SCAN_LEAD;
+        if (scan->reference >= scan->iMax || voltage < scan->vMin) done = true;
+    }
+
+    if (done) GlobalScanAbort(scan);
+    return scan->reference;
+}
+
+void GlobalScanAbort(GlobalScan_t * scan) {
+    if (!GlobalScanRunning(scan)) return;
+    scan->state = SCAN_DONE;
+    scan->reference = scan->currentBest;
+}
+
+bool GlobalScanRunning(const GlobalScan_t * scan) {
+    return scan->state == SCAN_RISE || scan->state == SCAN_SWEEP;
+}
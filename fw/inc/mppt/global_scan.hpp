@@ -0,0 +1,217 @@
+/**
+ * @file global_scan.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Global maximum power point scan for partially shaded arrays with
+ *        bypass diodes. Sweeps the array across its voltage range through the
+ *        inductor current, and hands the best point found to the local
+ *        tracker.
+ * @version 0.1
+ * @date 2023-08-27
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+With bypass diodes across each of the n substrings, partial shading splits the
+P-V curve into up to n local maxima, one for every number of substrings k that
+are conducting (the rest are bypassed). A local tracker stays on whichever one
+it started next to.
+
+The k-th maximum sits at roughly k times the MPP voltage of a substring, so it
+falls within the window
+
+    [k * GLOBAL_SCAN_WINDOW_LOW, k * GLOBAL_SCAN_WINDOW_HIGH] * voc / n
+
+where voc is the array open circuit voltage at the coldest cell temperature.
+No maximum lies outside the windows, and since the array current never
+exceeds iMax, no maximum in window k can exceed k * GLOBAL_SCAN_WINDOW_HIGH *
+voc / n * iMax.
+
+The scan drives the inductor current reference directly, bypassing the
+ControlArbiter_t and its array voltage loop, which is too slow to sweep in
+tens of milliseconds. The caller aborts the scan if a battery limit is
+reached, and resets the arbiter to the best point when it is done:
+
+1. SCAN_RISE:  ramp the current down until the array reaches vMax (or the
+               current reaches 0), covering the curve above the start point.
+2. SCAN_SWEEP: step the current back to where it started, then ramp it up.
+               The array voltage falls along the I-V curve, jumping across
+               the current plateaus of the shaded substrings and resolving the
+               knees, where the maxima are.
+
+In both phases the ramp is rateSlow inside a window and rateFast outside. The
+sweep keeps the reference within GLOBAL_SCAN_LEAD of the measured current, so
+that the sensed voltage, which lags, stays in step with the reference.
+
+The measured current is the inductor current. When the array runs past the
+end of a current plateau, the input capacitor supplies the difference and the
+voltage collapses, so the array current is estimated as i_L + C dv/dt.
+
+Every sample in [vMin, vMax] updates the best point, and counts the local
+maxima the scan passes: a dip of the power by GLOBAL_SCAN_PEAK_DIP of the
+highest power so far, followed by a rise by as much, separates two maxima.
+Each phase counts the dips on its own side of the start point. A uniform curve
+shows a single maximum; the count tells the callers whether the best point is
+that of a shaded curve, i.e. whether V_mpp / V_oc means anything. The sweep
+ends when the bound of every window below the operating point is under the
+best power (the rest of the curve is pruned), when the array falls below vMin
+or the current reaches iMax, or when the harvest lost against the power at the
+start of the scan exceeds energyCap. On exit the reference is set to the
+current of the best point, which brings the array back to it; the caller then
+hands the best voltage to the local tracker.
+*/
+
+/** @brief Window of the k-th maximum, in multiples of k * voc / n. */
+#define GLOBAL_SCAN_WINDOW_LOW 0.60f
+#define GLOBAL_SCAN_WINDOW_HIGH 1.00f
+
+/** @brief Dip of the power between two maxima, in fractions of the highest. */
+#define GLOBAL_SCAN_PEAK_DIP 0.10f
+
+/** @brief Maximum lead of the current reference over the measurement (A). */
+#define GLOBAL_SCAN_LEAD 2.0f
+
+/** @brief State of the scan. */
+enum GlobalScanState { SCAN_IDLE, SCAN_RISE, SCAN_SWEEP, SCAN_DONE };
+
+/** @brief Definition of a global scan. */
+typedef struct GlobalScan {
+    /** @brief Lowest array voltage of the sweep (V). */
+    float vMin;
+
+    /** @brief Highest array voltage of the sweep (V). */
+    float vMax;
+
+    /** @brief Open circuit voltage of one substring at the coldest (V). */
+    float vocSubstring;
+
+    /** @brief Number of bypass diode protected substrings. */
+    uint8_t substrings;
+
+    /** @brief Inductor current ceiling of the sweep (A). */
+    float iMax;
+
+    /** @brief Current ramp per sample inside a window (A). */
+    float stepSlow;
+
+    /** @brief Current ramp per sample outside a window (A). */
+    float stepFast;
+
+    /** @brief Maximum harvest lost during a scan (J). */
+    float energyCap;
+
+    /** @brief Sample period of the ISR calling the scan (s). */
+    float period;
+
+    /** @brief Input capacitance over the sample period (F/s). */
+    float capacitance;
+
+    /** @brief State of the scan. */
+    enum GlobalScanState state;
+
+    /** @brief Inductor current reference (A). */
+    float reference;
+
+    /** @brief Inductor current when the scan started (A). */
+    float currentStart;
+
+    /** @brief Array power when the scan started (W). */
+    float powerStart;
+
+    /** @brief Array voltage of the last sample (V). */
+    float voltagePrev;
+
+    /** @brief Harvest lost against powerStart so far (J). */
+    float lost;
+
+    /** @brief Samples since the scan started. */
+    uint32_t samples;
+
+    /** @brief Array voltage, current and power of the best point. */
+    float voltageBest;
+    float currentBest;
+    float powerBest;
+
+    /** @brief Highest power since the last dip, and lowest since the last maximum (W). */
+    float powerHigh;
+    float powerLow;
+
+    /** @brief Whether the power fell from powerHigh by a dip. */
+    bool falling;
+
+    /** @brief Local maxima seen so far, at least 1. */
+    uint8_t peaks;
+} GlobalScan_t;
+
+/**
+ * @brief GlobalScanInit initializes a GlobalScan_t struct for later use.
+ *
+ * @param vMin        Lowest array voltage of the sweep (V).
+ * @param vMax        Highest array voltage of the sweep (V). Below the input
+ *                    overvoltage redline.
+ * @param voc         Array open circuit voltage at the coldest cell
+ *                    temperature (V).
+ * @param substrings  Number of bypass diode protected substrings.
+ * @param iMax        Inductor current ceiling of the sweep (A).
+ * @param rateSlow    Current ramp inside a window (A/s).
+ * @param rateFast    Current ramp outside a window (A/s).
+ * @param energyCap   Maximum harvest lost during a scan (J).
+ * @param capacitance Input capacitance (F).
+ * @param sampleRate  Sample rate of the ISR calling the scan (Hz).
+ * @return Scan parameters, idle.
+ */
+GlobalScan_t GlobalScanInit(
+    float vMin,
+    float vMax,
+    float voc,
+    uint8_t substrings,
+    float iMax,
+    float rateSlow,
+    float rateFast,
+    float energyCap,
+    float capacitance,
+    float sampleRate
+);
+
+/**
+ * @brief GlobalScanStart starts a scan from the current operating point.
+ *
+ * @param scan    Scan parameters and state.
+ * @param voltage Array voltage (V).
+ * @param current Array current, i.e. the inductor current (A).
+ */
+void GlobalScanStart(GlobalScan_t * scan, float voltage, float current);
+
+/**
+ * @brief GlobalScanStep observes the array and returns the inductor current
+ *        reference for this sample.
+ *
+ * @param scan    Scan parameters and state.
+ * @param voltage Array voltage (V).
+ * @param current Inductor current (A).
+ * @return The inductor current reference (A). The current of the best point
+ *         once the scan is done.
+ * @note Call once per ISR tick while GlobalScanRunning().
+ */
+float GlobalScanStep(GlobalScan_t * scan, float voltage, float current);
+
+/**
+ * @brief GlobalScanAbort ends the scan early, i.e. when a battery limit is
+ *        reached, and returns to the best point found so far.
+ *
+ * @param scan Scan parameters and state.
+ */
+void GlobalScanAbort(GlobalScan_t * scan);
+
+/**
+ * @brief GlobalScanRunning returns whether the scan is in progress.
+ *
+ * @param scan Scan parameters and state.
+ * @return True if rising or sweeping.
+ */
+bool GlobalScanRunning(const GlobalScan_t * scan);
@@ -0,0 +1,134 @@
+/**
+ * @file incremental_conductance.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Incremental conductance maximum power point tracker with decision
+ *        thresholds derived from the measured sensor noise.
+ * @version 0.1
+ * @date 2023-08-26
+ * @copyright Copyright (c) 2023
+ */
+
+/** General imports. */
+#include <math.h>
+
+/** Device Specific imports. */
+#include "./incremental_conductance.hpp"
+
+
+/** Smoothing factor of the noise variance estimates. */
+#define IC_VARIANCE_ALPHA 0.1f
+
+IncrementalConductance_t IncrementalConductanceInit(
+    float vMax,
+    float vMin,
+    float stepMax,
+    float stepMin,
+    float gain,
+    float k,
+    uint16_t window,
+    float reference
+) {
+    IncrementalConductance_t output = {
+        vMax,
+        vMin,
+        stepMax,
+        stepMin,
+        gain,
+        k,
+        (float) window,
+        -1.0f,
+        -1.0f,
+        reference,
+        0.0f,
+        0.0f,
+        0,
+        0,
+        false,
+        false
+    };
+    IncrementalConductanceReset(&output, reference);
+    return output;
+}
+
+float IncrementalConductanceStep(
+    IncrementalConductance_t * ic,
+    float voltage,
+    float current,
+    float varianceVoltage,
+    float varianceCurrent
+) {
+    /* Smooth the noise estimates; the filter window is short. */
+    if (ic->varianceVoltage < 0.0f) {
+        ic->varianceVoltage = varianceVoltage;
+        ic->varianceCurrent = varianceCurrent;
+    } else {
+        ic->varianceVoltage += IC_VARIANCE_ALPHA * (varianceVoltage - ic->varianceVoltage);
+        ic->varianceCurrent += IC_VARIANCE_ALPHA * (varianceCurrent - ic->varianceCurrent);
+    }
+
+    float dV = voltage - ic->voltage;
+    float dI = current - ic->current;
+    float varDV = 2.0f * ic->varianceVoltage / ic->window;
+    float varDI = 2.0f * ic->varianceCurrent / ic->window;
+    float step = 0.0f;
+    bool rebase = true;
+
+    if (!ic->primed) {
+        /* No baseline yet; perturb once so there is a slope to measure. */
+        step = ic->reference + ic->stepMin > ic->vMax ? -ic->stepMin : ic->stepMin;
+        ic->primed = true;
+    } else if (dV * dV <= ic->k * ic->k * varDV) {
+        if (dI * dI > ic->k * ic->k * varDI) {
+            /* The operating point did not move; a current change is irradiance. */
+            step = dI > 0.0f ? ic->stepMin : -ic->stepMin;
+            ic->side = 0;
+        } else if (ic->direction != 0) {
+            /* The last step is lost in noise; keep the baseline and go on. */
+            step = ic->direction * ic->stepMin;
+            rebase = false;
+        }
+    } else {
+        float g = voltage * dI + current * dV;
+        float varG = voltage * voltage * varDI + current * current * varDV;
+        if (g * g > ic->k * ic->k * varG) {
+            float slope = g / dV;
+            step = ic->gain * fabsf(slope);
+            if (step > ic->stepMax) step = ic->stepMax;
+            else if (step < ic->stepMin) step = ic->stepMin;
+            if (slope < 0.0f) step = -step;
+
+            /* A flip of the slope means the last step crossed the MPP. */
+            int8_t side = slope > 0.0f ? 1 : -1;
+            ic->crossed = ic->side != 0 && side != ic->side;
+            ic->side = side;
+        } else if (ic->direction != 0 && !ic->crossed) {
+            /* At low current a step moves the power less than the noise;
+               keep the baseline and step on until the slope resolves. */
+            step = ic->direction * ic->stepMin;
+            rebase = false;
+        }
+    }
+
+    ic->direction = step > 0.0f ? 1 : step < 0.0f ? -1 : 0;
+    if (step == 0.0f) return ic->reference;
+
+    if (rebase) {
+        ic->voltage = voltage;
+        ic->current = current;
+    }
+    float reference = ic->reference + step;
+    if (reference > ic->vMax) reference = ic->vMax;
+    else if (reference < ic->vMin) reference = ic->vMin;
+    ic->reference = reference;
+    return reference;
+}
+
+void IncrementalConductanceReset(IncrementalConductance_t * ic, float reference) {
+    if (reference > ic->vMax) reference = ic->vMax;
+    else if (reference < ic->vMin) reference = ic->vMin;
+    ic->reference = reference;
+    ic->primed = false;
+    ic->direction = 0;
+    ic->side = 0;
+    ic->crossed = false;
+}
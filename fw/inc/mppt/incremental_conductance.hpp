@@ -0,0 +1,162 @@
+/**
+ * @file incremental_conductance.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Incremental conductance maximum power point tracker with decision
+ *        thresholds derived from the measured sensor noise. Generates the
+ *        array voltage reference of the MPPT loop.
+ * @version 0.1
+ * @date 2023-08-26
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+At the MPP, dP/dV = I + V dI/dV = 0, i.e. the incremental conductance dI/dV
+equals -I/V. Multiplying through by dV avoids the division, so each step the
+tracker evaluates
+
+    g = V dI + I dV     (the linearized power change)
+
+against the previous step, and decides:
+
+    |dV| <= k sigma_dV, |dI| >  k sigma_dI:  irradiance changed; move towards
+                                             dI (v_mpp rises with irradiance).
+    |dV| <= k sigma_dV, |dI| <= k sigma_dI:  hold if holding; otherwise the
+                                             last step is not resolved yet, so
+                                             step again by stepMin the same way.
+    |dV| >  k sigma_dV, |g|  <= k sigma_g:   hold if the last resolved step
+                                             flipped the sign of g / dV, at
+                                             the MPP within noise; otherwise
+                                             step again by stepMin the same way.
+    |dV| >  k sigma_dV, |g|  >  k sigma_g:   move towards sign(g / dV).
+
+Unlike P&O, the tracker stops perturbing once it is at the MPP, so there is no
+steady state oscillation. It only holds once it has crossed the MPP: at low
+irradiance sigma_g spans many stepMin steps of the power curve, and holding at
+the first unresolved g would stop it well short. While holding, and while a
+step is unresolved, the baseline sample is kept, so slow irradiance drift and
+small steps accumulate until they cross the threshold. After a reset, it
+perturbs once by stepMin to get a first slope.
+
+The thresholds come from the sensor noise. The caller passes the variance of
+the raw samples (i.e. SmaFilter::getVariance()) along with each filtered
+measurement. The tracker smooths the variances, and with `window` raw samples
+per filtered measurement, the difference of two measurements has
+
+    sigma_dV^2 = 2 var_V / window
+    sigma_dI^2 = 2 var_I / window
+    sigma_g^2  = V^2 sigma_dI^2 + I^2 sigma_dV^2
+
+The step adapts like PerturbObserve_t: gain * |dP/dV| clamped to
+[stepMin, stepMax], with stepMin when the slope is undefined.
+*/
+
+/** @brief Definition of an incremental conductance tracker. */
+typedef struct IncrementalConductance {
+    /** @brief Maximum array voltage reference (V). */
+    float vMax;
+
+    /** @brief Minimum array voltage reference (V). */
+    float vMin;
+
+    /** @brief Maximum reference step (V). */
+    float stepMax;
+
+    /** @brief Minimum reference step (V). */
+    float stepMin;
+
+    /** @brief Step per unit slope (V per W/V). */
+    float gain;
+
+    /** @brief Decision threshold in standard deviations. */
+    float k;
+
+    /** @brief Raw samples averaged into each filtered measurement. */
+    float window;
+
+    /** @brief Smoothed variance of the raw array voltage samples (V^2). */
+    float varianceVoltage;
+
+    /** @brief Smoothed variance of the raw array current samples (A^2). */
+    float varianceCurrent;
+
+    /** @brief Array voltage reference (V). */
+    float reference;
+
+    /** @brief Array voltage of the baseline sample (V). */
+    float voltage;
+
+    /** @brief Array current of the baseline sample (A). */
+    float current;
+
+    /** @brief Direction of the last step; 0 while holding. */
+    int8_t direction;
+
+    /** @brief Sign of the last resolved slope g / dV; 0 if none since a reset. */
+    int8_t side;
+
+    /** @brief Whether voltage and current hold a valid baseline sample. */
+    bool primed;
+
+    /** @brief Whether the last resolved slope flipped sign, i.e. crossed the MPP. */
+    bool crossed;
+} IncrementalConductance_t;
+
+/**
+ * @brief IncrementalConductanceInit initializes an IncrementalConductance_t
+ *        struct for later use.
+ *
+ * @param vMax      Maximum array voltage reference (V).
+ * @param vMin      Minimum array voltage reference (V).
+ * @param stepMax   Maximum reference step (V).
+ * @param stepMin   Minimum reference step (V).
+ * @param gain      Step per unit slope (V per W/V).
+ * @param k         Decision threshold in standard deviations, i.e. 3.
+ * @param window    Raw samples averaged into each filtered measurement.
+ * @param reference Initial array voltage reference (V). Clamped.
+ * @return Tracker parameters and state.
+ */
+IncrementalConductance_t IncrementalConductanceInit(
+    float vMax,
+    float vMin,
+    float stepMax,
+    float stepMin,
+    float gain,
+    float k,
+    uint16_t window,
+    float reference
+);
+
+/**
+ * @brief IncrementalConductanceStep observes the array operating point and
+ *        returns the next array voltage reference.
+ *
+ * @param ic              Tracker parameters and state.
+ * @param voltage         Filtered array voltage (V).
+ * @param current         Filtered array current (A).
+ * @param varianceVoltage Variance of the raw array voltage samples (V^2).
+ * @param varianceCurrent Variance of the raw array current samples (A^2).
+ * @return The next array voltage reference (V).
+ * @note Call at a fixed rate, slower than the array voltage loop settles.
+ */
+float IncrementalConductanceStep(
+    IncrementalConductance_t * ic,
+    float voltage,
+    float current,
+    float varianceVoltage,
+    float varianceCurrent
+);
+
+/**
+ * @brief IncrementalConductanceReset restarts tracking from `reference`,
+ *        discarding the baseline sample.
+ *
+ * @param ic        Tracker parameters and state.
+ * @param reference Array voltage reference to restart from (V). Clamped.
+ */
+void IncrementalConductanceReset(IncrementalConductance_t * ic, float reference);
@@ -0,0 +1,248 @@
+/**
+ * @file model_predictor.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Model based maximum power point predictor from the single diode
+ *        model of the array.
+ * @version 0.1
+ * @date 2023-08-30
+ * @copyright Copyright (c) 2023
+ */
+
+/** General imports. */
+#include <math.h>
+
+/** Device Specific imports. */
+#include "./model_predictor.hpp"
+#include "./vmpp_table.hpp"
+
+
+/** Reference cell parameters, see solar_cell_nonideal_model.py. */
+#define MP_ISC_REF 6.15f
+#define MP_VOC_REF 0.721f
+#define MP_G_REF 1000.0f
+#define MP_T_REF 298.15f
+#define MP_T_COEFF_ISC 0.005f
+#define MP_T_COEFF_VOC -0.0022f
+#define MP_N 1.0f
+#define MP_K_Q 8.617333E-5f // k / q (V/K).
+
+/** Newton steps on w + ln w = ln z, and on dP/dV_d. */
+#define MP_LAMBERT_ITERATIONS 2
+#define MP_MPP_ITERATIONS 3
+
+/** Smoothing factor of the learned offset of the prediction. */
+#define MP_OFFSET_ALPHA (1.0f / 64.0f)
+
+/** Relative distance of the global MPP from the model MPP that means shading. */
+#define MP_SHADE_MARGIN 0.1f
+
+/** Fraction of the photo current the array current must reach to estimate. */
+#define MP_CURRENT_FRACTION 0.25f
+
+/** Secant steps on the temperature from V_oc, and their range (K). */
+#define MP_VOC_ITERATIONS 4
+#define MP_VOC_T_STEP 5.0f
+#define MP_VOC_T_MIN 233.15f
+#define MP_VOC_T_MAX 363.15f
+
+ModelPredictor_t ModelPredictorInit(
+    uint16_t cells,
+    float rS,
+    float rSh,
+    float vMax,
+    float vMin,
+    float threshold,
+    float tolerance,
+    float temperature,
+    bool table
+) {
+    ModelPredictor_t output = {
+        cells,
+        rS,
+        rSh,
+        vMax,
+        vMin,
+        threshold,
+        tolerance,
+        temperature,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        false,
+        true,
+        table
+    };
+    ModelPredictorSetTemperature(&output, temperature);
+    ModelPredictorReset(&output);
+    return output;
+}
+
+void ModelPredictorSetTemperature(ModelPredictor_t * mp, float temperature) {
+    float dT = MP_T_REF - temperature;
+    float isc = MP_ISC_REF * (1.0f - MP_T_COEFF_ISC * dT);
+    float voc = MP_VOC_REF * (1.0f - MP_T_COEFF_VOC * dT);
+    mp->temperature = temperature;
+    mp->vT = MP_N * MP_K_Q * temperature;
+    mp->i0 = isc / (expf(voc / mp->vT) - 1.0f);
+    mp->iPhRef = isc * (mp->rSh + mp->rS) / mp->rSh;
+}
+
+/** @brief Photo current of a cell for an array operating point (A). */
+static float PhotoCurrent(const ModelPredictor_t * mp, float voltage, float current) {
+    float vD = voltage / mp->cells + current * mp->rS;
+    return current + mp->i0 * (expf(vD / mp->vT) - 1.0f) + vD / mp->rSh;
+}
+
+float ModelPredictorIrradiance(const ModelPredictor_t * mp, float voltage, float current) {
+    return MP_G_REF * PhotoCurrent(mp, voltage, current) / mp->iPhRef;
+}
+
+float ModelPredictorVmpp(const ModelPredictor_t * mp, float irradiance) {
+    float iPh = mp->iPhRef * irradiance / MP_G_REF;
+    if (iPh <= 0.0f) return 0.0f;
+
+    /* Ideal diode seed: V_d = V_t (W(z) - 1), from the asymptote of W. */
+    float lnZ = 1.0f + logf((iPh + mp->i0) / mp->i0);
+    float w = lnZ - logf(lnZ);
+    for (int k = 0; k < MP_LAMBERT_ITERATIONS; ++k) {
+        w -= (w + logf(w) - lnZ) / (1.0f + 1.0f / w);
+    }
+    float vD = mp->vT * (w - 1.0f);
+
+    /* Add the series and shunt resistances. */
+    float i = 0.0f;
+    for (int k = 0; k < MP_MPP_ITERATIONS; ++k) {
+        float diode = mp->i0 * expf(vD / mp->vT);
+        i = iPh - (diode - mp->i0) - vD / mp->rSh;
+        float g = diode / mp->vT + 1.0f / mp->rSh;
+        float dG = diode / (mp->vT * mp->vT);
+        float h = i + 2.0f * i * mp->rS * g - vD * g;
+        float dH = -g * (1.0f + 2.0f * mp->rS * g) - g + dG * (2.0f * i * mp->rS - vD);
+        vD -= h / dH;
+    }
+    i = iPh - mp->i0 * (expf(vD / mp->vT) - 1.0f) - vD / mp->rSh;
+    return mp->cells * (vD - i * mp->rS);
+}
+
+/** @brief Clamped node index and fraction of x on an evenly spaced axis. */
+static int Locate(float x, float min, float scale, int nodes, float * fraction) {
+    float u = (x - min) * scale;
+    if (u < 0.0f) u = 0.0f;
+    else if (u > nodes - 1) u = nodes - 1;
+    int k = (int) u;
+    if (k > nodes - 2) k = nodes - 2;
+    *fraction = u - k;
+    return k;
+}
+
+float ModelPredictorVmppTable(float temperature, float voltage, float current) {
+    static constexpr float TEMPERATURE_SCALE =
+        (VMPP_TABLE_TEMPERATURES - 1) / (VMPP_TABLE_TEMPERATURE_MAX - VMPP_TABLE_TEMPERATURE_MIN);
+    static constexpr float CURRENT_SCALE =
+        (VMPP_TABLE_CURRENTS - 1) / (VMPP_TABLE_CURRENT_MAX - VMPP_TABLE_CURRENT_MIN);
+    static constexpr float VOLTAGE_SCALE =
+        (VMPP_TABLE_VOLTAGES - 1) / (VMPP_TABLE_VOLTAGE_MAX - VMPP_TABLE_VOLTAGE_MIN);
+
+    /* Clamp to the table, then interpolate within the cell. */
+    float s, u, w;
+    int plane = Locate(
+        temperature, VMPP_TABLE_TEMPERATURE_MIN, TEMPERATURE_SCALE, VMPP_TABLE_TEMPERATURES, &s
+    );
+    int row = Locate(current, VMPP_TABLE_CURRENT_MIN, CURRENT_SCALE, VMPP_TABLE_CURRENTS, &u);
+    int col = Locate(voltage, VMPP_TABLE_VOLTAGE_MIN, VOLTAGE_SCALE, VMPP_TABLE_VOLTAGES, &w);
+
+    float atPlane[2];
+    for (int k = 0; k < 2; ++k) {
+        const float * low = VMPP_TABLE[plane + k][row];
+        const float * high = VMPP_TABLE[plane + k][row + 1];
+        float atLow = low[col] + w * (low[col + 1] - low[col]);
+        float atHigh = high[col] + w * (high[col + 1] - high[col]);
+        atPlane[k] = atLow + u * (atHigh - atLow);
+    }
+    return atPlane[0] + s * (atPlane[1] - atPlane[0]);
+}
+
+/** @brief The prediction of the configured method, before the offset (V). */
+static float Predict(const ModelPredictor_t * mp, float voltage, float current, float irradiance) {
+    if (mp->table) return ModelPredictorVmppTable(mp->temperature, voltage, current);
+    return ModelPredictorVmpp(mp, irradiance);
+}
+
+bool ModelPredictorStep(ModelPredictor_t * mp, float voltage, float current) {
+    if (!mp->enabled) return false;
+    float iPh = PhotoCurrent(mp, voltage, current);
+    float irradiance = MP_G_REF * iPh / mp->iPhRef;
+    if (current < MP_CURRENT_FRACTION * iPh) irradiance = 0.0f;
+
+    /* While moving to a prediction the operating point is a transient. */
+    if (mp->settling) {
+        mp->irradiance = irradiance;
+        if (fabsf(voltage - mp->vmpp) > mp->tolerance) return true;
+        mp->settling = false;
+        return false;
+    }
+
+    float last = mp->irradiance;
+    mp->irradiance = irradiance;
+    if (irradiance <= 0.0f) return false;
+    if (last > 0.0f && fabsf(irradiance - last) <= mp->threshold * last) {
+        /* The tracker holds the operating point around the actual MPP. */
+        float error = voltage - Predict(mp, voltage, current, irradiance);
+        mp->offset += MP_OFFSET_ALPHA * (error - mp->offset);
+        return false;
+    }
+
+    float vmpp = Predict(mp, voltage, current, irradiance) + mp->offset;
+    if (vmpp > mp->vMax) vmpp = mp->vMax;
+    else if (vmpp < mp->vMin) vmpp = mp->vMin;
+    mp->vmpp = vmpp;
+    mp->settling = true;
+    return true;
+}
+
+void ModelPredictorCheck(ModelPredictor_t * mp, float voltage, float current) {
+    float irradiance = ModelPredictorIrradiance(mp, voltage, current);
+    float vmpp = Predict(mp, voltage, current, irradiance) + mp->offset;
+    mp->enabled = fabsf(voltage - vmpp) <= MP_SHADE_MARGIN * vmpp;
+    mp->irradiance = irradiance;
+    mp->settling = false;
+}
+
+/** @brief Log ratio of the photo currents from V_oc and from (V, I). */
+static float VocResidual(const ModelPredictor_t * mp, float voc, float voltage, float current) {
+    return logf(PhotoCurrent(mp, voc, 0.0f) / PhotoCurrent(mp, voltage, current));
+}
+
+void ModelPredictorSetVoc(ModelPredictor_t * mp, float voc, float voltage, float current) {
+    if (!mp->enabled || voc <= voltage) return;
+    if (current < MP_CURRENT_FRACTION * PhotoCurrent(mp, voltage, current)) return;
+
+    float tPrev = mp->temperature;
+    float fPrev = VocResidual(mp, voc, voltage, current);
+    float t = tPrev + (fPrev > 0.0f ? -MP_VOC_T_STEP : MP_VOC_T_STEP);
+    for (int k = 0; k < MP_VOC_ITERATIONS; ++k) {
+        ModelPredictorSetTemperature(mp, t);
+        float f = VocResidual(mp, voc, voltage, current);
+        if (f == fPrev) break;
+        float next = t - f * (t - tPrev) / (f - fPrev);
+        if (next > MP_VOC_T_MAX) next = MP_VOC_T_MAX;
+        else if (next < MP_VOC_T_MIN) next = MP_VOC_T_MIN;
+        tPrev = t;
+        fPrev = f;
+        t = next;
+    }
+    ModelPredictorSetTemperature(mp, t);
+
+    /* The offset compensated the old temperature; the next step compares against the new estimate. */
+    mp->offset = 0.0f;
+    mp->irradiance = ModelPredictorIrradiance(mp, voltage, current);
+}
+
+void ModelPredictorReset(ModelPredictor_t * mp) {
+    mp->irradiance = 0.0f;
+    mp->settling = false;
+    mp->enabled = true;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file model_predictor.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Model based maximum power point predictor. Estimates the irradiance
+ *        from one operating point with the single diode model of the array,
+ *        and predicts the MPP voltage, so the tracker can jump there after an
+ *        irradiance change instead of climbing.
+ * @version 0.1
+ * @date 2023-08-30
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+Each cell follows the single diode model of
+sw/design_procedures/solar_cell_nonideal_model.py, with the cell count, r_s
+and r_sh of sw/design_files/design_specs.json:
+
+    I = I_ph - I_0 (exp(V_d / V_t) - 1) - V_d / R_sh,    V_d = V + I R_s
+
+At a given temperature, V_t and I_0 are fixed (I_0 hardly depends on the
+irradiance in this model) and I_ph is proportional to the irradiance. They are
+precomputed when the temperature is set, so that a measured (V, I) gives I_ph,
+i.e. the irradiance, in closed form.
+
+The MPP is where dP/dV_d = 0:
+
+    h(V_d) = I + 2 I R_s G - V_d G = 0,    G = I_0 exp(V_d / V_t) / V_t + 1 / R_sh
+
+Without R_s and R_sh it has the closed form V_d = V_t (W(z) - 1), with W the
+Lambert W function and z = e (I_ph + I_0) / I_0. That is the seed; W is
+evaluated from ln z, where z itself would overflow a float, and refined by
+Newton's method on w + ln w = ln z. A few Newton steps on h then add R_s and
+R_sh.
+
+Alternatively, the prediction is a trilinear lookup in VMPP_TABLE, indexed by
+the configured temperature and the operating point. It is trained by
+sw/vmpp_table_design.py on simulated curves over a range of irradiance,
+temperature and shading, so it needs no transcendental functions, and its
+error bounds are in vmpp_table.hpp.
+
+ModelPredictorStep estimates the irradiance at every tracker step. When it
+moved by more than `threshold` (relative) since the last step, it predicts
+the MPP voltage and returns true: the caller jumps the reference there and
+resets its tracker, which then only refines the prediction. The first valid
+estimate always predicts. It keeps returning true, holding the tracker at the
+prediction, until the array voltage is within `tolerance` of it; a tracker
+stepping while the voltage loop is still slewing would read the transient as
+a slope and walk away.
+
+The model assumes a uniformly lit array at the configured temperature. An
+error in the temperature shifts the prediction by about 0.18 V/K for the 100
+cells. Between predictions the tracker holds the operating point around the
+actual MPP, so the predictor learns the mean distance of the operating point
+from the model MPP as an offset, and adds it to the next prediction. The
+error also makes the estimate depend on the operating point, which is why
+only a change between two steps, where the tracker moved the voltage a little
+at most, triggers a prediction.
+
+A measured open circuit voltage removes most of that error. V_oc and an
+operating point under the same conditions must give the same I_ph:
+
+    I_0 (exp(V_oc / (n_cells V_t)) - 1) + V_oc / (n_cells R_sh) = I_ph(V, I)
+
+The left side grows about 6 % per K through I_0 and V_t, the right side hardly
+depends on the temperature, so ModelPredictorSetVoc solves for the cell
+temperature with a few secant steps, and restarts the learned offset.
+
+Under partial shading the estimate is meaningless and the global scan has to
+find the MPP. ModelPredictorCheck compares the model against the point the
+scan found, and suspends predictions until the next scan when they disagree,
+rather than pulling the tracker back to a local maximum.
+*/
+
+/** @brief Definition of a model based MPP predictor. */
+typedef struct ModelPredictor {
+    /** @brief Number of cells in series. */
+    uint16_t cells;
+
+    /** @brief Series resistance per cell (Ohms). */
+    float rS;
+
+    /** @brief Shunt resistance per cell (Ohms). */
+    float rSh;
+
+    /** @brief Maximum predicted array voltage (V). */
+    float vMax;
+
+    /** @brief Minimum predicted array voltage (V). */
+    float vMin;
+
+    /** @brief Relative irradiance change that triggers a prediction. */
+    float threshold;
+
+    /** @brief Distance from the prediction the array must settle within (V). */
+    float tolerance;
+
+    /** @brief Cell temperature (K). */
+    float temperature;
+
+    /** @brief Thermal voltage at temperature (V). */
+    float vT;
+
+    /** @brief Diode saturation current at temperature (A). */
+    float i0;
+
+    /** @brief Photo current at 1000 W/m^2 and temperature (A). */
+    float iPhRef;
+
+    /** @brief Irradiance estimate of the last valid step, 0 for none (W/m^2). */
+    float irradiance;
+
+    /** @brief Predicted MPP array voltage (V). */
+    float vmpp;
+
+    /** @brief Learned offset of the actual MPP from the model (V). */
+    float offset;
+
+    /** @brief Whether the array is still moving to the prediction. */
+    bool settling;
+
+    /** @brief Whether the model agreed with the last global scan. */
+    bool enabled;
+
+    /** @brief Whether to predict with VMPP_TABLE instead of the solve. */
+    bool table;
+} ModelPredictor_t;
+
+/**
+ * @brief ModelPredictorInit initializes a ModelPredictor_t struct for later
+ *        use.
+ *
+ * @param cells       Number of cells in series.
+ * @param rS          Series resistance per cell (Ohms).
+ * @param rSh         Shunt resistance per cell (Ohms).
+ * @param vMax        Maximum predicted array voltage (V).
+ * @param vMin        Minimum predicted array voltage (V).
+ * @param threshold   Relative irradiance change that triggers a prediction.
+ * @param tolerance   Distance from the prediction to settle within (V).
+ * @param temperature Estimated cell temperature (K).
+ * @param table       Whether to predict with VMPP_TABLE instead of the solve.
+ * @return Predictor parameters and state.
+ */
+ModelPredictor_t ModelPredictorInit(
+    uint16_t cells,
+    float rS,
+    float rSh,
+    float vMax,
+    float vMin,
+    float threshold,
+    float tolerance,
+    float temperature,
+    bool table
+);
+
+/**
+ * @brief ModelPredictorSetTemperature updates the estimated cell temperature
+ *        and the constants that depend on it.
+ *
+ * @param mp          Predictor parameters and state.
+ * @param temperature Estimated cell temperature (K).
+ */
+void ModelPredictorSetTemperature(ModelPredictor_t * mp, float temperature);
+
+/**
+ * @brief ModelPredictorIrradiance estimates the irradiance from an operating
+ *        point.
+ *
+ * @param mp      Predictor parameters and state.
+ * @param voltage Array voltage (V).
+ * @param current Array current (A).
+ * @return Estimated irradiance (W/m^2).
+ */
+float ModelPredictorIrradiance(const ModelPredictor_t * mp, float voltage, float current);
+
+/**
+ * @brief ModelPredictorVmpp predicts the MPP voltage at an irradiance.
+ *
+ * @param mp         Predictor parameters and state.
+ * @param irradiance Irradiance (W/m^2).
+ * @return Predicted MPP array voltage (V), unclamped.
+ */
+float ModelPredictorVmpp(const ModelPredictor_t * mp, float irradiance);
+
+/**
+ * @brief ModelPredictorVmppTable predicts the global MPP voltage from an
+ *        operating point with VMPP_TABLE.
+ *
+ * @param temperature Estimated cell temperature (K).
+ * @param voltage     Array voltage (V).
+ * @param current     Array current (A).
+ * @return Predicted MPP array voltage (V), unclamped.
+ */
+float ModelPredictorVmppTable(float temperature, float voltage, float current);
+
+/**
+ * @brief ModelPredictorStep estimates the irradiance and predicts the MPP
+ *        voltage into mp->vmpp if it changed by more than the threshold since
+ *        the last step.
+ *
+ * @param mp      Predictor parameters and state.
+ * @param voltage Averaged array voltage (V).
+ * @param current Averaged array current (A).
+ * @return Whether to apply mp->vmpp and reset the tracker instead of stepping
+ *         it: on a new prediction, and until the array settled there.
+ * @note Call at the tracker rate, on settled operating points. Points near
+ *       open circuit are skipped, where the estimate is mostly noise.
+ */
+bool ModelPredictorStep(ModelPredictor_t * mp, float voltage, float current);
+
+/**
+ * @brief ModelPredictorCheck compares the model MPP against the global MPP
+ *        found by a scan, and enables predictions only if they agree. The
+ *        estimate at the global MPP becomes the reference for the next step.
+ *
+ * @param mp      Predictor parameters and state.
+ * @param voltage Array voltage of the global MPP (V).
+ * @param current Array current of the global MPP (A).
+ */
+void ModelPredictorCheck(ModelPredictor_t * mp, float voltage, float current);
+
+/**
+ * @brief ModelPredictorSetVoc estimates the cell temperature from a measured
+ *        open circuit voltage and the operating point just before it, and
+ *        sets it.
+ *
+ * @param mp      Predictor parameters and state.
+ * @param voc     Array open circuit voltage (V).
+ * @param voltage Averaged array voltage before the measurement (V).
+ * @param current Averaged array current before the measurement (A).
+ * @note Ignored while predictions are suspended for shading, and for points
+ *       where the estimate is mostly noise.
+ */
+void ModelPredictorSetVoc(ModelPredictor_t * mp, float voc, float voltage, float current);
+
+/**
+ * @brief ModelPredictorReset forgets the last estimate, so that the next
+ *        valid one predicts again, stops settling, and enables predictions.
+ *
+ * @param mp Predictor parameters and state.
+ */
+void ModelPredictorReset(ModelPredictor_t * mp);
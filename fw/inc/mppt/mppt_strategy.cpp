@@ -0,0 +1,168 @@
+/**
+ * @file mppt_strategy.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Common interface of the voltage maximum power point trackers.
+ * @version 0.1
+ * @date 2023-09-01
+ * @copyright Copyright (c) 2023
+ */
+
+/** Device Specific imports. */
+#include "./mppt_strategy.hpp"
+
+
+static float PerturbObserveEntryStep(MPPT_t * mppt, const MPPTSample_t * sample) {
+    return PerturbObserveStep(&mppt->po, sample->voltage, sample->current);
+}
+static void PerturbObserveEntryReset(MPPT_t * mppt, float reference) {
+    PerturbObserveReset(&mppt->po, reference);
+}
+static float PerturbObserveEntryDiagnostic(const MPPT_t * mppt) {
+    return mppt->po.direction * mppt->po.step;
+}
+
+static float IncrementalConductanceEntryStep(MPPT_t * mppt, const MPPTSample_t * sample) {
+    return IncrementalConductanceStep(
+        &mppt->ic,
+        sample->voltage,
+        sample->current,
+        sample->varianceVoltage,
+        sample->varianceCurrent
+    );
+}
+static void IncrementalConductanceEntryReset(MPPT_t * mppt, float reference) {
+    IncrementalConductanceReset(&mppt->ic, reference);
+}
+static float IncrementalConductanceEntryDiagnostic(const MPPT_t * mppt) {
+    return (float) mppt->ic.direction;
+}
+
+static float ExtremumSeekingEntryStep(MPPT_t * mppt, const MPPTSample_t * sample) {
+    return ExtremumSeekingStep(&mppt->es, sample->voltage, sample->current);
+}
+static void ExtremumSeekingEntryReset(MPPT_t * mppt, float reference) {
+    ExtremumSeekingReset(&mppt->es, reference);
+}
+static float ExtremumSeekingEntryDiagnostic(const MPPT_t * mppt) {
+    return mppt->es.rate;
+}
+
+static float FractionalVocEntryStep(MPPT_t * mppt, const MPPTSample_t *) {
+    return FractionalVocStep(&mppt->fv);
+}
+static void FractionalVocEntryReset(MPPT_t * mppt, float reference) {
+    FractionalVocReset(&mppt->fv, reference);
+}
+static float FractionalVocEntryDiagnostic(const MPPT_t * mppt) {
+    return mppt->fv.k;
+}
+
+/*
+P&O and incremental conductance converge to a three point oscillation of the
+minimum step; the setpoint of extremum seeking carries the dither, so its
+window is two dither periods and its band the dither plus a minimum step.
+Fractional V_oc holds its reference between measurements.
+*/
+const MPPTStrategy_t MPPT_STRATEGIES[NUM_MPPT_STRATEGIES] = {
+    {
+        "P&O",
+        true,
+        4,
+        1.0f,
+        "step (V)",
+        &PerturbObserveEntryStep,
+        &PerturbObserveEntryReset,
+        &PerturbObserveEntryDiagnostic
+    },
+    {
+        "IncCond",
+        true,
+        4,
+        1.0f,
+        "direction",
+        &IncrementalConductanceEntryStep,
+        &IncrementalConductanceEntryReset,
+        &IncrementalConductanceEntryDiagnostic
+    },
+    {
+        "Extremum seeking",
+        false,
+        2 * EXTREMUM_SEEKING_PERIOD,
+        1.5f,
+        "rate (V/tick)",
+        &ExtremumSeekingEntryStep,
+        &ExtremumSeekingEntryReset,
+        &ExtremumSeekingEntryDiagnostic
+    },
+    {
+        "Fractional Voc",
+        true,
+        4,
+        1.0f,
+        "k",
+        &FractionalVocEntryStep,
+        &FractionalVocEntryReset,
+        &FractionalVocEntryDiagnostic
+    }
+};
+
+MPPT_t MPPTInit(
+    PerturbObserve_t po,
+    IncrementalConductance_t ic,
+    ExtremumSeeking_t es,
+    FractionalVoc_t fv,
+    enum MPPTStrategyID id,
+    float reference
+) {
+    MPPT_t output = {
+        po,
+        ic,
+        es,
+        fv,
+        MPPT_PERTURB_OBSERVE,
+        &MPPT_STRATEGIES[MPPT_PERTURB_OBSERVE],
+        { reference, 0.0f, 0, false },
+        0,
+        0.0f,
+        0.0f
+    };
+    MPPTSelect(&output, id, reference);
+    return output;
+}
+
+void MPPTSelect(MPPT_t * mppt, enum MPPTStrategyID id, float reference) {
+    if (id < 0 || id >= NUM_MPPT_STRATEGIES) return;
+    mppt->id = id;
+    mppt->strategy = &MPPT_STRATEGIES[id];
+    MPPTReset(mppt, reference);
+    mppt->telemetry.steps = 0;
+    mppt->telemetry.converged = false;
+}
+
+float MPPTStep(MPPT_t * mppt, const MPPTSample_t * sample) {
+    float setpoint = mppt->strategy->step(mppt, sample);
+    MPPTTelemetry_t * telemetry = &mppt->telemetry;
+    telemetry->setpoint = setpoint;
+    telemetry->power = sample->voltage * sample->current;
+    ++telemetry->steps;
+
+    /* Judge convergence once per window, on the span of the setpoint. */
+    if (mppt->index == 0 || setpoint > mppt->setpointMax) mppt->setpointMax = setpoint;
+    if (mppt->index == 0 || setpoint < mppt->setpointMin) mppt->setpointMin = setpoint;
+    if (++mppt->index >= mppt->strategy->window) {
+        mppt->index = 0;
+        telemetry->converged = mppt->setpointMax - mppt->setpointMin <= mppt->strategy->band;
+        if (telemetry->converged) telemetry->steps = 0;
+    }
+    return setpoint;
+}
+
+void MPPTReset(MPPT_t * mppt, float reference) {
+    mppt->strategy->reset(mppt, reference);
+    mppt->telemetry.setpoint = reference;
+    mppt->index = 0;
+}
+
+float MPPTDiagnostic(const MPPT_t * mppt) {
+    return mppt->strategy->diagnostic(mppt);
+}
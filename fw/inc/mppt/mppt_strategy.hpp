@@ -0,0 +1,207 @@
+/**
+ * @file mppt_strategy.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Common interface of the voltage maximum power point trackers, so they
+ *        can be switched at runtime and compared on the same telemetry.
+ * @version 0.1
+ * @date 2023-09-01
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Device Specific imports. */
+#include "./extremum_seeking.hpp"
+#include "./fractional_voc.hpp"
+#include "./incremental_conductance.hpp"
+#include "./perturb_observe.hpp"
+
+
+/*
+Every tracker of the array voltage reference is wrapped by an entry of
+MPPT_STRATEGIES: its step and reset, whether it steps at the tracker rate on
+averages or every outer loop tick, and one diagnostic of its search. The table
+is fixed at compile time, and each entry calls its tracker directly, so
+selecting a strategy is an index into the table rather than a virtual call.
+MPPT_t holds the state of every tracker, so a switch only resets the selected
+one at the current reference and takes over bumplessly.
+
+There is no ripple correlation entry. Neither injected nor switching ripple
+gives it the slope of the array power on this board; see
+docs/RIPPLE_CORRELATION.md for the measurements.
+
+MPPTStep keeps the same telemetry for every strategy: the setpoint, the array
+power, and the steps since the tracker last converged. A strategy has
+converged when its setpoint spanned at most `band` over a block of `window`
+steps; the window covers a full search pattern (the three point oscillation of
+P&O, a dither period of extremum seeking), so the oscillation around the MPP
+does not count as a search.
+
+Fractional V_oc steps like the averaging trackers, but only holds k V_oc; the
+caller runs the blanking windows it asks for through mppt->fv, which also
+serves the scans and the predictor while another strategy is selected.
+*/
+
+/** @brief Strategies of MPPT_STRATEGIES, in table order. */
+enum MPPTStrategyID {
+    MPPT_PERTURB_OBSERVE=0,
+    MPPT_INCREMENTAL_CONDUCTANCE=1,
+    MPPT_EXTREMUM_SEEKING=2,
+    MPPT_FRACTIONAL_VOC=3,
+    NUM_MPPT_STRATEGIES=4
+};
+
+/** @brief Measurements handed to a strategy at every step. */
+typedef struct MPPTSample {
+    /** @brief Array voltage (V). */
+    float voltage;
+
+    /** @brief Array current (A). */
+    float current;
+
+    /** @brief Variance of the raw voltage samples (V^2). */
+    float varianceVoltage;
+
+    /** @brief Variance of the raw current samples (A^2). */
+    float varianceCurrent;
+} MPPTSample_t;
+
+/** @brief Telemetry common to every strategy. */
+typedef struct MPPTTelemetry {
+    /** @brief Array voltage reference of the last step (V). */
+    float setpoint;
+
+    /** @brief Array power of the last step (W). */
+    float power;
+
+    /** @brief Steps since the end of the last converged window. */
+    uint32_t steps;
+
+    /** @brief Whether the last full window converged. */
+    bool converged;
+} MPPTTelemetry_t;
+
+struct MPPT;
+
+/** @brief Definition of a strategy table entry. */
+typedef struct MPPTStrategy {
+    /** @brief Name for telemetry and the benchmark. */
+    const char * name;
+
+    /**
+     * @brief Whether it steps at the tracker rate on windowed averages, rather
+     *        than every outer loop tick on the sensor filters.
+     */
+    bool averaged;
+
+    /** @brief Steps per convergence window. */
+    uint16_t window;
+
+    /** @brief Setpoint span of a converged window (V). */
+    float band;
+
+    /** @brief Name and unit of the diagnostic. */
+    const char * diagnosticName;
+
+    /** @brief Steps the tracker and returns the array voltage reference (V). */
+    float (*step)(struct MPPT * mppt, const MPPTSample_t * sample);
+
+    /** @brief Resets the tracker to an array voltage reference (V). */
+    void (*reset)(struct MPPT * mppt, float reference);
+
+    /** @brief Strategy specific diagnostic of the search. */
+    float (*diagnostic)(const struct MPPT * mppt);
+} MPPTStrategy_t;
+
+/** @brief Strategy table, indexed by enum MPPTStrategyID. */
+extern const MPPTStrategy_t MPPT_STRATEGIES[NUM_MPPT_STRATEGIES];
+
+/** @brief Definition of the selected strategy and the state of all of them. */
+typedef struct MPPT {
+    /** @brief Perturb and observe tracker. */
+    PerturbObserve_t po;
+
+    /** @brief Incremental conductance tracker. */
+    IncrementalConductance_t ic;
+
+    /** @brief Extremum seeking tracker. */
+    ExtremumSeeking_t es;
+
+    /** @brief Fractional open circuit voltage tracker. */
+    FractionalVoc_t fv;
+
+    /** @brief Selected strategy. */
+    enum MPPTStrategyID id;
+
+    /** @brief Entry of the selected strategy. */
+    const MPPTStrategy_t * strategy;
+
+    /** @brief Common telemetry. */
+    MPPTTelemetry_t telemetry;
+
+    /** @brief Steps into the current convergence window. */
+    uint16_t index;
+
+    /** @brief Setpoint range of the current convergence window (V). */
+    float setpointMax;
+    float setpointMin;
+} MPPT_t;
+
+/**
+ * @brief MPPTInit initializes a MPPT_t struct for later use.
+ *
+ * @param po        Perturb and observe tracker.
+ * @param ic        Incremental conductance tracker.
+ * @param es        Extremum seeking tracker.
+ * @param fv        Fractional open circuit voltage tracker.
+ * @param id        Initially selected strategy.
+ * @param reference Initial array voltage reference (V).
+ * @return Trackers and selection.
+ */
+MPPT_t MPPTInit(
+    PerturbObserve_t po,
+    IncrementalConductance_t ic,
+    ExtremumSeeking_t es,
+    FractionalVoc_t fv,
+    enum MPPTStrategyID id,
+    float reference
+);
+
+/**
+ * @brief MPPTSelect switches to another strategy, starting from a reference.
+ *
+ * @param mppt      Trackers and selection.
+ * @param id        Strategy to select. Out of range ids are ignored.
+ * @param reference Array voltage reference to continue from (V).
+ */
+void MPPTSelect(MPPT_t * mppt, enum MPPTStrategyID id, float reference);
+
+/**
+ * @brief MPPTStep steps the selected strategy and updates the telemetry.
+ *
+ * @param mppt   Trackers and selection.
+ * @param sample Measurements, averaged or filtered as the strategy asks.
+ * @return Array voltage reference (V).
+ * @note Call at the rate mppt->strategy->averaged asks for.
+ */
+float MPPTStep(MPPT_t * mppt, const MPPTSample_t * sample);
+
+/**
+ * @brief MPPTReset resets the selected strategy to a reference and restarts
+ *        the convergence window.
+ *
+ * @param mppt      Trackers and selection.
+ * @param reference Array voltage reference (V).
+ */
+void MPPTReset(MPPT_t * mppt, float reference);
+
+/**
+ * @brief MPPTDiagnostic returns the diagnostic of the selected strategy.
+ *
+ * @param mppt Trackers and selection.
+ * @return Value in the unit of mppt->strategy->diagnosticName.
+ */
+float MPPTDiagnostic(const MPPT_t * mppt);
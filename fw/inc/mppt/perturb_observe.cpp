@@ -0,0 +1,80 @@
+/**
+ * @file perturb_observe.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Perturb and observe maximum power point tracker with an adaptive
+ *        step size.
+ * @version 0.1
+ * @date 2023-08-25
+ * @copyright Copyright (c) 2023
+ */
+
+/** Device Specific imports. */
+#include "./perturb_observe.hpp"
+
+
+PerturbObserve_t PerturbObserveInit(
+    float vMax,
+    float vMin,
+    float stepMax,
+    float stepMin,
+    float gain,
+    float reference
+) {
+    PerturbObserve_t output = {
+        vMax,
+        vMin,
+        stepMax,
+        stepMin,
+        gain,
+        reference,
+        0.0f,
+        0.0f,
+        1.0f,
+        stepMin,
+        false
+    };
+    PerturbObserveReset(&output, reference);
+    return output;
+}
+
+float PerturbObserveStep(PerturbObserve_t * po, float voltage, float current) {
+    float power = voltage * current;
+    if (!po->primed) {
+        /* First sample after a reset; perturb in the last direction. */
+        po->step = po->stepMin;
+    } else {
+        float dV = voltage - po->voltage;
+        float dP = power - po->power;
+        float magnitude = dV < 0.0f ? -dV : dV;
+
+        if (magnitude < po->stepMin * 0.25f) {
+            /* The voltage did not follow; plain P&O on power alone. */
+            if (dP < 0.0f) po->direction = -po->direction;
+            po->step = po->stepMin;
+        } else {
+            float slope = dP / dV;
+            po->direction = slope >= 0.0f ? 1.0f : -1.0f;
+            float step = po->gain * (slope < 0.0f ? -slope : slope);
+            if (step > po->stepMax) step = po->stepMax;
+            else if (step < po->stepMin) step = po->stepMin;
+            po->step = step;
+        }
+    }
+
+    po->voltage = voltage;
+    po->power = power;
+    po->primed = true;
+
+    float reference = po->reference + po->direction * po->step;
+    if (reference > po->vMax) reference = po->vMax;
+    else if (reference < po->vMin) reference = po->vMin;
+    po->reference = reference;
+    return reference;
+}
+
+void PerturbObserveReset(PerturbObserve_t * po, float reference) {
+    if (reference > po->vMax) reference = po->vMax;
+    else if (reference < po->vMin) reference = po->vMin;
+    po->reference = reference;
+    po->primed = false;
+}
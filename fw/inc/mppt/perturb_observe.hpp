@@ -0,0 +1,121 @@
+/**
+ * @file perturb_observe.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Perturb and observe maximum power point tracker with an adaptive
+ *        step size. Generates the array voltage reference of the MPPT loop.
+ * @version 0.1
+ * @date 2023-08-25
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*
+Each step, the tracker compares the array power and voltage against the
+previous step and moves the array voltage reference up the P-V curve:
+
+        P
+        |       MPP
+        |      .-'-.
+        |    .'  |  '.        dP/dV > 0: increase v_ref
+        |   /    |    \       dP/dV < 0: decrease v_ref
+        |  /     |     \
+        | /      |      \
+        |/       |       |
+        ---------------------- V
+               v_mpp     v_oc
+
+The step scales with the slope, |dv_ref| = gain * |dP/dV|, clamped to
+[stepMin, stepMax]. Far from the MPP the slope is steep and the tracker moves
+quickly; near the MPP the slope flattens and the tracker settles into a small
+oscillation of about stepMin around v_mpp.
+
+The measured voltage change is used for the slope, not the reference change,
+so the tracker must be stepped slower than the voltage loop settles. If the
+voltage barely moved (i.e. the loop has not responded yet), the slope is
+undefined; the tracker then falls back to plain P&O, keeping its direction if
+power rose and reversing it otherwise, with the minimum step.
+*/
+
+/** @brief Definition of a perturb and observe tracker. */
+typedef struct PerturbObserve {
+    /** @brief Maximum array voltage reference (V). */
+    float vMax;
+
+    /** @brief Minimum array voltage reference (V). */
+    float vMin;
+
+    /** @brief Maximum reference step (V). */
+    float stepMax;
+
+    /** @brief Minimum reference step (V). */
+    float stepMin;
+
+    /** @brief Step per unit slope (V per W/V). */
+    float gain;
+
+    /** @brief Array voltage reference (V). */
+    float reference;
+
+    /** @brief Array voltage at the last step (V). */
+    float voltage;
+
+    /** @brief Array power at the last step (W). */
+    float power;
+
+    /** @brief Sign of the last reference step, +1 or -1. */
+    float direction;
+
+    /** @brief Magnitude of the last reference step (V). */
+    float step;
+
+    /** @brief Whether voltage and power hold a valid previous sample. */
+    bool primed;
+} PerturbObserve_t;
+
+/**
+ * @brief PerturbObserveInit initializes a PerturbObserve_t struct for later
+ *        use.
+ *
+ * @param vMax      Maximum array voltage reference (V).
+ * @param vMin      Minimum array voltage reference (V).
+ * @param stepMax   Maximum reference step (V).
+ * @param stepMin   Minimum reference step (V).
+ * @param gain      Step per unit slope (V per W/V).
+ * @param reference Initial array voltage reference (V). Clamped.
+ * @return Tracker parameters and state.
+ */
+PerturbObserve_t PerturbObserveInit(
+    float vMax,
+    float vMin,
+    float stepMax,
+    float stepMin,
+    float gain,
+    float reference
+);
+
+/**
+ * @brief PerturbObserveStep observes the array operating point and returns
+ *        the next array voltage reference.
+ *
+ * @param po      Tracker parameters and state.
+ * @param voltage Sensed array voltage (V).
+ * @param current Sensed array current (A).
+ * @return The next array voltage reference (V).
+ * @note Call at a fixed rate, slower than the array voltage loop settles.
+ */
+float PerturbObserveStep(PerturbObserve_t * po, float voltage, float current);
+
+/**
+ * @brief PerturbObserveReset restarts tracking from `reference`, discarding
+ *        the previous sample. Used when another loop took over the converter
+ *        and the operating point moved without the tracker.
+ *
+ * @param po        Tracker parameters and state.
+ * @param reference Array voltage reference to restart from (V). Clamped.
+ */
+void PerturbObserveReset(PerturbObserve_t * po, float reference);
@@ -0,0 +1,148 @@
+/**
+ * @file vmpp_table.hpp
+ * @author Generated by sw/vmpp_table_design.py. Do not edit by hand.
+ * @brief MPP voltage lookup table of the model predictor.
+ * @note Source: design_files/design_specs.json
+ *       100 cells in 5 substrings, r_s = 0.0035 Ohm, r_sh = 40 Ohm,
+ *       8000 curves, 50 to 1100 W/m^2, 0 to 70 C, 0.3 shaded.
+ */
+#pragma once
+
+
+#define VMPP_TABLE_TEMPERATURES 8
+#define VMPP_TABLE_CURRENTS 12
+#define VMPP_TABLE_VOLTAGES 16
+#define VMPP_TABLE_TEMPERATURE_MIN 273.15f
+#define VMPP_TABLE_TEMPERATURE_MAX 343.15f
+#define VMPP_TABLE_CURRENT_MIN 0.0f
+#define VMPP_TABLE_CURRENT_MAX 6.5f
+#define VMPP_TABLE_VOLTAGE_MIN 20.0f
+#define VMPP_TABLE_VOLTAGE_MAX 70.0f
+
+/** Absolute error of the predicted MPP voltage on the test curves (V). */
+#define VMPP_TABLE_UNIFORM_ERROR_P50 0.0399917f
+#define VMPP_TABLE_UNIFORM_ERROR_P95 0.247464f
+#define VMPP_TABLE_UNIFORM_ERROR_MAX 2.06577f
+#define VMPP_TABLE_SHADED_ERROR_P50 10.2996f
+#define VMPP_TABLE_SHADED_ERROR_P95 25.198f
+#define VMPP_TABLE_SHADED_ERROR_MAX 38.9915f
+
+/** Mean fraction of the MPP power at the predicted voltage on the test curves. */
+#define VMPP_TABLE_UNIFORM_HARVEST 0.999931f
+#define VMPP_TABLE_SHADED_HARVEST 0.73192f
+
+/** Global MPP voltage (V) at evenly spaced cell temperatures (K), array currents and voltages. */
+static constexpr float VMPP_TABLE[VMPP_TABLE_TEMPERATURES][VMPP_TABLE_CURRENTS][VMPP_TABLE_VOLTAGES] = {
+    { // 0 C
+        { 63.0025f, 62.9292f, 62.8594f, 62.7898f, 62.7047f, 62.5834f, 62.4135f, 62.1944f, 61.9383f, 61.653f, 61.3471f, 61.0518f, 60.8317f, 60.8133f, 61.1888f, 62.0533f },
+        { 63.5143f, 63.4561f, 63.3997f, 63.3433f, 63.2744f, 63.1785f, 63.0511f, 62.8965f, 62.729f, 62.5644f, 62.4225f, 62.3398f, 62.3595f, 62.5385f, 62.9644f, 63.6401f },
+        { 64.0204f, 63.98f, 63.9384f, 63.8934f, 63.8366f, 63.7638f, 63.6779f, 63.5864f, 63.5036f, 63.4491f, 63.4445f, 63.5231f, 63.7016f, 63.9561f, 64.3076f, 64.7438f },
+        { 64.5119f, 64.4859f, 64.4533f, 64.4173f, 64.3731f, 64.3229f, 64.2748f, 64.2381f, 64.2251f, 64.2551f, 64.3329f, 64.478f, 64.6788f, 64.885f, 65.0922f, 65.3418f },
+        { 64.9802f, 64.9549f, 64.9275f, 64.8958f, 64.8629f, 64.8363f, 64.8198f, 64.824f, 64.8544f, 64.9226f, 65.0298f, 65.1694f, 65.3111f, 65.4303f, 65.5389f, 65.6887f },
+        { 65.4252f, 65.3925f, 65.3595f, 65.3285f, 65.3048f, 65.2947f, 65.2971f, 65.3213f, 65.37f, 65.4436f, 65.5373f, 65.6319f, 65.7091f, 65.7652f, 65.8299f, 65.94f },
+        { 65.8487f, 65.8044f, 65.7602f, 65.7237f, 65.7001f, 65.6928f, 65.7028f, 65.7321f, 65.7775f, 65.8315f, 65.888f, 65.9347f, 65.9649f, 65.99f, 66.0395f, 66.1288f },
+        { 66.2547f, 66.1948f, 66.1371f, 66.0888f, 66.0563f, 66.042f, 66.0452f, 66.0623f, 66.0871f, 66.1113f, 66.1281f, 66.135f, 66.1363f, 66.1468f, 66.1859f, 66.2574f },
+        { 66.6511f, 66.574f, 66.4994f, 66.433f, 66.3827f, 66.3526f, 66.3374f, 66.3311f, 66.3263f, 66.3161f, 66.2975f, 66.2747f, 66.2587f, 66.2617f, 66.2935f, 66.3504f },
+        { 67.0438f, 66.9485f, 66.8552f, 66.7675f, 66.6919f, 66.6374f, 66.5952f, 66.5589f, 66.5214f, 66.4782f, 66.4298f, 66.3841f, 66.3538f, 66.3468f, 66.3658f, 66.4018f },
+        { 67.4355f, 67.3213f, 67.2083f, 67.0993f, 66.9986f, 66.9106f, 66.8344f, 66.7644f, 66.6941f, 66.621f, 66.548f, 66.4836f, 66.4385f, 66.4167f, 66.4152f, 66.4239f },
+        { 67.8272f, 67.6937f, 67.5608f, 67.4297f, 67.3023f, 67.1811f, 67.0685f, 66.9625f, 66.8593f, 66.7582f, 66.6637f, 66.583f, 66.5227f, 66.483f, 66.4581f, 66.4394f },
+    },
+    { // 10 C
+        { 60.9636f, 60.8681f, 60.7795f, 60.6966f, 60.6052f, 60.4853f, 60.3216f, 60.1058f, 59.8447f, 59.5453f, 59.2212f, 58.9211f, 58.7599f, 58.946f, 59.8044f, 61.3355f },
+        { 61.4818f, 61.4052f, 61.3351f, 61.2724f, 61.2067f, 61.1193f, 61.0055f, 60.8647f, 60.7068f, 60.5525f, 60.4249f, 60.3679f, 60.4494f, 60.7626f, 61.4906f, 62.6187f },
+        { 61.9959f, 61.9472f, 61.8994f, 61.8521f, 61.8021f, 61.7432f, 61.6768f, 61.6076f, 61.5436f, 61.5133f, 61.5398f, 61.6572f, 61.8762f, 62.1997f, 62.6888f, 63.4008f },
+        { 62.4979f, 62.4711f, 62.4407f, 62.4067f, 62.3722f, 62.34f, 62.3148f, 62.3005f, 62.308f, 62.3606f, 62.4687f, 62.639f, 62.8473f, 63.0695f, 63.3519f, 63.8088f },
+        { 62.9827f, 62.9623f, 62.941f, 62.9162f, 62.8944f, 62.8851f, 62.8918f, 62.9169f, 62.9659f, 63.0514f, 63.1747f, 63.319f, 63.4544f, 63.5752f, 63.7487f, 64.0794f },
+        { 63.4499f, 63.4239f, 63.3993f, 63.3781f, 63.366f, 63.3703f, 63.3936f, 63.4341f, 63.497f, 63.5806f, 63.6769f, 63.7674f, 63.8373f, 63.9016f, 64.033f, 64.2871f },
+        { 63.8984f, 63.8619f, 63.8278f, 63.8013f, 63.7884f, 63.7934f, 63.8172f, 63.8573f, 63.9112f, 63.9693f, 64.0232f, 64.0655f, 64.0953f, 64.1358f, 64.238f, 64.4299f },
+        { 64.3327f, 64.2814f, 64.2325f, 64.1921f, 64.1676f, 64.1615f, 64.1722f, 64.1952f, 64.2234f, 64.2474f, 64.2615f, 64.2684f, 64.2765f, 64.3043f, 64.3836f, 64.527f },
+        { 64.7603f, 64.6889f, 64.6198f, 64.5586f, 64.5126f, 64.4846f, 64.4715f, 64.4667f, 64.4618f, 64.4502f, 64.4311f, 64.4123f, 64.4063f, 64.4264f, 64.4875f, 64.5858f },
+        { 65.1851f, 65.0909f, 64.9985f, 64.9116f, 64.8355f, 64.7749f, 64.7307f, 64.6938f, 64.6551f, 64.6107f, 64.5633f, 64.5234f, 64.5047f, 64.5141f, 64.5549f, 64.6146f },
+        { 65.6093f, 65.4909f, 65.3734f, 65.2588f, 65.1494f, 65.0479f, 64.9672f, 64.8969f, 64.8255f, 64.7517f, 64.6801f, 64.6217f, 64.5888f, 64.5831f, 64.602f, 64.6294f },
+        { 66.0336f, 65.8903f, 65.747f, 65.604f, 65.4624f, 65.3259f, 65.2016f, 65.0922f, 64.9879f, 64.8868f, 64.7945f, 64.7205f, 64.6724f, 64.6493f, 64.6422f, 64.6398f },
+    },
+    { // 20 C
+        { 58.9268f, 58.8157f, 58.7094f, 58.6085f, 58.5051f, 58.3849f, 58.228f, 58.0192f, 57.7537f, 57.4385f, 57.1049f, 56.8236f, 56.7772f, 57.3032f, 58.7281f, 60.6196f },
+        { 59.451f, 59.3668f, 59.2865f, 59.2125f, 59.1394f, 59.0579f, 58.9575f, 58.8332f, 58.6869f, 58.5445f, 58.4411f, 58.42f, 58.5854f, 59.0995f, 60.1713f, 61.558f },
+        { 59.972f, 59.9191f, 59.8665f, 59.8163f, 59.769f, 59.7213f, 59.6728f, 59.6244f, 59.5834f, 59.5838f, 59.645f, 59.7986f, 60.0621f, 60.4745f, 61.1499f, 62.1126f },
+        { 60.4846f, 60.4584f, 60.4292f, 60.3976f, 60.3722f, 60.3542f, 60.3486f, 60.3578f, 60.392f, 60.4748f, 60.612f, 60.7981f, 61.0145f, 61.2792f, 61.7021f, 62.3716f },
+        { 60.9851f, 60.9695f, 60.9528f, 60.9356f, 60.927f, 60.9331f, 60.959f, 61.0057f, 61.0777f, 61.1855f, 61.3234f, 61.4673f, 61.6003f, 61.7581f, 62.053f, 62.5443f },
+        { 61.4726f, 61.455f, 61.439f, 61.428f, 61.4285f, 61.4469f, 61.4868f, 61.5469f, 61.6261f, 61.7205f, 61.8185f, 61.904f, 61.976f, 62.0792f, 62.3049f, 62.6745f },
+        { 61.9469f, 61.9202f, 61.8957f, 61.8793f, 61.8774f, 61.8944f, 61.9313f, 61.9842f, 62.0461f, 62.1074f, 62.1591f, 62.1982f, 62.2356f, 62.3112f, 62.4873f, 62.7603f },
+        { 62.4111f, 62.3681f, 62.3274f, 62.2951f, 62.2785f, 62.2808f, 62.2996f, 62.329f, 62.3601f, 62.3837f, 62.3962f, 62.4043f, 62.4243f, 62.4841f, 62.6179f, 62.8118f },
+        { 62.8698f, 62.8037f, 62.7396f, 62.6827f, 62.6406f, 62.6164f, 62.6064f, 62.6031f, 62.5982f, 62.5858f, 62.5678f, 62.5546f, 62.5628f, 62.6089f, 62.7048f, 62.8322f },
+        { 63.3265f, 63.2331f, 63.1412f, 63.054f, 62.9768f, 62.9156f, 62.8695f, 62.8306f, 62.7903f, 62.7457f, 62.7016f, 62.6707f, 62.6666f, 62.6971f, 62.7613f, 62.8391f },
+        { 63.7828f, 63.6601f, 63.538f, 63.4178f, 63.3023f, 63.1958f, 63.108f, 63.0326f, 62.959f, 62.8853f, 62.8177f, 62.7686f, 62.7494f, 62.7625f, 62.7992f, 62.8411f },
+        { 64.2394f, 64.0865f, 63.9332f, 63.7792f, 63.6257f, 63.4772f, 63.3411f, 63.226f, 63.1192f, 63.0179f, 62.9287f, 62.8636f, 62.8284f, 62.8219f, 62.8301f, 62.8409f },
+    },
+    { // 30 C
+        { 56.8917f, 56.767f, 56.6443f, 56.5242f, 56.4051f, 56.2831f, 56.1288f, 55.923f, 55.6546f, 55.3349f, 55.0171f, 54.8166f, 54.9987f, 56.0086f, 57.8371f, 59.8723f },
+        { 57.4217f, 57.3313f, 57.242f, 57.1551f, 57.0716f, 56.9952f, 56.9026f, 56.7925f, 56.664f, 56.5419f, 56.4744f, 56.5253f, 56.8416f, 57.6625f, 59.0194f, 60.4624f },
+        { 57.9496f, 57.8944f, 57.8372f, 57.7836f, 57.7381f, 57.7009f, 57.6657f, 57.6365f, 57.626f, 57.6602f, 57.7661f, 57.9693f, 58.3096f, 58.8672f, 59.7712f, 60.8466f },
+        { 58.4725f, 58.4443f, 58.4158f, 58.3903f, 58.3748f, 58.3725f, 58.385f, 58.4165f, 58.4837f, 58.6005f, 58.7682f, 58.9783f, 59.2212f, 59.5684f, 60.1851f, 60.9961f },
+        { 58.9889f, 58.9759f, 58.9645f, 58.9583f, 58.9633f, 58.9844f, 59.0289f, 59.0982f, 59.199f, 59.331f, 59.481f, 59.6278f, 59.7759f, 60.0071f, 60.4578f, 61.0602f },
+        { 59.4976f, 59.4875f, 59.4799f, 59.48f, 59.4935f, 59.5262f, 59.5834f, 59.6639f, 59.7617f, 59.868f, 59.9666f, 60.0509f, 60.1424f, 60.3141f, 60.6544f, 61.0977f },
+        { 59.9981f, 59.9802f, 59.9649f, 59.9585f, 59.9676f, 59.9968f, 60.0475f, 60.1148f, 60.185f, 60.2497f, 60.3007f, 60.3418f, 60.4026f, 60.5388f, 60.7987f, 61.1155f },
+        { 60.491f, 60.4557f, 60.4232f, 60.3983f, 60.3898f, 60.4006f, 60.428f, 60.4643f, 60.4986f, 60.523f, 60.5374f, 60.5529f, 60.5959f, 60.7035f, 60.8956f, 61.1157f },
+        { 60.9797f, 60.9185f, 60.8592f, 60.8063f, 60.7682f, 60.7487f, 60.7424f, 60.741f, 60.7367f, 60.7257f, 60.7125f, 60.7108f, 60.7404f, 60.8219f, 60.9549f, 61.1015f },
+        { 61.4674f, 61.375f, 61.2835f, 61.1956f, 61.1167f, 61.0578f, 61.0112f, 60.9702f, 60.9289f, 60.8868f, 60.8502f, 60.8323f, 60.8473f, 60.9042f, 60.9903f, 61.0824f },
+        { 61.9555f, 61.8289f, 61.7024f, 61.5773f, 61.4571f, 61.348f, 61.2544f, 61.1734f, 61.0971f, 61.0259f, 60.9668f, 60.9311f, 60.9288f, 60.962f, 61.0109f, 61.0627f },
+        { 62.444f, 62.2823f, 62.1196f, 61.9559f, 61.7927f, 61.6349f, 61.4915f, 61.3679f, 61.2565f, 61.1559f, 61.074f, 61.0204f, 60.9996f, 61.0074f, 61.025f, 61.043f },
+    },
+    { // 40 C
+        { 54.856f, 54.7199f, 54.583f, 54.4469f, 54.3167f, 54.1853f, 54.0246f, 53.816f, 53.5499f, 53.2491f, 52.9963f, 52.9725f, 53.5156f, 55.0088f, 57.0084f, 59.0843f },
+        { 55.3926f, 55.2962f, 55.1984f, 55.1013f, 55.0156f, 54.9387f, 54.8493f, 54.7519f, 54.6473f, 54.5628f, 54.5543f, 54.7277f, 55.2716f, 56.4347f, 57.9093f, 59.369f },
+        { 55.9283f, 55.8695f, 55.8106f, 55.7563f, 55.7142f, 55.6853f, 55.662f, 55.6565f, 55.6844f, 55.7691f, 55.9307f, 56.1993f, 56.6498f, 57.418f, 58.4849f, 59.5612f },
+        { 56.4625f, 56.4345f, 56.4083f, 56.3887f, 56.3818f, 56.3926f, 56.4239f, 56.4856f, 56.592f, 56.7509f, 56.9525f, 57.1862f, 57.488f, 57.9854f, 58.768f, 59.615f },
+        { 56.9956f, 56.9869f, 56.9814f, 56.9847f, 57.0015f, 57.0377f, 57.1033f, 57.2006f, 57.3322f, 57.4913f, 57.653f, 57.8098f, 58.0042f, 58.3579f, 58.9416f, 59.5928f },
+        { 57.5267f, 57.5241f, 57.5244f, 57.5347f, 57.5608f, 57.6083f, 57.6829f, 57.7836f, 57.9019f, 58.0234f, 58.1257f, 58.2185f, 58.3535f, 58.6304f, 59.0684f, 59.5483f },
+        { 58.0536f, 58.0442f, 58.0362f, 58.0394f, 58.0598f, 58.1012f, 58.1644f, 58.2441f, 58.3257f, 58.3975f, 58.4529f, 58.5072f, 58.6092f, 58.8276f, 59.1537f, 59.4987f },
+        { 58.5725f, 58.5443f, 58.5188f, 58.5024f, 58.5027f, 58.5219f, 58.557f, 58.5999f, 58.6396f, 58.6686f, 58.6904f, 58.7237f, 58.8048f, 58.9719f, 59.2053f, 59.4466f },
+        { 59.0894f, 59.0332f, 58.979f, 58.9309f, 58.8979f, 58.8829f, 58.8798f, 58.8807f, 58.8789f, 58.873f, 58.8705f, 58.8885f, 58.9503f, 59.0733f, 59.2315f, 59.3937f },
+        { 59.6073f, 59.5165f, 59.4264f, 59.3393f, 59.2608f, 59.2023f, 59.1553f, 59.1131f, 59.0727f, 59.0362f, 59.0125f, 59.014f, 59.055f, 59.1384f, 59.2393f, 59.3424f },
+        { 60.1269f, 59.9973f, 59.8676f, 59.7385f, 59.6142f, 59.5023f, 59.4048f, 59.3192f, 59.2419f, 59.1761f, 59.13f, 59.1124f, 59.1311f, 59.1797f, 59.2362f, 59.2935f },
+        { 60.6473f, 60.4776f, 60.3068f, 60.1343f, 59.9622f, 59.796f, 59.6452f, 59.5155f, 59.4018f, 59.3058f, 59.236f, 59.1969f, 59.1907f, 59.2077f, 59.2279f, 59.2461f },
+    },
+    { // 50 C
+        { 52.8174f, 52.6748f, 52.5293f, 52.3811f, 52.2398f, 52.0924f, 51.916f, 51.6997f, 51.4482f, 51.2045f, 51.0907f, 51.3471f, 52.3668f, 54.1706f, 56.1999f, 58.2547f },
+        { 53.3623f, 53.2643f, 53.1625f, 53.058f, 52.9707f, 52.8893f, 52.8003f, 52.7126f, 52.6402f, 52.6157f, 52.7066f, 53.0613f, 53.9346f, 55.3363f, 56.8077f, 58.2891f },
+        { 53.908f, 53.8517f, 53.7946f, 53.7406f, 53.6992f, 53.6722f, 53.6618f, 53.6834f, 53.7579f, 53.9063f, 54.1324f, 54.4995f, 55.1276f, 56.1104f, 57.2167f, 58.296f },
+        { 54.4552f, 54.4329f, 54.4124f, 54.3983f, 54.3967f, 54.4156f, 54.465f, 54.5601f, 54.713f, 54.9207f, 55.1586f, 55.44f, 55.8537f, 56.5376f, 57.3955f, 58.2429f },
+        { 55.0051f, 55.0044f, 55.0071f, 55.0187f, 55.0456f, 55.0952f, 55.1791f, 55.3063f, 55.4731f, 55.6612f, 55.8438f, 56.0315f, 56.3144f, 56.8197f, 57.4748f, 58.1418f },
+        { 55.5576f, 55.564f, 55.5733f, 55.5939f, 55.6325f, 55.6939f, 55.7846f, 55.9054f, 56.0448f, 56.1831f, 56.3018f, 56.4242f, 56.6327f, 57.0252f, 57.522f, 58.0245f },
+        { 56.109f, 56.1088f, 56.1092f, 56.1224f, 56.1544f, 56.2078f, 56.2826f, 56.3733f, 56.4674f, 56.5517f, 56.6231f, 56.7093f, 56.875f, 57.1804f, 57.5442f, 57.9092f },
+        { 56.6534f, 56.6331f, 56.6155f, 56.6083f, 56.6175f, 56.6448f, 56.6869f, 56.736f, 56.7831f, 56.8232f, 56.8621f, 56.9272f, 57.0623f, 57.2904f, 57.546f, 57.802f },
+        { 57.198f, 57.1476f, 57.0997f, 57.059f, 57.0314f, 57.0193f, 57.0186f, 57.0223f, 57.0256f, 57.0304f, 57.0466f, 57.0943f, 57.1987f, 57.361f, 57.5323f, 57.7042f },
+        { 57.746f, 57.6576f, 57.5703f, 57.4864f, 57.4106f, 57.3491f, 57.3014f, 57.2594f, 57.2223f, 57.1959f, 57.1914f, 57.2203f, 57.2944f, 57.4004f, 57.5072f, 57.6146f },
+        { 58.297f, 58.1655f, 58.0338f, 57.9022f, 57.7737f, 57.6556f, 57.5563f, 57.4695f, 57.3945f, 57.338f, 57.3098f, 57.3158f, 57.358f, 57.417f, 57.4743f, 57.5307f },
+        { 58.8494f, 58.6728f, 58.4948f, 58.3145f, 58.1337f, 57.9579f, 57.798f, 57.6686f, 57.5572f, 57.4697f, 57.4157f, 57.3976f, 57.4059f, 57.4232f, 57.4379f, 57.4495f },
+    },
+    { // 60 C
+        { 50.7757f, 50.6327f, 50.4862f, 50.334f, 50.1754f, 50.0002f, 49.7985f, 49.5742f, 49.3568f, 49.2247f, 49.3418f, 49.9798f, 51.4375f, 53.3601f, 55.3795f, 57.3987f },
+        { 51.3299f, 51.2373f, 51.1404f, 51.0387f, 50.9398f, 50.8419f, 50.7458f, 50.6663f, 50.6326f, 50.6932f, 50.9446f, 51.567f, 52.7715f, 54.2535f, 55.7257f, 57.2234f },
+        { 51.8886f, 51.8423f, 51.7926f, 51.7409f, 51.6952f, 51.6656f, 51.6641f, 51.7065f, 51.8242f, 52.0399f, 52.3761f, 52.9004f, 53.7457f, 54.8627f, 55.9582f, 57.0559f },
+        { 52.4501f, 52.4391f, 52.4285f, 52.4207f, 52.4215f, 52.4473f, 52.5106f, 52.6321f, 52.8265f, 53.0864f, 53.3866f, 53.7629f, 54.3365f, 55.1703f, 56.0357f, 56.8842f },
+        { 53.0161f, 53.027f, 53.0412f, 53.063f, 53.0979f, 53.159f, 53.259f, 53.4119f, 53.6086f, 53.8305f, 54.0524f, 54.3115f, 54.7226f, 55.3541f, 56.0303f, 56.6997f },
+        { 53.5879f, 53.6054f, 53.6259f, 53.6577f, 53.7084f, 53.7825f, 53.888f, 54.027f, 54.1866f, 54.347f, 54.4986f, 54.6833f, 55.0001f, 55.485f, 55.9985f, 56.5121f },
+        { 54.1621f, 54.1719f, 54.1828f, 54.2071f, 54.2506f, 54.3154f, 54.4017f, 54.5036f, 54.6106f, 54.713f, 54.8159f, 54.9595f, 55.2126f, 55.5792f, 55.9557f, 56.3338f },
+        { 54.7321f, 54.7207f, 54.7125f, 54.7149f, 54.7332f, 54.7686f, 54.8177f, 54.8732f, 54.9295f, 54.9867f, 55.0563f, 55.1713f, 55.3721f, 55.6385f, 55.9045f, 56.1714f },
+        { 55.3053f, 55.2616f, 55.2208f, 55.1874f, 55.1656f, 55.1569f, 55.1587f, 55.1659f, 55.1767f, 55.1979f, 55.2425f, 55.332f, 55.4842f, 55.668f, 55.8474f, 56.026f },
+        { 55.8837f, 55.7985f, 55.7147f, 55.6345f, 55.5611f, 55.4988f, 55.4495f, 55.4086f, 55.3782f, 55.3673f, 55.3881f, 55.4514f, 55.5594f, 55.6757f, 55.7855f, 55.8943f },
+        { 56.4663f, 56.3336f, 56.2006f, 56.0676f, 55.9366f, 55.8147f, 55.7122f, 55.6248f, 55.5556f, 55.5127f, 55.507f, 55.5416f, 55.6049f, 55.6658f, 55.7199f, 55.7716f },
+        { 57.0506f, 56.8679f, 56.6835f, 56.4964f, 56.3087f, 56.1271f, 55.9637f, 55.8299f, 55.7228f, 55.6489f, 55.6156f, 55.6196f, 55.6367f, 55.648f, 55.6523f, 55.6529f },
+    },
+    { // 70 C
+        { 48.7328f, 48.5928f, 48.4481f, 48.291f, 48.1126f, 47.9061f, 47.675f, 47.4438f, 47.2782f, 47.3094f, 47.7412f, 48.8096f, 50.5557f, 52.5377f, 54.5449f, 56.5331f },
+        { 49.2986f, 49.2145f, 49.1249f, 49.024f, 48.9108f, 48.7928f, 48.6838f, 48.6112f, 48.6243f, 48.7962f, 49.2655f, 50.2025f, 51.6233f, 53.138f, 54.6488f, 56.1679f },
+        { 49.8702f, 49.8368f, 49.7978f, 49.7506f, 49.6973f, 49.66f, 49.6576f, 49.7159f, 49.8676f, 50.1503f, 50.6233f, 51.365f, 52.4217f, 53.585f, 54.704f, 55.8311f },
+        { 50.4459f, 50.449f, 50.4513f, 50.4521f, 50.4517f, 50.4809f, 50.555f, 50.6954f, 50.9146f, 51.2161f, 51.6063f, 52.1419f, 52.9059f, 53.8092f, 54.6767f, 55.5328f },
+        { 51.0274f, 51.052f, 51.0797f, 51.1121f, 51.1511f, 51.2229f, 51.3399f, 51.5118f, 51.7275f, 51.9818f, 52.2675f, 52.6474f, 53.213f, 53.9089f, 54.5911f, 55.2598f },
+        { 51.6163f, 51.6464f, 51.68f, 51.7231f, 51.7827f, 51.8699f, 51.9915f, 52.1462f, 52.3224f, 52.5086f, 52.7124f, 52.9948f, 53.429f, 53.9608f, 54.4844f, 55.0027f },
+        { 52.2109f, 52.2318f, 52.2562f, 52.2923f, 52.3467f, 52.423f, 52.5207f, 52.6335f, 52.7538f, 52.8798f, 53.0297f, 53.2527f, 53.5905f, 53.985f, 54.3751f, 54.7635f },
+        { 52.8086f, 52.8069f, 52.8091f, 52.8216f, 52.8491f, 52.8925f, 52.9486f, 53.0106f, 53.0773f, 53.157f, 53.2692f, 53.448f, 53.7083f, 53.992f, 54.2695f, 54.5463f },
+        { 53.4117f, 53.3752f, 53.3418f, 53.3155f, 53.2997f, 53.2951f, 53.2995f, 53.3101f, 53.33f, 53.3717f, 53.4527f, 53.5914f, 53.7869f, 53.9817f, 54.1676f, 54.3521f },
+        { 54.0211f, 53.9395f, 53.8593f, 53.7827f, 53.7122f, 53.6505f, 53.5993f, 53.5597f, 53.5381f, 53.546f, 53.5969f, 53.6978f, 53.8349f, 53.9558f, 54.0675f, 54.1769f },
+        { 54.6352f, 54.5015f, 54.3677f, 54.2339f, 54.1026f, 53.9794f, 53.8711f, 53.7828f, 53.7215f, 53.6968f, 53.7173f, 53.78f, 53.8582f, 53.9183f, 53.968f, 54.014f },
+        { 55.2515f, 55.0628f, 54.8724f, 54.6794f, 54.4861f, 54.2996f, 54.1315f, 53.9951f, 53.8949f, 53.84f, 53.83f, 53.851f, 53.871f, 53.8755f, 53.8683f, 53.8562f },
+    },
+};
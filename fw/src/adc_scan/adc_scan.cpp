@@ -0,0 +1,400 @@
+/**
+ * @file adc_scan.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Continuous or PWM triggered, optionally oversampled, ADC scan into
+ *        a circular DMA buffer.
+ * @version 0.1
+ * @date 2023-09-08
+ * @copyright Copyright (c) 2023
+ */
+
+/** General imports. */
+#include "mbed.h"
+#include "pinmap.h"
+#include "PeripheralPins.h"
+
+/** Device Specific imports. */
+#include "./adc_scan.hpp"
+
+
+/** @brief Sample time of the pins, and of VREFINT (SMPR codes). */
+#define ADC_SCAN_SAMPLE_TIME 4 // 47.5 ADC clock cycles.
+#define ADC_SCAN_VREF_SAMPLE_TIME 5 // 92.5 ADC clock cycles, 4.6 us.
+
+/** @brief ADC clock divider from HCLK, CKMODE = 0b11. */
+#define ADC_SCAN_CLOCK_DIVIDER 4
+
+/** @brief ADC channel of VREFINT. */
+#define ADC_SCAN_VREF_CHANNEL 0
+
+/** @brief Regular trigger of ADC1 from TIM2_TRGO (EXTSEL). */
+#define ADC_SCAN_EXTSEL_TIM2_TRGO 11
+
+static const float sampleCycles[8] = { 2.5f, 6.5f, 12.5f, 24.5f, 47.5f, 92.5f, 247.5f, 640.5f };
+
+static uint16_t buffer[2 * ADC_SCAN_BLOCK_MAX * ADC_SCAN_LENGTH_MAX];
+static float means[ADC_SCAN_LENGTH_MAX];
+static uint8_t length = 0;
+static uint8_t slots = 0;
+static uint8_t scans = 0;
+static float rate = 0.0f;
+static volatile float vdda = ADC_SCAN_VDDA_NOMINAL;
+
+/** @brief ADC clock cycles of a scan, and the PWM period if triggered (s). */
+static float cycles = 0.0f;
+static float period = 0.0f;
+
+/** @brief Oversampling ratio and right shift, and the resulting full scale. */
+static uint16_t ratio = 1;
+static uint8_t shift = 0;
+static float fullScale = 4095.0f;
+
+static void (*blockCallback)(const float * means) = nullptr;
+
+/** @brief Slot of every rank of the sequence, and the ranks of every slot. */
+static uint8_t rankSlot[ADC_SCAN_LENGTH_MAX];
+static uint8_t slotRanks[ADC_SCAN_LENGTH_MAX];
+
+/** @brief Trigger mode, and the compare value loaded after every trigger. */
+static enum AdcScanTrigger trigger = ADC_TRIGGER_CONTINUOUS;
+static TIM_TypeDef * timer = nullptr;
+static volatile uint32_t compares[ADC_SCAN_LENGTH_MAX * ADC_SCAN_TRIGGERED_RATIO_MAX];
+
+static void AdcScanISR(void) {
+    uint32_t flags = DMA1->ISR;
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+
+    /* If both flags are set the ISR ran late; the second half is newer. */
+    const uint16_t * half;
+    if (flags & DMA_ISR_TCIF1) half = &buffer[scans * length];
+    else if (flags & DMA_ISR_HTIF1) half = &buffer[0];
+    else return;
+
+    uint32_t sums[ADC_SCAN_LENGTH_MAX] = { 0 };
+    for (uint8_t scan = 0; scan < scans; ++scan) {
+        for (uint8_t rank = 0; rank < length; ++rank) sums[rankSlot[rank]] += half[scan * length + rank];
+    }
+    for (uint8_t slot = 0; slot < slots; ++slot) {
+        means[slot] = sums[slot] / (fullScale * scans * slotRanks[slot]);
+    }
+
+    /* VREFINT is the last slot; refer the pins to the nominal supply. */
+    if (means[slots - 1] > 0.0f) {
+        vdda = (float) VREFINT_CAL_VREF / 1000.0f * *VREFINT_CAL_ADDR / (4095.0f * means[slots - 1]);
+    }
+    float scale = vdda / ADC_SCAN_VDDA_NOMINAL;
+    for (uint8_t slot = 0; slot + 1 < slots; ++slot) means[slot] *= scale;
+    blockCallback(means);
+}
+
+/** Sets the sample time of an ADC channel. */
+static void AdcScanSampleTime(uint32_t channel, uint32_t code) {
+    if (channel < 10) {
+        ADC1->SMPR1 = (ADC1->SMPR1 & ~(0x7UL << (3 * channel))) | (code << (3 * channel));
+    } else {
+        channel -= 10;
+        ADC1->SMPR2 = (ADC1->SMPR2 & ~(0x7UL << (3 * channel))) | (code << (3 * channel));
+    }
+}
+
+/** Places an ADC channel at `rank` (0 based) of the regular sequence. */
+static void AdcScanSequence(uint8_t rank, uint32_t channel, uint8_t slot) {
+    /* SQ1 to SQ4 follow L in SQR1; SQR2 to SQR4 hold five ranks each. */
+    volatile uint32_t * sqr;
+    uint32_t shift;
+    if (rank < 4) {
+        sqr = &ADC1->SQR1;
+        shift = 6 * (rank + 1);
+    } else {
+        volatile uint32_t * registers[3] = { &ADC1->SQR2, &ADC1->SQR3, &ADC1->SQR4 };
+        sqr = registers[(rank - 4) / 5];
+        shift = 6 * ((rank - 4) % 5);
+    }
+    *sqr = (*sqr & ~(0x1FUL << shift)) | (channel << shift);
+    rankSlot[rank] = slot;
+    ++slotRanks[slot];
+}
+
+/** Triggers per scan; each oversampled conversion takes one if triggered. */
+static uint16_t AdcScanTriggers(void) {
+    return length * (timer != nullptr ? ratio : 1);
+}
+
+/** Updates the rate of the blocks. */
+static void AdcScanUpdateRate(void) {
+    /* Triggered at one point, a scan takes a PWM period per rank. At both, a
+       period per pair of ranks, and a whole one for VREFINT. */
+    if (timer == nullptr) {
+        rate = (float) SystemCoreClock / ADC_SCAN_CLOCK_DIVIDER / (cycles * ratio * scans);
+    } else {
+        uint8_t periods = trigger == ADC_TRIGGER_BOTH ? (length + 1) / 2 : length;
+        rate = 1.0f / (period * periods * ratio * scans);
+    }
+}
+
+/** Configures TIM2 channel 4 to trigger a conversion at every compare match. */
+static void AdcScanTimerInit(void) {
+    /* Toggle OC4REF on every match, without preload so that the DMA can load
+       the next compare value as soon as one matched, and keep it off the pin.
+       Both edges of OC4REF, as TRGO, trigger a conversion. */
+    timer->CCER &= ~TIM_CCER_CC4E;
+    timer->CCMR2 = (timer->CCMR2 & ~(TIM_CCMR2_CC4S | TIM_CCMR2_OC4M | TIM_CCMR2_OC4PE)) |
+        TIM_CCMR2_OC4M_0 | TIM_CCMR2_OC4M_1;
+    timer->CR2 = (timer->CR2 & ~TIM_CR2_MMS) | TIM_CR2_MMS_0 | TIM_CR2_MMS_1 | TIM_CR2_MMS_2;
+
+    /* DMA1 channel 7, request 4 is TIM2_CH4. Channel 1, with TIM2_CH3, is
+       taken by the ADC. */
+    DMA1_Channel7->CCR = 0;
+    DMA1_CSELR->CSELR = (DMA1_CSELR->CSELR & ~DMA_CSELR_C7S) | (4UL << DMA_CSELR_C7S_Pos);
+    DMA1_Channel7->CPAR = (uint32_t) &timer->CCR4;
+    DMA1_Channel7->CMAR = (uint32_t) compares;
+    DMA1_Channel7->CNDTR = AdcScanTriggers();
+    DMA1_Channel7->CCR =
+        DMA_CCR_PL_1 | DMA_CCR_MSIZE_1 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_DIR;
+}
+
+bool AdcScanInit(
+    const PinName * pins,
+    uint8_t count,
+    uint32_t centered,
+    uint8_t block,
+    enum AdcScanTrigger mode,
+    PinName pwm,
+    void (*callback)(const float * means),
+    uint32_t priority
+) {
+    /* A centered pin needs a pin after it, which is not centered itself, and
+       costs one more rank unless both trigger points already convert it
+       twice. */
+    uint8_t extra = 0;
+    if (count < 32 && (centered >> count) != 0) return false;
+    for (uint8_t k = 0; k < count; ++k) {
+        if (!(centered & (1UL << k))) continue;
+        if (k + 1 >= count || (centered & (1UL << (k + 1)))) return false;
+        ++extra;
+        ++k;
+    }
+
+    /* Both trigger points convert every pin twice, and VREFINT once. */
+    uint8_t ranks = mode == ADC_TRIGGER_BOTH ? 2 * count + 1 : count + extra + 1;
+    if (count == 0 || ranks > ADC_SCAN_LENGTH_MAX || block == 0 || block > ADC_SCAN_BLOCK_MAX) return false;
+    for (uint8_t k = 0; k < count; ++k) {
+        if ((ADC_TypeDef *) pinmap_peripheral(pins[k], PinMap_ADC) != ADC1) return false;
+    }
+    timer = nullptr;
+    if (mode != ADC_TRIGGER_CONTINUOUS) {
+        timer = (TIM_TypeDef *) pinmap_peripheral(pwm, PinMap_PWM);
+        if (timer != TIM2) {
+            timer = nullptr;
+            return false;
+        }
+    }
+
+    length = ranks;
+    slots = count + 1;
+    scans = block;
+    ratio = 1;
+    shift = 0;
+    fullScale = 4095.0f;
+    trigger = mode;
+    blockCallback = callback;
+
+    RCC->AHB2ENR |= RCC_AHB2ENR_ADCEN;
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+
+    /* Take the ADC back from the HAL, if an AnalogIn ever enabled it. */
+    if (ADC1->CR & ADC_CR_ADSTART) {
+        ADC1->CR |= ADC_CR_ADSTP;
+        while (ADC1->CR & ADC_CR_ADSTART) { }
+    }
+    if (ADC1->CR & ADC_CR_ADEN) {
+        ADC1->CR |= ADC_CR_ADDIS;
+        while (ADC1->CR & ADC_CR_ADEN) { }
+    }
+
+    /* Synchronous clock at HCLK / 4, and VREFINT. Leave deep power down,
+       start the regulator, and calibrate for single ended inputs. */
+    ADC1_COMMON->CCR |= ADC_CCR_CKMODE | ADC_CCR_VREFEN;
+    ADC1->CR &= ~ADC_CR_DEEPPWD;
+    ADC1->CR |= ADC_CR_ADVREGEN;
+    wait_us(20);
+    ADC1->CR &= ~ADC_CR_ADCALDIF;
+    ADC1->CR |= ADC_CR_ADCAL;
+    while (ADC1->CR & ADC_CR_ADCAL) { }
+
+    /* 12 bit, right aligned, circular DMA, and overwrite on overrun, so a
+       late DMA never stalls the scan. Either continuous, or one conversion
+       per trigger on both edges of TIM2_TRGO. */
+    if (mode == ADC_TRIGGER_CONTINUOUS) {
+        ADC1->CFGR = ADC_CFGR_CONT | ADC_CFGR_DMACFG | ADC_CFGR_DMAEN | ADC_CFGR_OVRMOD;
+    } else {
+        ADC1->CFGR =
+            ADC_CFGR_DISCEN | ADC_CFGR_EXTEN_0 | ADC_CFGR_EXTEN_1 |
+            ((uint32_t) ADC_SCAN_EXTSEL_TIM2_TRGO << ADC_CFGR_EXTSEL_Pos) |
+            ADC_CFGR_DMACFG | ADC_CFGR_DMAEN | ADC_CFGR_OVRMOD;
+    }
+    ADC1->SQR1 = (uint32_t) (length - 1) << ADC_SQR1_L_Pos;
+    for (uint8_t slot = 0; slot < slots; ++slot) slotRanks[slot] = 0;
+    uint32_t channels[ADC_SCAN_LENGTH_MAX];
+    for (uint8_t k = 0; k < count; ++k) {
+        pinmap_pinout(pins[k], PinMap_ADC);
+        channels[k] = STM_PIN_CHANNEL(pinmap_function(pins[k], PinMap_ADC));
+        AdcScanSampleTime(channels[k], ADC_SCAN_SAMPLE_TIME);
+    }
+
+    /* A centered pin brackets the next one, V-I-V, or V-I-I-V at both trigger
+       points so that the points still alternate between on and off. */
+    uint8_t rank = 0;
+    cycles = 0.0f;
+    for (uint8_t k = 0; k < count; ++k) {
+        uint8_t order[4] = { k, k, k, k };
+        uint8_t n = mode == ADC_TRIGGER_BOTH ? 2 : 1;
+        if (centered & (1UL << k)) {
+            order[1] = k + 1;
+            if (mode == ADC_TRIGGER_BOTH) order[2] = k + 1;
+            n = mode == ADC_TRIGGER_BOTH ? 4 : 3;
+            ++k;
+        }
+        for (uint8_t j = 0; j < n; ++j) {
+            AdcScanSequence(rank++, channels[order[j]], order[j]);
+            cycles += sampleCycles[ADC_SCAN_SAMPLE_TIME] + 12.5f;
+        }
+    }
+    AdcScanSampleTime(ADC_SCAN_VREF_CHANNEL, ADC_SCAN_VREF_SAMPLE_TIME);
+    AdcScanSequence(rank, ADC_SCAN_VREF_CHANNEL, count);
+    cycles += sampleCycles[ADC_SCAN_VREF_SAMPLE_TIME] + 12.5f;
+
+    ADC1->CFGR2 = 0;
+    if (mode != ADC_TRIGGER_CONTINUOUS) {
+        period = (float) (timer->PSC + 1) * (timer->ARR + 1) / SystemCoreClock;
+        AdcScanTimerInit();
+        AdcScanSetDuty(0.5f);
+    }
+    AdcScanUpdateRate();
+
+    ADC1->ISR = ADC_ISR_ADRDY;
+    ADC1->CR |= ADC_CR_ADEN;
+    while (!(ADC1->ISR & ADC_ISR_ADRDY)) { }
+
+    /* DMA1 channel 1, request 0 is ADC1. */
+    DMA1_Channel1->CCR = 0;
+    DMA1_CSELR->CSELR &= ~DMA_CSELR_C1S;
+    DMA1_Channel1->CPAR = (uint32_t) &ADC1->DR;
+    DMA1_Channel1->CMAR = (uint32_t) buffer;
+    DMA1_Channel1->CNDTR = 2 * scans * length;
+    DMA1_Channel1->CCR =
+        DMA_CCR_PL_1 | DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_0 | DMA_CCR_MINC | DMA_CCR_CIRC |
+        DMA_CCR_HTIE | DMA_CCR_TCIE;
+
+    NVIC_SetVector(DMA1_Channel1_IRQn, (uint32_t) &AdcScanISR);
+    NVIC_SetPriority(DMA1_Channel1_IRQn, priority);
+    return true;
+}
+
+void AdcScanSetDuty(float duty) {
+    if (timer == nullptr) return;
+    if (duty < 0.0f) duty = 0.0f;
+    if (duty > 1.0f) duty = 1.0f;
+
+    /* The pin is on from the update event until the compare of its channel,
+       so the middle of the on time is at duty / 2 of the period, and the
+       middle of the off time half a period later. Both keep the triggers
+       half a period apart, longer than any conversion but VREFINT's, which
+       is followed by a full period instead. */
+    uint32_t top = timer->ARR + 1;
+    uint32_t on = (uint32_t) (duty * 0.5f * top);
+    uint32_t off = on + top / 2;
+    if (off >= top) off = top - 1;
+
+    /* compares[k] is loaded by the DMA once trigger k matched, i.e. it is
+       the compare of trigger k + 1; CCR4 itself holds that of trigger 0.
+       Both alternates between the ranks of a pin; VREFINT, last, is even. */
+    uint16_t triggers = AdcScanTriggers();
+    uint16_t oversampled = triggers / length;
+    for (uint16_t k = 1; k <= triggers; ++k) {
+        uint8_t rank = (k % triggers) / oversampled;
+        bool late = trigger == ADC_TRIGGER_MID_OFF || (trigger == ADC_TRIGGER_BOTH && rank % 2 == 1);
+        compares[k - 1] = late ? off : on;
+    }
+    if (!(ADC1->CR & ADC_CR_ADSTART)) timer->CCR4 = trigger == ADC_TRIGGER_MID_OFF ? off : on;
+}
+
+bool AdcScanSetOversampling(uint16_t oversampling, uint8_t rightShift) {
+    if (length == 0 || (ADC1->CR & ADC_CR_ADSTART)) return false;
+
+    /* Ratios are powers of two from 2 (OVSR = 0) to 256 (OVSR = 7). */
+    uint8_t log2 = 0;
+    while ((1U << log2) < oversampling) ++log2;
+    if ((1U << log2) != oversampling || log2 > 8 || rightShift > 8 || rightShift > log2) return false;
+    if (log2 > rightShift + 4) return false;
+    if (timer != nullptr && oversampling > ADC_SCAN_TRIGGERED_RATIO_MAX) return false;
+
+    ratio = oversampling;
+    shift = rightShift;
+    fullScale = 4095.0f * (1U << (log2 - shift));
+    if (ratio == 1) {
+        ADC1->CFGR2 = 0;
+    } else {
+        ADC1->CFGR2 =
+            ADC_CFGR2_ROVSE | ((uint32_t) (log2 - 1) << ADC_CFGR2_OVSR_Pos) |
+            ((uint32_t) shift << ADC_CFGR2_OVSS_Pos);
+    }
+
+    if (timer != nullptr) {
+        /* Each oversampled conversion waits on its own trigger, at the point
+           of its rank; that already takes one conversion per trigger. */
+        if (ratio == 1) {
+            ADC1->CFGR |= ADC_CFGR_DISCEN;
+        } else {
+            ADC1->CFGR &= ~ADC_CFGR_DISCEN;
+            ADC1->CFGR2 |= ADC_CFGR2_TROVS;
+        }
+        DMA1_Channel7->CCR &= ~DMA_CCR_EN;
+        DMA1_Channel7->CNDTR = AdcScanTriggers();
+        AdcScanSetDuty(0.5f);
+    }
+    AdcScanUpdateRate();
+    return true;
+}
+
+void AdcScanStart(void) {
+    if (length == 0) return;
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    DMA1_Channel1->CCR |= DMA_CCR_EN;
+    NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+    ADC1->ISR = ADC_ISR_OVR;
+    if (timer != nullptr) {
+        DMA1_Channel7->CCR |= DMA_CCR_EN;
+        timer->DIER |= TIM_DIER_CC4DE;
+    }
+    ADC1->CR |= ADC_CR_ADSTART;
+}
+
+void AdcScanStop(void) {
+    if (length == 0) return;
+    ADC1->CR |= ADC_CR_ADSTP;
+    while (ADC1->CR & ADC_CR_ADSTART) { }
+    NVIC_DisableIRQ(DMA1_Channel1_IRQn);
+    DMA1_Channel1->CCR &= ~DMA_CCR_EN;
+    DMA1_Channel1->CNDTR = 2 * scans * length;
+    if (timer != nullptr) {
+        timer->DIER &= ~TIM_DIER_CC4DE;
+        DMA1_Channel7->CCR &= ~DMA_CCR_EN;
+        DMA1_Channel7->CNDTR = AdcScanTriggers();
+        timer->CCR4 = compares[AdcScanTriggers() - 1];
+    }
+}
+
+float AdcScanRate(void) { return rate; }
+
+float AdcScanResolution(void) {
+    /* White noise averages down by half a bit per doubling, until the bits
+       the shift dropped limit it. */
+    uint8_t log2 = 0;
+    while ((1U << log2) < ratio) ++log2;
+    float bits = 12.0f + 0.5f * log2;
+    float kept = 12.0f + log2 - shift;
+    return bits < kept ? bits : kept;
+}
+
+float AdcScanVdda(void) { return vdda; }
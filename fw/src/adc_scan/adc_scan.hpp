@@ -0,0 +1,198 @@
+/**
+ * @file adc_scan.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Converts a fixed sequence of ADC channels, optionally oversampled,
+ *        into a circular DMA buffer, continuously or at fixed points of the
+ *        PWM period, and hands every finished half of the buffer to a
+ *        callback as per channel block means.
+ * @version 0.1
+ * @date 2023-09-08
+ * @note For the STM32L432KC, which has the one ADC. The ADC channel of each
+ *       pin, and the timer of the PWM pin, are looked up from the mbed pinmap.
+ *       Replaces AnalogIn entirely; do not construct an AnalogIn while the
+ *       scan runs. The triggered scan takes over channel 4 of TIM2 and
+ *       DMA1 channel 7.
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include "mbed.h"
+
+
+/*
+The ADC converts the pins in order, followed by VREFINT. Every conversion is
+moved by DMA1 channel 1 into a circular buffer of two halves, each `block`
+scans long:
+
+    | scan 0 | scan 1 | ... | scan block-1 | scan 0 | ... | scan block-1 |
+    |<------------- half 0 -------------->|<---------- half 1 --------->|
+
+The half transfer and transfer complete interrupts fire whenever a half is
+full, while the DMA fills the other one. The ISR averages the half per slot
+and passes the means to the callback. No conversion is started or waited on
+by the CPU.
+
+Every pin is sampled for ADC_SCAN_SAMPLE_TIME, and VREFINT for its minimum of
+4 us. With the ADC clock at HCLK / 4 = 20 MHz, a conversion of a pin takes
+(47.5 + 12.5) / 20 MHz = 3 us, and VREFINT 5.25 us. VREFINT gives the actual
+analog supply of every block, see AdcScanVdda(). A conversion is a fraction
+of VDDA, which drifts with the regulator and the load on it; the ISR scales
+the means of the pins by VDDA / ADC_SCAN_VDDA_NOMINAL, so that they are
+fractions of the nominal supply like AnalogIn::read() at 3.3 V, and the
+sensor calibration holds whatever the actual supply.
+
+ADC_TRIGGER_CONTINUOUS restarts the sequence as soon as it ends, so samples
+land anywhere in the switching period, on the ripple and the switching noise.
+The other modes convert one rank per trigger, at a fixed point of the period
+of the timer behind the PWM pin:
+
+           +---------+                +---------+
+    pin    |         |                |         |
+        ---+         +----------------+         +---------
+    MID_ON      ^                          ^
+    MID_OFF                ^                          ^
+           0   D/2   D  (1 + D)/2     1
+
+The middle of either interval sits on the average of a triangular ripple,
+i.e. the average inductor current, and away from both switching edges.
+ADC_TRIGGER_BOTH converts every pin at both points and averages the two.
+Channel 4 of the timer toggles its reference at every compare match, which
+triggers the ADC on both edges through TRGO; DMA1 channel 7 loads the compare
+of the next rank at every match, so the points may differ between ranks. A
+scan takes one PWM period per rank, VREFINT included, or at both points one
+per pair of ranks plus one for VREFINT; the whole sequence cannot fit in one
+period at 3 us per conversion, but every conversion of it sits at its point.
+AdcScanSetDuty() moves the points with the duty cycle.
+
+AdcScanSetOversampling() has the ADC accumulate `ratio` conversions of every
+rank and shift the sum right, before the DMA moves a single result:
+
+    result = (x_0 + ... + x_{ratio-1}) >> shift
+
+The sum of 256 12 bit conversions takes 20 bits, and the data register 16, so
+the shift must drop at least log2(ratio) - 4 bits. Averaging in the ADC rather
+than over a block costs the CPU nothing, and white noise drops by half a bit
+per doubling of the ratio. The ratio and shift are shared by every rank; the
+oversampler of the STM32L4 has one setting for the regular sequence.
+Continuously, the ratio conversions of a rank follow back to back. Triggered,
+each takes a trigger of its own at the point of its rank, so a scan takes
+`ratio` times as many PWM periods; the DMA table of compares grows with it,
+hence ADC_SCAN_TRIGGERED_RATIO_MAX.
+
+Conversions in turn put the pins of a scan apart in time; a product of two of
+them, like the array power, is then biased wherever they move, on the ripple
+or after a step. A centered pin is converted on both sides of the next one,
+and its mean is that of both, centered on the conversion time of the other:
+
+    continuous, mid on, mid off:  V I V         (one more rank)
+    both:                         V_on I_off I_on V_off
+
+Both keeps the points alternating between on and off, at no extra rank. The
+bias before and after is quantified by the `skew` run of fw/tests/host_sim.
+*/
+
+/** @brief Maximum conversions in a scan, including VREFINT. */
+#define ADC_SCAN_LENGTH_MAX 16
+
+/** @brief Maximum scans in a block, i.e. half of the DMA buffer. */
+#define ADC_SCAN_BLOCK_MAX 16
+
+/** @brief Maximum oversampling ratio of the triggered modes. */
+#define ADC_SCAN_TRIGGERED_RATIO_MAX 16
+
+/** @brief Supply the means are referred to (V). */
+#define ADC_SCAN_VDDA_NOMINAL 3.3f
+
+/** @brief When conversions are triggered. */
+enum AdcScanTrigger { ADC_TRIGGER_CONTINUOUS, ADC_TRIGGER_MID_ON, ADC_TRIGGER_MID_OFF, ADC_TRIGGER_BOTH };
+
+/**
+ * @brief AdcScanInit configures the ADC to scan `pins` and VREFINT, and the
+ *        DMA to hand blocks to `callback`.
+ *
+ * @param pins     Analog pins, in the order of their slots in the means.
+ * @param count    Number of pins. At most ADC_SCAN_LENGTH_MAX - 1, less the
+ *                 centered pins, or half of it with ADC_TRIGGER_BOTH.
+ * @param centered Bit k set converts pins[k] on both sides of pins[k + 1], so
+ *                 that their means are aligned in time. pins[k + 1] must
+ *                 exist and not be centered itself.
+ * @param block    Scans averaged per callback. At most ADC_SCAN_BLOCK_MAX.
+ * @param trigger  When conversions are triggered.
+ * @param pwm      PWM pin, already configured by FastPWM, that paces the
+ *                 triggered modes. Must be on TIM2. Unused if continuous.
+ * @param callback Function to execute from the DMA ISR with the block means
+ *                 of every pin, as fractions of ADC_SCAN_VDDA_NOMINAL.
+ * @param priority Priority of the DMA ISR. Give it that of any ISR sharing
+ *                 data with the callback, so they cannot preempt each other.
+ * @return True if every pin is an ADC1 input, the centered pins are valid,
+ *         and the PWM pin is on TIM2.
+ * @note The callback executes in interrupt context once per block; keep it
+ *       short.
+ */
+bool AdcScanInit(
+    const PinName * pins,
+    uint8_t count,
+    uint32_t centered,
+    uint8_t block,
+    enum AdcScanTrigger trigger,
+    PinName pwm,
+    void (*callback)(const float * means),
+    uint32_t priority
+);
+
+/**
+ * @brief AdcScanSetDuty moves the trigger points with the duty cycle of the
+ *        PWM pin. Does nothing if continuous.
+ *
+ * @param duty Fraction of the period the PWM pin is on, as FastPWM::read().
+ * @note Call whenever the duty cycle changes; the DMA picks the new points up
+ *       from the next trigger.
+ */
+void AdcScanSetDuty(float duty);
+
+/**
+ * @brief AdcScanSetOversampling sets the hardware oversampling of every
+ *        conversion. Off, i.e. a ratio of 1, after AdcScanInit.
+ *
+ * @param ratio Conversions accumulated per result; 1, or a power of 2 up to
+ *              256, or ADC_SCAN_TRIGGERED_RATIO_MAX if triggered.
+ * @param shift Right shift of the accumulated sum, at most log2(ratio) and at
+ *              least log2(ratio) - 4.
+ * @return True if the ratio and shift are valid. False as well if the scan is
+ *         running; stop it first.
+ * @note The means passed to the callback remain fractions of
+ *       ADC_SCAN_VDDA_NOMINAL.
+ */
+bool AdcScanSetOversampling(uint16_t ratio, uint8_t shift);
+
+/** @brief AdcScanStart starts the conversions and the block callbacks. */
+void AdcScanStart(void);
+
+/** @brief AdcScanStop stops the conversions after the current one. */
+void AdcScanStop(void);
+
+/**
+ * @brief AdcScanRate returns the rate of the block callbacks.
+ *
+ * @return Blocks per second (Hz), or 0 before AdcScanInit.
+ */
+float AdcScanRate(void);
+
+/**
+ * @brief AdcScanResolution returns the effective resolution of the results,
+ *        i.e. 12 bits plus half a bit per doubling of the oversampling ratio,
+ *        bounded by the bits the shift keeps.
+ *
+ * @return Bits.
+ */
+float AdcScanResolution(void);
+
+/**
+ * @brief AdcScanVdda returns the analog supply, measured against the factory
+ *        calibration of VREFINT over the last block. The means of the pins
+ *        are already scaled by it.
+ *
+ * @return VDDA (V).
+ */
+float AdcScanVdda(void);
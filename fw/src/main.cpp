@@ -0,0 +1,859 @@
+/**
+ * @file main.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Main program for the Sunscatter. Runs a cascaded controller: a fast
+ *        inner inductor current loop synchronous to the PWM period, and a
+ *        decimated outer stage that generates its current reference. The
+ *        outer stage min-selects between the array voltage (MPPT) loop, the
+ *        battery CV limit and the battery charge current limit. A maximum
+ *        power point tracker drives the reference of the MPPT loop. Every
+ *        converter channel runs its own controller and tracker from the one
+ *        ISR.
+ * @version 0.1
+ * @date 2023-08-20
+ * @note For board revision v0.1.0. FastPWM is pulled in via lib/FastPWM.lib.
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "mbed.h"
+#include "FastPWM.h"
+#include "../inc/calibration/calibration_tables.hpp"
+#include "../inc/channel_control/channel_control.hpp"
+#include "../inc/fra/fra.hpp"
+#include "../inc/iv_tracer/iv_tracer.hpp"
+#include "./adc_scan/adc_scan.hpp"
+#include "./pwm_sync/pwm_sync.hpp"
+
+#define F_SW 104000.0 // 104 khz switching
+#define INNER_DECIMATION 10 // Inner loop runs at F_SW / 10 = 10.4 kHz.
+#define OUTER_DECIMATION 10 // Outer loop runs at F_SW / 100 = 1.04 kHz.
+#define ARR_V_TARGET 62.0 // V, initial array voltage setpoint.
+
+// Converter channels, each with its own array, PWM, sensors, controller,
+// limits and tracker. All PWM pins are channels of TIM2, so one update
+// interrupt paces every channel. The outer stages and the round robin sensor
+// reads of the channels are staggered across the inner loop ticks, so that no
+// tick runs more than one outer stage while NUM_CHANNELS <= OUTER_DECIMATION.
+// The channels share the battery: its voltage sensor, and BATT_I_CC split
+// evenly between them.
+#define NUM_CHANNELS 2
+
+// Every channel runs the sensing, control and tracking of
+// fw/inc/channel_control, which fw/tests/host_sim runs against its plant
+// models; the switches below only pick its ChannelOptions_t.
+
+// Maximum power point tracker. Runs every MPPT_DECIMATION outer loop ticks on
+// the array voltage and current averaged over the last MPPT_WINDOW outer loop
+// ticks, and drives the array voltage reference of the MPPT loop. Extremum
+// seeking instead runs every outer loop tick on the sensor filters. See
+// fw/tests/host_sim for their tracking efficiency and convergence time.
+// Strategies 1 to 4 are entries of MPPT_STRATEGIES; __MPPT__ picks the one to
+// start with, and sending its table index ('0' to '3') over the serial console
+// switches at runtime.
+#define __MPPT__ 1 // 0 to hold ARR_V_TARGET, 1 for perturb and observe, 2 for incremental conductance, 3 for extremum seeking, 4 for fractional V_oc.
+#define MPPT_STRATEGY (__MPPT__ >= 1 ? __MPPT__ - 1 : 0) // Initial MPPT_STRATEGIES index.
+#define MPPT_DECIMATION 50 // Averaging trackers run at F_SW / 5000 = 20.8 Hz.
+#define MPPT_WINDOW CHANNEL_MPPT_WINDOW // Outer loop ticks averaged, after the MPPT loop settles.
+#define ARR_V_MAX 68.0 // V, below the INP_OVL redline.
+#define ARR_V_MIN 20.0 // V
+
+// Global scan for partial shading. Sweeps the array across [ARR_V_MIN,
+// ARR_V_MAX] when tracking starts and every SCAN_INTERVAL outer loop ticks, and
+// hands the best point to the tracker. Only with the cascaded PI loops and a
+// voltage tracker. With the change detector, the averaging trackers scan when
+// it classifies a change as shading instead, and jump to the predicted MPP on
+// uniform changes; SCAN_BACKSTOP catches what it misses.
+#define __SCAN__ 1 // 0 to disable, 1 on a timer, 2 on detected changes.
+#define SCAN_INTERVAL ((uint32_t) (30.0 * F_SW / (INNER_DECIMATION * OUTER_DECIMATION))) // Outer loop ticks, 30 s.
+#define SCAN_BACKSTOP ((uint32_t) (600.0 * F_SW / (INNER_DECIMATION * OUTER_DECIMATION))) // Outer loop ticks, 10 min.
+#define SCAN_PERIOD (__SCAN__ == 2 ? SCAN_BACKSTOP : SCAN_INTERVAL)
+#define SCAN_ENERGY_CAP 6.0 // J, harvest lost per scan at most.
+#define ARR_VOC_COLD 76.0 // V, 100 cells at 0 C.
+#define ARR_SUBSTRINGS 5 // Bypass diode protected substrings.
+#define INPUT_CAPACITANCE 15E-6 // F, see docs/DESIGN.md.
+
+// Open circuit voltage measurements. The gate driver is disabled for at most
+// VOC_WINDOW inner loop ticks while the array settles to V_oc: after every
+// global scan, to learn k = V_mpp / V_oc and to give the predictor its
+// V_oc, and every VOC_INTERVAL tracker steps while fractional V_oc tracks
+// k V_oc.
+#define VOC_K 0.86 // Initial fraction of V_oc at the MPP, V_mpp / V_oc of the cell at STC.
+#define VOC_WINDOW 10 // Inner loop ticks, 0.96 ms.
+#define VOC_INTERVAL 21 // Tracker steps, ~1 s.
+#define VOC_HOLDOFF 52 // Inner loop ticks, 5 ms, without INP_OVL after a measurement.
+
+// Model based MPP prediction. When the irradiance estimated from the single
+// diode model of the array changes, the tracker jumps to the MPP of the model
+// and refines it from there. The MPP is either solved from the model, or
+// looked up in the table trained by sw/vmpp_table_design.py. The V_oc
+// measured after every global scan sets its cell temperature. Only with the
+// averaging trackers; the extremum seeking steps too often for a change
+// between steps to show.
+#define __PREDICT__ 1 // 0 to disable, 1 for the single diode solve, 2 for the trained table.
+#define ARR_CELLS 100 // See sw/design_files/design_specs.json.
+#define ARR_R_S 0.0035 // Ohms per cell. Refit to traced curves with sw/iv_fit.py.
+#define ARR_R_SH 40.0 // Ohms per cell. Refit to traced curves with sw/iv_fit.py.
+#define ARR_TEMPERATURE 318.15 // K, cell temperature estimate until the first V_oc measurement.
+
+// Tracking efficiency meter. Every METER_INTERVAL outer loop ticks, sweeps the
+// array voltage reference across METER_AMPLITUDE around the operating point in
+// METER_POINTS points, and streams the tracked power over the local maximum of
+// a parabola fit to P(V), and the offset of that maximum, with the telemetry.
+// The sweeps take the place of the tracker steps. EfficiencyMeterInit caps the
+// amplitude and spaces the sweeps out to bound the harvest lost. Only with the
+// voltage trackers.
+#define __METER__ 0 // 0 to disable, 1 to enable.
+#define METER_AMPLITUDE 1.5 // V
+#define METER_POINTS 5
+#define METER_SETTLE 16 // Outer loop ticks at each point before averaging.
+#define METER_AVERAGE 16 // Outer loop ticks averaged at each point.
+#define METER_INTERVAL ((uint32_t) (10.0 * F_SW / (INNER_DECIMATION * OUTER_DECIMATION))) // Outer loop ticks, 10 s.
+
+// Battery limits, INR21700-M50LT x32 in series.
+#define BATT_V_CV (4.0 * 32) // V, constant voltage limit. Below the OUT_OVL redline.
+#define BATT_I_CC 2.5 // A, charge current limit, ~0.5C, of all channels together.
+
+#define DUTY_MAX 0.90
+#define DUTY_MIN 0.10
+#define CURRENT_MAX 6.0 // A, overcurrent limit of the inductor.
+#define CURRENT_MIN 0.0 // A, no reverse current.
+
+// Array voltage controller. The explicit MPC replaces both loops of the
+// cascaded controller; the battery limiters of the arbiter still run and feed
+// it the inductor current limit. Regenerate fw/inc/mpc/mpc_table.hpp with
+// sw/mpc_design.py when the passives or INNER_DECIMATION change.
+#define __CONTROL__ 0 // 0 for the cascaded PI loops, 1 for the explicit MPC.
+
+// Frequency response analyzer. Sweeps once after tracking starts, then streams
+// the table out as binary. See sw/fra.py. The binary records of the FRA and the
+// tracer go out on stdio as is: fw/mbed_app.json turns off its conversion of
+// '\n' to "\r\n", which would corrupt every 0x0A byte of them.
+#define __FRA__ 0 // 0 to disable, 1 for the plant, 2 for the loop gain, 3 for the closed loop.
+#define FRA_SAMPLE_RATE (F_SW / INNER_DECIMATION)
+// The array voltage is sampled every tick while the FRA runs, round robin
+// included, and measured unfiltered; the sweep must stay below its Nyquist.
+#define FRA_ARR_V_RATE FRA_SAMPLE_RATE
+#define FRA_F_START 10.0
+#define FRA_F_STOP (__FRA__ == 3 ? 400.0 : 2000.0) // Reference is only applied at the outer rate.
+#define FRA_AMPLITUDE (__FRA__ == 3 ? 0.5 : 0.01) // V or duty.
+
+// I-V curve tracer. Traces the array of TRACE_CHANNEL once after tracking
+// starts, and whenever 't' is sent over the serial console: ramps the duty
+// from DUTY_MAX, near short circuit, down until the array current falls to
+// TRACE_I_STOP, then opens the array for V_oc, and streams the curve out as
+// binary. In full sun the lead in stops at TRACE_I_START instead, below the
+// current limit. See sw/iv_tracer.py.
+#define __TRACE__ 0 // 0 to disable, 1 to enable.
+#define TRACE_CHANNEL 0
+#define TRACE_POINTS 1000 // Samples of the sweep, 96 ms at F_SW / INNER_DECIMATION.
+#define TRACE_I_START 5.5 // A, below CURRENT_MAX and the sensor full scale.
+#define TRACE_I_STOP 0.05 // A
+#define TRACE_V_MAX 80.0 // V, aborts the trace.
+
+// Tracker benchmark. Steps every strategy of MPPT_STRATEGIES on a synthetic
+// array at startup and prints the cycles per step, from the DWT cycle counter,
+// then the cycles per prediction of the model predictor, solved and tabled.
+#define __BENCH__ 0 // 0 to disable, 1 to enable.
+#define BENCH_STEPS 1000
+
+// Sensing. The DMA scan converts every sensor of every channel, and the
+// battery voltage, in the background, and hands the means of every ADC_BLOCK
+// scans over to the control ISR, which then reads all of them every tick at no
+// cost. Otherwise the control ISR waits on one blocking AnalogIn conversion
+// after another, round robin. The scan either runs continuously, or triggers
+// every conversion at the middle of the on and/or off time of the PWM pin of
+// the first channel, on the average of the ripple. See fw/src/adc_scan.
+#define __ADC_DMA__ 1 // 0 for blocking AnalogIn reads, 1 for the DMA scan.
+#define ADC_TRIGGER ADC_TRIGGER_BOTH // ADC_TRIGGER_CONTINUOUS, _MID_ON, _MID_OFF or _BOTH.
+// Scans per block: 1 x 7 PWM periods triggered at both points, or 9 at one
+// point with the voltages centered, less than an inner loop tick with two
+// channels.
+#define ADC_BLOCK 1
+// Hardware oversampling ratio and right shift of every conversion. The ADC
+// averages 4 scans of 23.25 us, or 29.25 us centered, itself continuously, to
+// 14 bits; triggered, every oversampled conversion takes a trigger of its
+// own, which stretches a block over ADC_OVERSAMPLING x 7 PWM periods, so it
+// is left off there.
+#define ADC_OVERSAMPLING (ADC_TRIGGER == ADC_TRIGGER_CONTINUOUS ? 4 : 1) // 1 to 256, powers of 2.
+#define ADC_OVERSAMPLING_SHIFT 0 // Bits, at most log2(ADC_OVERSAMPLING).
+// Converts the array voltage on both sides of the array current, so that the
+// power of every sample is taken at one instant rather than a conversion
+// apart. Costs a rank per channel unless triggered at both points.
+#define ADC_CENTERED 1 // 0 to convert the voltage, then the current.
+#define BATT_V_PIN PA_7
+
+// Note: only read AnalogIn in one ISR ever since we aren't using mutexes.
+class UnlockedAnalogIn : public AnalogIn {
+public:
+    UnlockedAnalogIn(PinName inp) : AnalogIn(inp) { }
+    virtual void lock() { }
+    virtual void unlock() { }
+};
+
+// Pins of a converter channel. A channel without a battery current sensor
+// estimates its share from the power balance, see ChannelControlSense. The
+// sensors of all channels must fit the DMA scan. The first NUM_CHANNELS rows of
+// channel_pins are run.
+typedef struct ChannelPins {
+    PinName pwm;
+    PinName enable;
+    PinName arrVoltage;
+    PinName arrCurrent;
+    PinName battCurrent;
+} ChannelPins_t;
+
+const ChannelPins_t channel_pins[] = {
+    { PA_1, PA_3, PA_4, PA_5, PA_6 },
+    { PA_0, PA_8, PB_0, PB_1, NC }
+};
+static_assert(
+    NUM_CHANNELS >= 1 && NUM_CHANNELS <= sizeof(channel_pins) / sizeof(channel_pins[0]),
+    "Too few channel_pins rows for NUM_CHANNELS."
+);
+static_assert(CALIBRATION_CHANNELS >= NUM_CHANNELS, "Too few calibration tables, see sw/calibration_fit.py.");
+#if __ADC_DMA__ == 1
+static_assert(
+    (ADC_TRIGGER == ADC_TRIGGER_BOTH ? 2 * (3 * NUM_CHANNELS + 1) : 3 * NUM_CHANNELS + 1 + ADC_CENTERED * NUM_CHANNELS)
+        < ADC_SCAN_LENGTH_MAX,
+    "Too many sensors for the DMA scan."
+);
+#endif
+#if __FRA__ != 0
+static_assert(FRA_F_STOP < FRA_ARR_V_RATE / 2, "FRA sweep aliases on the array voltage samples.");
+#endif
+
+// State of a converter channel: its pins and sensors, and the control of
+// fw/inc/channel_control. `phase` is the inner loop tick of the outer stage
+// within OUTER_DECIMATION.
+class Channel {
+public:
+    Channel(const ChannelPins_t & pins, const CalibrationSet_t * calibration, uint8_t phase) :
+        pwm_enable(pins.enable),
+        pwm_out(pins.pwm),
+#if __ADC_DMA__ == 0
+        arr_voltage_sensor(pins.arrVoltage),
+        arr_current_sensor(pins.arrCurrent),
+        batt_current_sensor(pins.battCurrent == NC ? NULL : new UnlockedAnalogIn(pins.battCurrent)),
+#endif
+        calibration(calibration),
+        phase(phase),
+        slow_channel(phase % 3) {
+        ChannelOptions_t options = {
+            __MPPT__ != 0 && __FRA__ == 0,
+            __SCAN__ != 0,
+            SCAN_PERIOD,
+            __SCAN__ == 2,
+            __PREDICT__ != 0,
+            __METER__ == 1,
+            __CONTROL__ == 1,
+            pins.battCurrent != NC,
+            MPPT_DECIMATION
+        };
+        ChannelControlInit(
+            &control,
+            options,
+            // The inner loop gain leaves phase margin for the block means of
+            // the DMA scan, which are up to a tick old; see the switching runs
+            // of fw/tests/host_sim.
+            CascadedControllerInit(
+                PILoopInit(CURRENT_MAX, CURRENT_MIN, 0.5, 5E-3, 1.0),
+                PILoopInit(DUTY_MAX, DUTY_MIN, 5E-3, 1E-3, 1.0),
+                ARRAY_VOLTAGE,
+                OUTER_DECIMATION
+            ),
+            // With the explicit MPC, the MPPT limiter is pinned to CURRENT_MAX
+            // so the arbiter output is the tightest battery limit; it still
+            // holds the array voltage reference.
+            ControlArbiterInit(
+                __CONTROL__ == 1
+                    ? ControlLimiterInit(PILoopInit(CURRENT_MAX, CURRENT_MAX, 0.0, 0.0, 0.0), ARR_V_TARGET, -1.0)
+                    : ControlLimiterInit(PILoopInit(CURRENT_MAX, CURRENT_MIN, 0.5, 5E-3, 1.0), ARR_V_TARGET, -1.0),
+                ControlLimiterInit(PILoopInit(CURRENT_MAX, CURRENT_MIN, 0.5, 5E-3, 1.0), BATT_V_CV, 1.0),
+                ControlLimiterInit(PILoopInit(CURRENT_MAX, CURRENT_MIN, 1.0, 2E-2, 1.0), BATT_I_CC / NUM_CHANNELS, 1.0)
+            ),
+            ExplicitMPCInit(INPUT_CAPACITANCE),
+            // Each averaged measurement spans MPPT_WINDOW outer ticks of 4
+            // sample filters. The extremum seeking dithers 0.5 V at 1.04 kHz /
+            // EXTREMUM_SEEKING_PERIOD = 32.5 Hz.
+            MPPTInit(
+                PerturbObserveInit(ARR_V_MAX, ARR_V_MIN, 2.0, 0.25, 0.2, ARR_V_TARGET),
+                IncrementalConductanceInit(ARR_V_MAX, ARR_V_MIN, 2.0, 0.25, 0.2, 3.0, MPPT_WINDOW * 4, ARR_V_TARGET),
+                ExtremumSeekingInit(ARR_V_MAX, ARR_V_MIN, 0.5, 2.0, 0.5, ARR_V_TARGET),
+                FractionalVocInit(ARR_V_MAX, ARR_V_MIN, VOC_K, 0.25, 0.2, VOC_WINDOW, VOC_INTERVAL, ARR_V_TARGET),
+                (enum MPPTStrategyID) MPPT_STRATEGY,
+                ARR_V_TARGET
+            ),
+            GlobalScanInit(
+                ARR_V_MIN,
+                ARR_V_MAX,
+                ARR_VOC_COLD,
+                ARR_SUBSTRINGS,
+                CURRENT_MAX,
+                200.0,
+                2000.0,
+                SCAN_ENERGY_CAP,
+                INPUT_CAPACITANCE,
+                F_SW / INNER_DECIMATION
+            ),
+            // Absorbs 1 % per step and fires at 5 %; settles below 0.5 % per
+            // step within 20 steps, probes 1 V, and counts rho in [0.3, 3] as
+            // uniform.
+            ChangeDetectorInit(0.01, 0.05, 0.005, 20, 1.0, 0.3, 3.0),
+            // Rejects a sweep if the power at the operating point moved by 1 %.
+            EfficiencyMeterInit(
+                METER_AMPLITUDE,
+                METER_POINTS,
+                METER_SETTLE,
+                METER_AVERAGE,
+                METER_INTERVAL,
+                0.01,
+                F_SW / (INNER_DECIMATION * OUTER_DECIMATION)
+            ),
+            ModelPredictorInit(
+                ARR_CELLS, ARR_R_S, ARR_R_SH, ARR_V_MAX, ARR_V_MIN, 0.1, 1.0, ARR_TEMPERATURE, __PREDICT__ == 2
+            )
+        );
+    }
+
+    DigitalOut pwm_enable;
+    FastPWM pwm_out;
+#if __ADC_DMA__ == 1
+    // Slots of the sensors in the DMA scan, see adc_scan_init. Negative
+    // without a battery current sensor.
+    uint8_t arr_voltage_slot = 0;
+    uint8_t arr_current_slot = 0;
+    int8_t batt_current_slot = -1;
+#else
+    UnlockedAnalogIn arr_voltage_sensor;
+    UnlockedAnalogIn arr_current_sensor;
+    UnlockedAnalogIn * batt_current_sensor;
+#endif
+    // Last array voltage sample, unfiltered, for the FRA.
+    float arr_voltage_sample = 0.0f;
+
+    ChannelControl_t control;
+
+    // Calibration tables of the sensors of the channel.
+    const CalibrationSet_t * calibration;
+    uint8_t phase;
+    uint8_t slow_channel;
+    volatile uint16_t redline_holdoff = 0;
+};
+
+typedef enum Error {
+    OK=0,
+    INP_UVL=100,
+    INP_OVL=101,
+    OUT_UVL=102,
+    OUT_OVL=103,
+    INP_OUT_INV=104,
+} ErrorCode;
+ErrorCode status = OK;
+
+#if __FRA__ != 0
+FRA_t fra = FRAInit(
+    (enum FRAMode) (__FRA__ - 1),
+    FRA_SAMPLE_RATE,
+    FRA_F_START,
+    FRA_F_STOP,
+    24,
+    FRA_AMPLITUDE,
+    4,
+    16
+);
+uint8_t fra_table[12 + FRA_MAX_POINTS * sizeof(FRAPoint_t) + 2];
+#endif
+
+#if __TRACE__ == 1
+// Settles the lead in for 5 ms, and opens the array for at most VOC_WINDOW
+// ticks; the sensors are sampled raw at their full scale.
+IVTracer_t tracer = IVTracerInit(
+    DUTY_MAX,
+    DUTY_MIN,
+    TRACE_POINTS,
+    52,
+    TRACE_I_START,
+    TRACE_I_STOP,
+    CURRENT_MAX,
+    TRACE_V_MAX,
+    114.0,
+    5.79,
+    0.2,
+    VOC_WINDOW,
+    F_SW / INNER_DECIMATION
+);
+uint8_t trace_record[IV_TRACER_RECORD_SIZE(IV_TRACER_MAX_POINTS)];
+static volatile bool trace_request = false;
+#endif
+
+DigitalOut led_heartbeat(PA_9);
+DigitalOut led_tracking(PA_10);
+DigitalOut led_error(PA_12);
+#if __ADC_DMA__ == 0
+UnlockedAnalogIn batt_voltage_sensor(BATT_V_PIN);
+#endif
+
+Ticker ticker_toggle_heartbeat;
+Ticker ticker_check_redlines;
+
+static volatile bool tracking = false;
+static volatile uint8_t mppt_request = MPPT_STRATEGY;
+static Channel * channels[NUM_CHANNELS];
+
+// Sensor calibration by raw code, see sw/calibration_fit.py. The channels
+// share the battery voltage sensor, calibrated with the first one.
+float calibrate_arr_v(Channel * ch, uint16_t code) { return CalibrationApply(&ch->calibration->arrVoltage, code); }
+float calibrate_arr_i(Channel * ch, uint16_t code) { return CalibrationApply(&ch->calibration->arrCurrent, code); }
+float calibrate_batt_v(uint16_t code) { return CalibrationApply(&CALIBRATION[0].battVoltage, code); }
+float calibrate_batt_i(Channel * ch, uint16_t code) { return CalibrationApply(&ch->calibration->battCurrent, code); }
+
+void heartbeat() { led_heartbeat = !led_heartbeat; }
+
+// Raw sensor reads, as codes of AnalogIn::read_u16() at a 3.3 V supply. The
+// DMA scan scales them by the VDDA it measures, see AdcScanVdda(); AnalogIn
+// assumes the supply is nominal.
+#if __ADC_DMA__ == 1
+// Block means of the last DMA transfer, by slot of the scan. The DMA ISR has
+// the priority of the control ISR, so neither sees the other half done.
+static volatile uint16_t adc_codes[ADC_SCAN_LENGTH_MAX];
+static uint8_t adc_slots = 0;
+static uint8_t batt_voltage_slot = 0;
+
+void adc_block(const float * means) {
+    for (uint8_t slot = 0; slot < adc_slots; ++slot) adc_codes[slot] = CalibrationCode(means[slot]);
+}
+
+bool adc_scan_init(void) {
+    // The sensors of every channel, then the battery voltage they share.
+    PinName pins[ADC_SCAN_LENGTH_MAX];
+    uint8_t count = 0;
+    uint32_t centered = 0;
+    for (uint8_t k = 0; k < NUM_CHANNELS; ++k) {
+        Channel * ch = channels[k];
+        ch->arr_voltage_slot = count;
+        if (ADC_CENTERED) centered |= 1UL << count;
+        pins[count++] = channel_pins[k].arrVoltage;
+        ch->arr_current_slot = count;
+        pins[count++] = channel_pins[k].arrCurrent;
+        if (channel_pins[k].battCurrent != NC) {
+            ch->batt_current_slot = count;
+            pins[count++] = channel_pins[k].battCurrent;
+        }
+    }
+    batt_voltage_slot = count;
+    pins[count++] = BATT_V_PIN;
+    adc_slots = count;
+    return AdcScanInit(pins, count, centered, ADC_BLOCK, ADC_TRIGGER, channel_pins[0].pwm, &adc_block, 1);
+}
+
+uint16_t read_arr_v(Channel * ch) { return adc_codes[ch->arr_voltage_slot]; }
+uint16_t read_arr_i(Channel * ch) { return adc_codes[ch->arr_current_slot]; }
+uint16_t read_batt_v(void) { return adc_codes[batt_voltage_slot]; }
+bool has_batt_i(Channel * ch) { return ch->batt_current_slot >= 0; }
+uint16_t read_batt_i(Channel * ch) { return adc_codes[ch->batt_current_slot]; }
+#else
+uint16_t read_arr_v(Channel * ch) { return ch->arr_voltage_sensor.read_u16(); }
+uint16_t read_arr_i(Channel * ch) { return ch->arr_current_sensor.read_u16(); }
+uint16_t read_batt_v(void) { return batt_voltage_sensor.read_u16(); }
+bool has_batt_i(Channel * ch) { return ch->batt_current_sensor != NULL; }
+uint16_t read_batt_i(Channel * ch) { return ch->batt_current_sensor->read_u16(); }
+#endif
+
+void read_sensor(Channel * ch, ChannelSample_t * sample) {
+    sample->fresh = 0;
+    if (ch->control.mppt.fv.measuring) {
+        // With the gates off only the array voltage matters; it is read every
+        // tick.
+        sample->arrVoltage = calibrate_arr_v(ch, read_arr_v(ch));
+        sample->fresh = CHANNEL_ARR_VOLTAGE;
+        return;
+    }
+    // The inductor current is needed every tick.
+    sample->arrCurrent = calibrate_arr_i(ch, read_arr_i(ch));
+    sample->fresh |= CHANNEL_ARR_CURRENT;
+#if __ADC_DMA__ == 1
+    // Every sensor was converted in the background.
+    ch->arr_voltage_sample = calibrate_arr_v(ch, read_arr_v(ch));
+    sample->arrVoltage = ch->arr_voltage_sample;
+    sample->battVoltage = calibrate_batt_v(read_batt_v());
+    sample->fresh |= CHANNEL_ARR_VOLTAGE | CHANNEL_BATT_VOLTAGE;
+    if (has_batt_i(ch)) {
+        sample->battCurrent = calibrate_batt_i(ch, read_batt_i(ch));
+        sample->fresh |= CHANNEL_BATT_CURRENT;
+    }
+#else
+    // The outer stage sensors are read round robin to bound the ISR length;
+    // the array voltage every tick while the FRA measures it.
+    if (__FRA__ != 0 || ch->slow_channel == 0) {
+        ch->arr_voltage_sample = calibrate_arr_v(ch, read_arr_v(ch));
+        sample->arrVoltage = ch->arr_voltage_sample;
+        sample->fresh |= CHANNEL_ARR_VOLTAGE;
+    }
+    switch (ch->slow_channel) {
+        case 1:
+            sample->battVoltage = calibrate_batt_v(read_batt_v());
+            sample->fresh |= CHANNEL_BATT_VOLTAGE;
+            break;
+        case 2:
+            if (has_batt_i(ch)) {
+                sample->battCurrent = calibrate_batt_i(ch, read_batt_i(ch));
+                sample->fresh |= CHANNEL_BATT_CURRENT;
+            }
+            break;
+    }
+    if (++ch->slow_channel >= 3) ch->slow_channel = 0;
+#endif
+}
+#if __TRACE__ == 1
+void trace_curve(Channel * ch) {
+    // Like a V_oc measurement, the sensors are sampled raw every tick and kept
+    // out of the filters, and the loops hold their state through the trace.
+    float duty = IVTracerStep(
+        &tracer,
+        calibrate_arr_v(ch, read_arr_v(ch)),
+        calibrate_arr_i(ch, read_arr_i(ch))
+    );
+    if (IVTracerRunning(&tracer)) {
+        ch->pwm_enable = !IVTracerOpen(&tracer);
+        ch->pwm_out.write(1.0 - duty);
+        return;
+    }
+    // The array falls back to the operating point within a few ticks.
+    ch->redline_holdoff = VOC_HOLDOFF;
+    if (tracking) ch->pwm_enable = 1;
+}
+#endif
+void run_channel(Channel * ch) {
+#if __TRACE__ == 1
+    if (ch == channels[TRACE_CHANNEL] && IVTracerRunning(&tracer)) {
+        trace_curve(ch);
+        return;
+    }
+#endif
+    ChannelSample_t sample;
+    read_sensor(ch, &sample);
+    if (!ChannelControlSense(&ch->control, &sample)) {
+        // The loops and the PWM output held their state through the V_oc
+        // window, so the array falls back to the operating point within a few
+        // ticks.
+        if (ch->control.events & CHANNEL_CLOSED) {
+            ch->redline_holdoff = VOC_HOLDOFF;
+            if (tracking) ch->pwm_enable = 1;
+        }
+        return;
+    }
+    if (ch->redline_holdoff > 0) --ch->redline_holdoff;
+    if (!tracking) return;
+
+#if __TRACE__ == 1
+    if (trace_request && ch == channels[TRACE_CHANNEL] && !GlobalScanRunning(&ch->control.scan)) {
+        // Trace from the duty of the operating point.
+        trace_request = false;
+        IVTracerStart(&tracer, 1.0 - ch->pwm_out.read());
+        return;
+    }
+#endif
+
+#if __FRA__ != 0
+    // The sweep runs on the first channel; the others keep tracking. The
+    // tracker is held while the FRA is enabled so the sweep sees a fixed
+    // operating point.
+    bool analyzed = ch == channels[0];
+    float perturbation = analyzed ? FRAPerturbation(&fra) : 0.0f;
+    if (analyzed && fra.mode == FRA_REFERENCE) {
+        ControlArbiterSetReference(&ch->control.arbiter, LOOP_MPPT, ARR_V_TARGET + perturbation);
+        perturbation = 0.0;
+    }
+#endif
+
+    ch->control.request = (enum MPPTStrategyID) mppt_request;
+    float duty = ChannelControlStep(&ch->control);
+    // Open the array when fractional V_oc or a scan asks for V_oc.
+    if (ch->control.events & CHANNEL_OPENED) ch->pwm_enable = 0;
+
+#if __FRA__ != 0
+    if (analyzed) {
+        float applied = duty + perturbation;
+        if (applied > DUTY_MAX) applied = DUTY_MAX;
+        else if (applied < DUTY_MIN) applied = DUTY_MIN;
+        switch (fra.mode) {
+            case FRA_PLANT:
+                FRAStep(&fra, applied, ch->arr_voltage_sample);
+                break;
+            case FRA_LOOP:
+                FRAStep(&fra, applied, duty);
+                break;
+            case FRA_REFERENCE:
+                FRAStep(&fra, ch->control.arbiter.limiters[LOOP_MPPT].reference, ch->arr_voltage_sample);
+                break;
+        }
+        duty = applied;
+    }
+#endif
+
+    // Inverse logic; the PWM pin drives the high side switch.
+    ch->pwm_out.write(1.0 - duty);
+}
+void run_controller(void) {
+    // Sensing and control of every channel share one ISR, synchronous to the
+    // PWM period. Their outer stages fall on different ticks, see
+    // channel_start.
+    for (uint8_t k = 0; k < NUM_CHANNELS; ++k) run_channel(channels[k]);
+#if __ADC_DMA__ == 1
+    // The sample points follow the first channel; the channels share the
+    // battery and see similar duty cycles.
+    AdcScanSetDuty(channels[0]->pwm_out.read());
+#endif
+}
+void channel_start(Channel * ch) {
+    // Start tracking from the current operating point, with the outer stage
+    // `phase` ticks after the first.
+    ChannelControlStart(&ch->control, ch->phase);
+}
+#if __BENCH__ == 1
+// A synthetic array with its MPP at about 60 V, so the trackers take the same
+// branches as on the real one.
+float bench_current(float voltage) {
+    return 5.0 * (1.0 - expf((voltage - 72.0) / 4.0));
+}
+
+void benchmark(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    printf("strategy, mean cycles, max cycles\n");
+    MPPT_t bench = channels[0]->control.mppt;
+    for (uint8_t id = 0; id < NUM_MPPT_STRATEGIES; ++id) {
+        MPPTSelect(&bench, (enum MPPTStrategyID) id, ARR_V_TARGET);
+        float reference = ARR_V_TARGET;
+        uint32_t total = 0;
+        uint32_t worst = 0;
+        for (uint16_t n = 0; n < BENCH_STEPS; ++n) {
+            MPPTSample_t sample = { reference, bench_current(reference), 1E-4, 1E-4 };
+            uint32_t start = DWT->CYCCNT;
+            reference = MPPTStep(&bench, &sample);
+            uint32_t cycles = DWT->CYCCNT - start;
+            total += cycles;
+            if (cycles > worst) worst = cycles;
+        }
+        printf("%s, %u, %u\n", bench.strategy->name, total / BENCH_STEPS, worst);
+    }
+
+    // The predictions of both methods of the model predictor, the solve and
+    // the table, across the operating points of the synthetic array. Both
+    // run in the outer loop, and the table should stay under 1 us.
+    printf("predictor, mean cycles, max cycles, mean us\n");
+    ModelPredictor_t predictor = channels[0]->control.predictor;
+    for (uint8_t table = 0; table < 2; ++table) {
+        uint32_t total = 0;
+        uint32_t worst = 0;
+        volatile float sink = 0.0;
+        for (uint16_t n = 0; n < BENCH_STEPS; ++n) {
+            float voltage = 40.0 + 30.0 * n / BENCH_STEPS;
+            float current = bench_current(voltage);
+            float irradiance = 1000.0 * (n + 1) / BENCH_STEPS;
+            uint32_t start = DWT->CYCCNT;
+            sink = table
+                ? ModelPredictorVmppTable(predictor.temperature, voltage, current)
+                : ModelPredictorVmpp(&predictor, irradiance);
+            uint32_t cycles = DWT->CYCCNT - start;
+            total += cycles;
+            if (cycles > worst) worst = cycles;
+        }
+        (void) sink;
+        printf(
+            "%s, %u, %u, %.3f\n",
+            table ? "ModelPredictorVmppTable" : "ModelPredictorVmpp",
+            total / BENCH_STEPS,
+            worst,
+            1E6 * total / BENCH_STEPS / SystemCoreClock
+        );
+    }
+}
+#endif
+
+void _assert(bool condition, ErrorCode code) {
+    // If we fail our condition, raise the flag and let the main thread handle it.
+    if (!condition) { status = code; }
+}
+void check_redlines(void) {
+    for (uint8_t k = 0; k < NUM_CHANNELS; ++k) {
+        Channel * ch = channels[k];
+        float arr_v_filtered = ch->control.arrVoltage.getResult();
+        float batt_v_filtered = ch->control.battVoltage.getResult();
+
+        // Our input must be in the range (1.0, 80.0).
+        _assert(arr_v_filtered > 1.0, INP_UVL);
+        // A cold array exceeds the upper bound at open circuit, where a V_oc
+        // measurement leaves it for a few milliseconds.
+        _assert(arr_v_filtered < 70.0 || ch->redline_holdoff > 0, INP_OVL);
+
+        // Our output must be between (80.0, 130.0).
+        _assert(batt_v_filtered > 70.0, OUT_UVL);
+        _assert(batt_v_filtered < 130.0, OUT_OVL);
+
+        // Our output must always be greater than our input.
+        _assert(arr_v_filtered < batt_v_filtered, INP_OUT_INV);
+    }
+}
+
+#define CYCLE_PERIOD 5ms
+int main()
+{
+    set_time(1680461674);
+
+    printf("Hello world. Sunscatter cascaded controller. starting up.\n");
+
+    // Start heartbeat.
+    ticker_toggle_heartbeat.attach(&heartbeat, 1000ms);
+
+    // Spread the outer stages of the channels evenly over OUTER_DECIMATION
+    // inner loop ticks.
+    for (uint8_t k = 0; k < NUM_CHANNELS; ++k) {
+        channels[k] = new Channel(channel_pins[k], &CALIBRATION[k], k * OUTER_DECIMATION / NUM_CHANNELS);
+    }
+
+#if __BENCH__ == 1
+    benchmark();
+#endif
+
+    // Set the pwm frequency to 104 kHz and start sensing off the PWM period.
+    // The channels share the timer, so the first one paces all of them.
+    for (uint8_t k = 0; k < NUM_CHANNELS; ++k) {
+        channels[k]->pwm_out.period_us(1.0E6 / F_SW);
+        channels[k]->pwm_out.write(1.0 - DUTY_MIN);
+    }
+#if __ADC_DMA__ == 1
+    // Sense before the control ISR starts; a triggered scan needs the PWM
+    // period.
+    if (!adc_scan_init()) {
+        led_error = 1;
+        printf("Sensor pin is not an ADC1 input, or PWM pin not on TIM2.\n");
+        while (true) {
+            ThisThread::sleep_for(1000ms);
+        }
+    }
+    if (!AdcScanSetOversampling(ADC_OVERSAMPLING, ADC_OVERSAMPLING_SHIFT)) {
+        led_error = 1;
+        printf("Invalid ADC oversampling ratio or shift.\n");
+        while (true) {
+            ThisThread::sleep_for(1000ms);
+        }
+    }
+    AdcScanSetDuty(channels[0]->pwm_out.read());
+    AdcScanStart();
+    printf("ADC scan at %.0f blocks/s, %.1f bits.\n", AdcScanRate(), AdcScanResolution());
+#if __FRA__ != 0
+    // A block per tick at least, or the FRA sees held samples.
+    if (AdcScanRate() < FRA_ARR_V_RATE) {
+        led_error = 1;
+        printf("ADC scan is slower than the FRA sample rate.\n");
+        while (true) {
+            ThisThread::sleep_for(1000ms);
+        }
+    }
+#endif
+#endif
+    if (!PWMSyncInit(channel_pins[0].pwm, &run_controller, INNER_DECIMATION)) {
+        led_error = 1;
+        printf("PWM pin is not backed by a supported timer.\n");
+        while (true) {
+            ThisThread::sleep_for(1000ms);
+        }
+    }
+    PWMSyncStart();
+
+    // 5 seconds for user to get ready.
+    ThisThread::sleep_for(5000ms);
+
+    // Start tracking from the current operating point. The ISR only runs the
+    // channels once tracking is set.
+    for (uint8_t k = 0; k < NUM_CHANNELS; ++k) channel_start(channels[k]);
+    tracking = true;
+    led_tracking = 1;
+    for (uint8_t k = 0; k < NUM_CHANNELS; ++k) channels[k]->pwm_enable = 1;
+
+    ThisThread::sleep_for(500ms);
+    ticker_check_redlines.attach(&check_redlines, 10ms);
+
+#if __FRA__ != 0
+    FRAStart(&fra);
+    bool fra_sent = false;
+#endif
+#if __TRACE__ == 1
+    trace_request = true;
+#endif
+    FileHandle * console = mbed_file_handle(STDIN_FILENO);
+
+    while (true) {
+        ThisThread::sleep_for(CYCLE_PERIOD);
+#if __FRA__ != 0
+        if (!fra_sent && fra.state == FRA_DONE) {
+            size_t length = FRASerialize(&fra, fra_table, sizeof(fra_table));
+            fwrite(fra_table, 1, length, stdout);
+            fflush(stdout);
+            fra_sent = true;
+        }
+#endif
+#if __TRACE__ == 1
+        if (tracer.state == TRACE_DONE) {
+            size_t length = IVTracerSerialize(&tracer, trace_record, sizeof(trace_record));
+            fwrite(trace_record, 1, length, stdout);
+            fflush(stdout);
+            tracer.state = TRACE_IDLE;
+        }
+#endif
+        // Select a strategy by its index in MPPT_STRATEGIES, or trace.
+        char command;
+        if (console->readable() && console->read(&command, 1) == 1) {
+            if (command >= '0' && command < '0' + NUM_MPPT_STRATEGIES) mppt_request = command - '0';
+#if __TRACE__ == 1
+            if (command == 't') trace_request = true;
+#endif
+        }
+        // CSV format for later analysis, a line per channel.
+        for (uint8_t k = 0; k < NUM_CHANNELS; ++k) {
+            ChannelControl_t * cc = &channels[k]->control;
+            printf(
+                "%u, %u, %f, %f, %f, %f, %f, %f, %f, %u, %u",
+                time(NULL),
+                k,
+                cc->arbiter.limiters[LOOP_MPPT].reference,
+                cc->arrVoltage.getResult(),
+                cc->arrCurrent.getResult(),
+                cc->battVoltage.getResult(),
+                cc->battCurrent.getResult(),
+                cc->controller.currentReference,
+                1.0 - channels[k]->pwm_out.read(),
+                cc->arbiter.active,
+                cc->arbiter.handovers
+            );
+            // Telemetry common to every strategy.
+            printf(
+                ", %u, %f, %u, %u, %f",
+                cc->mppt.id,
+                cc->mppt.telemetry.power,
+                cc->mppt.telemetry.steps,
+                cc->mppt.telemetry.converged,
+                MPPTDiagnostic(&cc->mppt)
+            );
+#if __METER__ == 1 && __MPPT__ != 0
+            // Tracking efficiency and MPP offset of the last accepted sweep.
+            printf(", %f, %f, %u", cc->meter.ratio, cc->meter.offset, cc->meter.sweeps);
+#endif
+            printf("\n");
+        }
+
+        if (status != OK) {
+            tracking = false;
+            for (uint8_t k = 0; k < NUM_CHANNELS; ++k) channels[k]->pwm_enable = 0;
+            led_tracking = 0;
+            printf("A redline (%u) has been crossed. Tracking is disabled.\n", status);
+            while (true) {
+                ThisThread::sleep_for(1000ms);
+            }
+        }
+    }
+}
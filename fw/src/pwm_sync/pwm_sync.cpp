@@ -0,0 +1,64 @@
+/**
+ * @file pwm_sync.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Runs a callback synchronous to the PWM period.
+ * @version 0.1
+ * @date 2023-08-20
+ * @copyright Copyright (c) 2023
+ */
+
+/** General imports. */
+#include "mbed.h"
+#include "pinmap.h"
+#include "PeripheralPins.h"
+
+/** Device Specific imports. */
+#include "./pwm_sync.hpp"
+
+
+static TIM_TypeDef * timer = nullptr;
+static IRQn_Type irq;
+static void (*periodCallback)(void) = nullptr;
+static uint16_t periodDecimation = 1;
+static uint16_t periodCount = 0;
+
+static void PWMSyncISR(void) {
+    /* Clear only the update flag; capture/compare flags belong to others. */
+    timer->SR = ~TIM_SR_UIF;
+    if (++periodCount < periodDecimation) return;
+    periodCount = 0;
+    periodCallback();
+}
+
+bool PWMSyncInit(PinName pin, void (*callback)(void), uint16_t decimation) {
+    timer = (TIM_TypeDef *) pinmap_peripheral(pin, PinMap_PWM);
+    if (timer == TIM2) irq = TIM2_IRQn;
+    else if (timer == TIM15) irq = TIM1_BRK_TIM15_IRQn;
+    else {
+        timer = nullptr;
+        return false;
+    }
+
+    periodCallback = callback;
+    periodDecimation = decimation == 0 ? 1 : decimation;
+    periodCount = 0;
+
+    /* Control ISR must preempt the sensor and redline tickers. */
+    NVIC_SetVector(irq, (uint32_t) &PWMSyncISR);
+    NVIC_SetPriority(irq, 1);
+    return true;
+}
+
+void PWMSyncStart(void) {
+    if (timer == nullptr) return;
+    periodCount = 0;
+    timer->SR = ~TIM_SR_UIF;
+    timer->DIER |= TIM_DIER_UIE;
+    NVIC_EnableIRQ(irq);
+}
+
+void PWMSyncStop(void) {
+    if (timer == nullptr) return;
+    timer->DIER &= ~TIM_DIER_UIE;
+    NVIC_DisableIRQ(irq);
+}
@@ -0,0 +1,35 @@
+/**
+ * @file pwm_sync.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Runs a callback synchronous to the PWM period by hooking the update
+ *        event of the timer driving a FastPWM pin.
+ * @version 0.1
+ * @date 2023-08-20
+ * @note For the STM32L432KC. The timer backing the pin is looked up from the
+ *       mbed pinmap, so the PWM pin can move between TIM2 and TIM15.
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include "mbed.h"
+
+
+/**
+ * @brief PWMSyncInit attaches a callback to the update event of the timer
+ *        driving `pin`.
+ *
+ * @param pin        PWM pin, already configured by FastPWM.
+ * @param callback   Function to execute from the timer ISR.
+ * @param decimation Number of PWM periods per callback. Must be nonzero.
+ * @return True if the pin is backed by a supported timer.
+ * @note The callback executes in interrupt context at the PWM rate divided by
+ *       `decimation`; keep it short and deterministic.
+ */
+bool PWMSyncInit(PinName pin, void (*callback)(void), uint16_t decimation);
+
+/** @brief PWMSyncStart enables the PWM period interrupt. */
+void PWMSyncStart(void);
+
+/** @brief PWMSyncStop disables the PWM period interrupt. */
+void PWMSyncStop(void);
@@ -11,36 +11,28 @@
  */
 
 #include "mbed.h"
+#include "../../inc/calibration/calibration_tables.hpp"
 
 AnalogIn arr_voltage_sensor(PA_4);
 AnalogIn arr_current_sensor(PA_5);
 AnalogIn batt_voltage_sensor(PA_7);
 AnalogIn batt_current_sensor(PA_6);
+AnalogIn vref_sensor(ADC_VREF);
 DigitalOut led_heartbeat(PA_9);
 DigitalOut pwm_enable(PA_3);
 PwmOut pwm_out(PA_1);
 Ticker ticker_heartbeat;
 Ticker ticker_measure_areaddcs;
 
-float calibrate_arr_v(float inp) {
-    if (inp < 1.0) return inp * 114.0;
-    else return 114.0;
-}
-
-float calibrate_arr_i(float inp) {
-    if (inp < 1.0) return inp * 5.79 + 0.0042;
-    else return 5.79;
-}
+// Sensor calibration by raw code, see sw/calibration_fit.py.
+float calibrate_arr_v(uint16_t code) { return CalibrationApply(&CALIBRATION[0].arrVoltage, code); }
+float calibrate_arr_i(uint16_t code) { return CalibrationApply(&CALIBRATION[0].arrCurrent, code); }
+float calibrate_batt_v(uint16_t code) { return CalibrationApply(&CALIBRATION[0].battVoltage, code); }
+float calibrate_batt_i(uint16_t code) { return CalibrationApply(&CALIBRATION[0].battCurrent, code); }
 
-float calibrate_batt_v(float inp) {
-    if (inp < 1.0) return inp * 168.0 + 0.0393;
-    else return 168.0;
-}
-
-float calibrate_batt_i(float inp) {
-    if (inp < 1.0) return inp * 5.8 + 0.0167;
-    else return 5.8;
-}
+// Refers a raw code to a 3.3 V supply, like the means of the DMA scan, so the
+// tables fitted to it hold whatever the supply at the bench.
+uint16_t refer_code(uint16_t code, float vdda) { return CalibrationCode(code / 65535.0f * vdda / 3.3f); }
 
 void heartbeat() { led_heartbeat = !led_heartbeat; }
 
@@ -61,15 +53,27 @@ int main()
      */
     ticker_heartbeat.attach(&heartbeat, 1000ms);
 
+    // CSV format for later analysis. Add the multimeter readings as columns
+    // "arr_v ref (V)", "arr_i ref (A)", "batt_v ref (V)" and "batt_i ref (A)",
+    // and fit the calibration tables to the raw codes with
+    // sw/calibration_fit.py.
+    printf("t (s),arr_v (V),arr_i (A),batt_v (V),batt_i (A),arr_v code,arr_i code,batt_v code,batt_i code\n");
     while (true) {
         ThisThread::sleep_for(1000ms);
         time_t seconds = time(NULL);
-        float arr_v = calibrate_arr_v(arr_voltage_sensor.read());
-        float arr_i = calibrate_arr_i(arr_current_sensor.read());
-        float batt_v = calibrate_batt_v(batt_voltage_sensor.read());
-        float batt_i = calibrate_batt_i(batt_current_sensor.read());
+        float vdda = (float) VREFINT_CAL_VREF / 1000.0f * *VREFINT_CAL_ADDR / (4095.0f * vref_sensor.read());
+        uint16_t arr_v_code = refer_code(arr_voltage_sensor.read_u16(), vdda);
+        uint16_t arr_i_code = refer_code(arr_current_sensor.read_u16(), vdda);
+        uint16_t batt_v_code = refer_code(batt_voltage_sensor.read_u16(), vdda);
+        uint16_t batt_i_code = refer_code(batt_current_sensor.read_u16(), vdda);
+        float arr_v = calibrate_arr_v(arr_v_code);
+        float arr_i = calibrate_arr_i(arr_i_code);
+        float batt_v = calibrate_batt_v(batt_v_code);
+        float batt_i = calibrate_batt_i(batt_i_code);
 
-        // CSV format for later analysis.
-        printf("%u,%f,%f,%f,%f\n", (unsigned int) seconds, arr_v, arr_i, batt_v, batt_i);
+        printf(
+            "%u,%f,%f,%f,%f,%u,%u,%u,%u\n", (unsigned int) seconds, arr_v, arr_i, batt_v, batt_i,
+            arr_v_code, arr_i_code, batt_v_code, batt_i_code
+        );
     }
 }
@@ -12,6 +12,7 @@
 #include "mbed.h"
 #include "FastPWM.h"
 #include "./Filter/SmaFilter.h"
+#include "../../inc/calibration/calibration_tables.hpp"
 #include <cstdio>
 
 #define F_SW 104000.0 // 104 khz switching
@@ -48,21 +49,15 @@ Ticker ticker_read_sensor;
 Ticker ticker_update_pwm;
 Ticker ticker_check_redlines;
 
-float calibrate_arr_v(float inp) {
-    if (inp < 1.0) return inp * 114.0;
-    else return 114.0;
-}
-
-float calibrate_batt_v(float inp) {
-    if (inp < 1.0) return inp * 168.0 + 0.0393;
-    else return 168.0;
-}
+// Sensor calibration by raw code, see sw/calibration_fit.py.
+float calibrate_arr_v(uint16_t code) { return CalibrationApply(&CALIBRATION[0].arrVoltage, code); }
+float calibrate_batt_v(uint16_t code) { return CalibrationApply(&CALIBRATION[0].battVoltage, code); }
 
 void heartbeat(void) { led_heartbeat = !led_heartbeat; }
 void read_sensor(void) {
     // Read in input and output voltage and insert into filter.
-    arr_voltage_filter.addSample(calibrate_arr_v(arr_voltage_sensor.read()));
-    batt_voltage_filter.addSample(calibrate_batt_v(batt_voltage_sensor.read()));
+    arr_voltage_filter.addSample(calibrate_arr_v(arr_voltage_sensor.read_u16()));
+    batt_voltage_filter.addSample(calibrate_batt_v(batt_voltage_sensor.read_u16()));
 }
 void update_pwm(void) {
     // Calculate new duty cycle.
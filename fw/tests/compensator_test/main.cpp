@@ -0,0 +1,227 @@
+/**
+ * @file main.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Host test for the compensator engine. Checks that the discretized
+ *        Type II and Type III compensators match their continuous designs,
+ *        and that the runtime difference equation matches its coefficients.
+ * @version 0.1
+ * @date 2023-08-24
+ * @note Runs on the host, not the Sunscatter. Build and run from this folder:
+ *       g++ -std=gnu++14 -O2 -Wall main.cpp ../../inc/compensator/compensator.cpp -o compensator_test && ./compensator_test
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <complex>
+#include <math.h>
+#include <stdio.h>
+#include "../../inc/compensator/compensator.hpp"
+
+typedef std::complex<double> Complex;
+
+#define F_S 10400.0 // Hz, inner loop rate of fw/src/main.cpp.
+
+// Type II: integrator, zero at 200 Hz, pole at 2 kHz.
+constexpr CompensatorDesign_t TYPE_II = {
+    2.0 * M_PI * 100.0, true, 1, { 200.0, 0.0, 0.0 }, 1, { 2000.0, 0.0, 0.0 }, F_S
+};
+// Type III: integrator, double zero at 300 Hz, poles at 2.5 kHz and 4 kHz.
+constexpr CompensatorDesign_t TYPE_III = {
+    2.0 * M_PI * 50.0, true, 2, { 300.0, 300.0, 0.0 }, 2, { 2500.0, 4000.0, 0.0 }, F_S
+};
+
+// The coefficients must be compile time constants.
+constexpr CompensatorCoefficients_t COEFFS_II = CompensatorDiscretize(TYPE_II);
+constexpr CompensatorCoefficients_t COEFFS_III = CompensatorTypeIII(
+    2.0 * M_PI * 50.0, 300.0, 300.0, 2500.0, 4000.0, F_S
+);
+static_assert(COEFFS_II.order == 2, "Type II is 2p2z.");
+static_assert(COEFFS_III.order == 3, "Type III is 3p3z.");
+static_assert(COEFFS_III.a[0] == 1.0f, "Coefficients are normalized.");
+
+/** Continuous response of a design at angular frequency w. */
+Complex continuous(const CompensatorDesign_t & design, double w, bool prewarp) {
+    double t = 1.0 / design.sampleRate;
+    Complex s(0.0, w);
+    Complex h = design.gain;
+    for (uint8_t k = 0; k < design.numZeros; ++k) {
+        double wz = 2.0 * M_PI * design.zeros[k];
+        if (prewarp) wz = (2.0 / t) * tan(wz * t / 2.0);
+        h *= 1.0 + s / wz;
+    }
+    for (uint8_t k = 0; k < design.numPoles; ++k) {
+        double wp = 2.0 * M_PI * design.poles[k];
+        if (prewarp) wp = (2.0 / t) * tan(wp * t / 2.0);
+        h /= 1.0 + s / wp;
+    }
+    if (design.integrator) h /= s;
+    return h;
+}
+
+/** Discrete response of coefficients at angular frequency w. */
+Complex discrete(const CompensatorCoefficients_t & coeffs, double w, double t) {
+    Complex z1 = std::exp(Complex(0.0, -w * t));
+    Complex num = 0.0;
+    Complex den = 0.0;
+    Complex zk = 1.0;
+    for (uint8_t k = 0; k <= coeffs.order; ++k) {
+        num += (double) coeffs.b[k] * zk;
+        den += (double) coeffs.a[k] * zk;
+        zk *= z1;
+    }
+    return num / den;
+}
+
+/** Measured response of the runtime compensator, by I/Q demodulation. */
+Complex measured(const CompensatorCoefficients_t & coeffs, double f, double fs) {
+    // Integer number of samples per period so whole period sums are exact.
+    int samplesPerPeriod = (int) round(fs / f);
+    f = fs / samplesPerPeriod;
+    Compensator_t comp = CompensatorInit(coeffs, 1E9f, -1E9f);
+    CompensatorReset(&comp, 0.0f);
+
+    double xi = 0.0, xq = 0.0, yi = 0.0, yq = 0.0;
+    int settle = 200 * samplesPerPeriod;
+    int measure = 20 * samplesPerPeriod;
+    for (int n = 0; n < settle + measure; ++n) {
+        double phase = 2.0 * M_PI * f * n / fs;
+        float x = (float) (1E-3 * sin(phase));
+        float y = CompensatorStep(&comp, x);
+        if (n >= settle) {
+            xi += x * cos(phase); xq += x * sin(phase);
+            yi += y * cos(phase); yq += y * sin(phase);
+        }
+    }
+    return Complex(yq, yi) / Complex(xq, xi);
+}
+
+/** Roots in z of sum_k c[k] z^(order - k), by Durand-Kerner iteration. */
+int roots(const float * c, uint8_t order, Complex * out) {
+    for (uint8_t k = 0; k < order; ++k) out[k] = std::pow(Complex(0.4, 0.9), (double) k);
+    for (int iter = 0; iter < 500; ++iter) {
+        for (uint8_t k = 0; k < order; ++k) {
+            Complex p = 1.0;
+            for (uint8_t j = 1; j <= order; ++j) p = p * out[k] + (double) (c[j] / c[0]);
+            Complex q = 1.0;
+            for (uint8_t j = 0; j < order; ++j) if (j != k) q *= out[k] - out[j];
+            out[k] -= p / q;
+        }
+    }
+    return order;
+}
+
+/**
+ * Maps discrete roots back to continuous corner frequencies (Hz), undoing
+ * the Tustin transform and the prewarp. Roots at z = 1 (integrator) and
+ * z = -1 (from the transform) carry no corner and are skipped. Returns the
+ * corners in ascending order.
+ */
+int corners(const float * c, uint8_t order, double fs, double * out) {
+    Complex z[COMPENSATOR_MAX_ORDER];
+    roots(c, order, z);
+    int count = 0;
+    for (uint8_t k = 0; k < order; ++k) {
+        if (std::abs(z[k] - 1.0) < 1E-3 || std::abs(z[k] + 1.0) < 1E-3) continue;
+        double w = -std::real(2.0 * fs * (z[k] - 1.0) / (z[k] + 1.0));
+        out[count++] = atan(w / (2.0 * fs)) * fs / M_PI;
+    }
+    for (int i = 0; i < count; ++i)
+        for (int j = i + 1; j < count; ++j)
+            if (out[j] < out[i]) { double tmp = out[i]; out[i] = out[j]; out[j] = tmp; }
+    return count;
+}
+
+/** Checks that the discrete corners land on the designed ones, within 1%. */
+bool checkCorners(const char * kind, const double * designed, int numDesigned, const float * c, uint8_t order, double fs) {
+    double found[COMPENSATOR_MAX_ORDER];
+    int count = corners(c, order, fs, found);
+    bool pass = count == numDesigned;
+    printf("    %s (Hz): designed", kind);
+    for (int k = 0; k < numDesigned; ++k) printf(" %.1f", designed[k]);
+    printf(", discrete");
+    for (int k = 0; k < count; ++k) {
+        printf(" %.1f", found[k]);
+        if (pass) pass = fabs(found[k] / designed[k] - 1.0) < 1E-2;
+    }
+    printf("\n");
+    return pass;
+}
+
+double db(Complex h) { return 20.0 * log10(std::abs(h)); }
+double deg(Complex h) { return std::arg(h) * 180.0 / M_PI; }
+double phaseError(Complex a, Complex b) { return fabs(deg(a / b)); }
+
+bool check(const char * name, const CompensatorDesign_t & design, const CompensatorCoefficients_t & coeffs) {
+    double t = 1.0 / design.sampleRate;
+    double maxExact = 0.0, maxDesignDb = 0.0, maxDesignDeg = 0.0, maxRuntimeDb = 0.0, maxRuntimeDeg = 0.0;
+
+    printf("%s: b = [%g, %g, %g, %g], a = [%g, %g, %g, %g]\n", name,
+        coeffs.b[0], coeffs.b[1], coeffs.b[2], coeffs.b[3],
+        coeffs.a[0], coeffs.a[1], coeffs.a[2], coeffs.a[3]);
+    bool pass = checkCorners("zeros", design.zeros, design.numZeros, coeffs.b, coeffs.order, design.sampleRate);
+    pass &= checkCorners("poles", design.poles, design.numPoles, coeffs.a, coeffs.order, design.sampleRate);
+    printf("    %10s %10s %10s %10s %10s %10s %10s\n",
+        "f (Hz)", "design dB", "deg", "discrete dB", "deg", "runtime dB", "deg");
+    for (int i = 0; i <= 30; ++i) {
+        // Log spaced from 10 Hz to 0.45 fs.
+        double f = 10.0 * pow(0.45 * design.sampleRate / 10.0, i / 30.0);
+        double w = 2.0 * M_PI * f;
+        Complex hd = discrete(coeffs, w, t);
+
+        // Tustin maps the discrete frequency w to (2/T) tan(w T / 2) exactly,
+        // so with prewarped corners the match is exact up to float rounding.
+        Complex hw = continuous(design, (2.0 / t) * tan(w * t / 2.0), true);
+        double exact = std::abs(hd / hw - 1.0);
+        if (exact > maxExact) maxExact = exact;
+
+        // Against the unwarped design, the prewarped corners trade some
+        // phase well below a corner close to Nyquist. Reported, not checked.
+        Complex hc = continuous(design, w, false);
+        if (f <= design.sampleRate / 10.0) {
+            if (fabs(db(hd) - db(hc)) > maxDesignDb) maxDesignDb = fabs(db(hd) - db(hc));
+            if (phaseError(hd, hc) > maxDesignDeg) maxDesignDeg = phaseError(hd, hc);
+        }
+
+        // Compare the runtime against the coefficients at the snapped
+        // frequency, with at least 4 samples per period.
+        if (round(design.sampleRate / f) < 4) continue;
+        double fSnapped = design.sampleRate / round(design.sampleRate / f);
+        Complex hm = measured(coeffs, f, design.sampleRate);
+        Complex hs = discrete(coeffs, 2.0 * M_PI * fSnapped, t);
+        if (fabs(db(hm) - db(hs)) > maxRuntimeDb) maxRuntimeDb = fabs(db(hm) - db(hs));
+        if (phaseError(hm, hs) > maxRuntimeDeg) maxRuntimeDeg = phaseError(hm, hs);
+
+        if (i % 3 == 0) {
+            printf("    %10.1f %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                f, db(hc), deg(hc), db(hd), deg(hd), db(hs), deg(hs));
+        }
+    }
+
+    pass &= maxExact < 1E-3 && maxRuntimeDb < 0.05 && maxRuntimeDeg < 0.5;
+    printf("    prewarped design: max relative error %.2e\n", maxExact);
+    printf("    design (<= fs/10): max %.3f dB, %.3f deg\n", maxDesignDb, maxDesignDeg);
+    printf("    runtime vs coefficients: max %.4f dB, %.4f deg\n", maxRuntimeDb, maxRuntimeDeg);
+    printf("    %s\n", pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+bool checkClamp(void) {
+    // A saturated compensator must come off the rail as soon as the error
+    // reverses, instead of unwinding an accumulated integral first.
+    Compensator_t comp = CompensatorInit(COEFFS_II, 0.9f, 0.1f);
+    for (int n = 0; n < 10000; ++n) CompensatorStep(&comp, 1.0f);
+    float railed = comp.y[0];
+    int steps = 0;
+    while (CompensatorStep(&comp, -1.0f) >= 0.9f && steps < 10000) ++steps;
+    bool pass = railed == 0.9f && steps < 5;
+    printf("Clamp: railed at %.2f, left the rail after %d steps. %s\n", railed, steps, pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+int main() {
+    bool pass = true;
+    pass &= check("Type II (2p2z)", TYPE_II, COEFFS_II);
+    pass &= check("Type III (3p3z)", TYPE_III, COEFFS_III);
+    pass &= checkClamp();
+    return pass ? 0 : 1;
+}
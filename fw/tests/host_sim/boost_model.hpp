@@ -0,0 +1,86 @@
+/**
+ * @file boost_model.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Averaged model of the synchronous boost stage for the host
+ *        simulation, with a PV array on the input and a stiff battery on the
+ *        output.
+ * @version 0.1
+ * @date 2023-08-25
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include "./pv_model.hpp"
+
+
+/*
+State is the array (input capacitor) voltage and the inductor current:
+
+    C_i dv_arr/dt = i_pv(v_arr) - i_L
+    L   di_L/dt   = v_arr - r_L i_L - (1 - d) v_batt
+
+The battery is an ideal voltage source; its current is (1 - d) i_L. The model
+is integrated with semi-implicit Euler, which stays stable for the stiff PV
+branch near v_oc as long as the step is a few microseconds or less.
+*/
+
+/** @brief Definition of the averaged boost stage. */
+typedef struct BoostModel {
+    /** @brief Inductance (H). */
+    double l;
+
+    /** @brief Input capacitance (F). */
+    double ci;
+
+    /** @brief Inductor DCR (Ohms). */
+    double rL;
+
+    /** @brief Battery voltage (V). */
+    double vBatt;
+
+    /** @brief Array voltage (V). */
+    double vArr;
+
+    /** @brief Inductor current (A). */
+    double iL;
+
+    /** @brief Array current at the last step (A). */
+    double iArr;
+} BoostModel_t;
+
+/**
+ * @brief BoostModelInit returns the v0.1.0 board: 155 uH, 15 uF input
+ *        capacitance (see docs/DESIGN.md), resting at open circuit.
+ */
+inline BoostModel_t BoostModelInit(double vBatt, double voc) {
+    BoostModel_t model = { 155E-6, 15E-6, 0.1, vBatt, voc, 0.0, 0.0 };
+    return model;
+}
+
+/** @brief Advances the model by dt with duty cycle d. */
+inline void BoostModelStep(BoostModel_t * model, const PVCurve_t * curve, double d, double dt) {
+    model->iL += (model->vArr - model->rL * model->iL - (1 - d) * model->vBatt) / model->l * dt;
+    model->iArr = PVCurveCurrent(curve, model->vArr);
+    model->vArr += (model->iArr - model->iL) / model->ci * dt;
+    if (model->vArr < 0.0) model->vArr = 0.0;
+}
+
+/**
+ * @brief Advances the model by dt with the gate driver disabled. Both switches
+ *        are off; the inductor current freewheels into the battery through the
+ *        high side body diode until it reaches zero, or, if it was negative,
+ *        through the low side body diode.
+ */
+inline void BoostModelStepOpen(BoostModel_t * model, const PVCurve_t * curve, double dt) {
+    if (model->iL > 0.0) {
+        model->iL += (model->vArr - model->rL * model->iL - model->vBatt) / model->l * dt;
+        if (model->iL < 0.0) model->iL = 0.0;
+    } else if (model->iL < 0.0) {
+        model->iL += (model->vArr - model->rL * model->iL) / model->l * dt;
+        if (model->iL > 0.0) model->iL = 0.0;
+    }
+    model->iArr = PVCurveCurrent(curve, model->vArr);
+    model->vArr += (model->iArr - model->iL) / model->ci * dt;
+    if (model->vArr < 0.0) model->vArr = 0.0;
+}
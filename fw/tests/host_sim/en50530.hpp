@@ -0,0 +1,133 @@
+/**
+ * @file en50530.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief EN 50530 style static and dynamic MPPT efficiency profiles for the
+ *        host simulation.
+ * @version 0.1
+ * @date 2023-09-02
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <math.h>
+
+/** Device Specific imports. */
+#include "./pv_model.hpp"
+#include "./simulation.hpp"
+
+
+/*
+The static test holds the array at each of EN50530_STATIC_LEVELS, and weights
+the settled efficiencies with the European efficiency weights.
+
+The dynamic tests follow the ramp sequences of EN 50530: after a dwell at the
+low level, every cycle ramps up to the high level at the given slope, dwells,
+ramps down and dwells again. The dynamic efficiency is the settled efficiency
+from the end of the first dwell, so the initial search from the start voltage
+does not count.
+
+The full sequences are hours long. The quick set runs one cycle of each ramp
+from 10 W/m^2/s, where trackers differ; the slow ramps only approach the
+static efficiency.
+
+The low irradiance check runs the static levels up to EN50530_CHECK_LEVEL
+only, where sensor noise swamps the power change of a minimum step, and fails
+if a tracker settles below EN50530_CHECK_MIN of the available power.
+
+Rebuilding the I-V curve dominates the run time, so a ramp only updates the
+array once the irradiance moved by EN50530_RESOLUTION (relative).
+*/
+
+#define EN50530_DWELL 10.0 // s
+#define EN50530_RESOLUTION 5E-3
+#define EN50530_STATIC_SETTLE 5.0 // s, before the static efficiency counts.
+#define EN50530_STATIC_DURATION 8.0 // s
+#define EN50530_QUICK_SLOPE 10.0 // W/m^2/s, slowest ramp of the quick set.
+#define EN50530_CHECK_LEVEL 200.0 // W/m^2, highest static level of the low irradiance check.
+#define EN50530_CHECK_MIN 0.98 // Static efficiency the check requires at every level up to it.
+
+/** @brief Definition of a ramp test. */
+typedef struct EN50530Ramp {
+    /** @brief Low irradiance level (W/m^2). */
+    double low;
+
+    /** @brief High irradiance level (W/m^2). */
+    double high;
+
+    /** @brief Ramp slope (W/m^2/s). */
+    double slope;
+
+    /** @brief Number of up and down cycles. */
+    int cycles;
+} EN50530Ramp_t;
+
+/** @brief Irradiance levels of the static test (W/m^2), and their weights. */
+static const double EN50530_STATIC_LEVELS[] = { 50.0, 100.0, 200.0, 300.0, 500.0, 1000.0 };
+static const double EN50530_STATIC_WEIGHTS[] = { 0.03, 0.06, 0.13, 0.10, 0.48, 0.20 };
+#define EN50530_NUM_STATIC (sizeof(EN50530_STATIC_LEVELS) / sizeof(EN50530_STATIC_LEVELS[0]))
+
+/** @brief Ramp sequences: 10 to 50 % and 30 to 100 % of 1000 W/m^2. */
+static const EN50530Ramp_t EN50530_RAMPS[] = {
+    { 100.0, 500.0, 0.5, 2 },
+    { 100.0, 500.0, 1.0, 2 },
+    { 100.0, 500.0, 2.0, 3 },
+    { 100.0, 500.0, 3.0, 4 },
+    { 100.0, 500.0, 5.0, 6 },
+    { 100.0, 500.0, 7.0, 8 },
+    { 100.0, 500.0, 10.0, 10 },
+    { 100.0, 500.0, 14.0, 10 },
+    { 100.0, 500.0, 20.0, 10 },
+    { 100.0, 500.0, 30.0, 10 },
+    { 100.0, 500.0, 50.0, 10 },
+    { 300.0, 1000.0, 10.0, 10 },
+    { 300.0, 1000.0, 14.0, 10 },
+    { 300.0, 1000.0, 20.0, 10 },
+    { 300.0, 1000.0, 30.0, 10 },
+    { 300.0, 1000.0, 50.0, 10 },
+    { 300.0, 1000.0, 100.0, 10 },
+};
+#define EN50530_NUM_RAMPS (sizeof(EN50530_RAMPS) / sizeof(EN50530_RAMPS[0]))
+
+/** @brief Length of a ramp test with the given number of cycles (s). */
+inline double EN50530RampDuration(const EN50530Ramp_t * ramp, int cycles) {
+    double rise = (ramp->high - ramp->low) / ramp->slope;
+    return EN50530_DWELL + cycles * 2.0 * (rise + EN50530_DWELL);
+}
+
+/** @brief Static profile; data points to the irradiance (W/m^2). */
+inline enum SimChange EN50530Static(double t, PVArray_t * array, const void * data) {
+    double g = *(const double *) data;
+    if (array->irradiance[0] == g) return SIM_UNCHANGED;
+    PVArraySetIrradiance(array, g);
+    return SIM_EVENT;
+}
+
+/** @brief Ramp profile; data points to an EN50530Ramp_t. */
+inline enum SimChange EN50530Dynamic(double t, PVArray_t * array, const void * data) {
+    const EN50530Ramp_t * ramp = (const EN50530Ramp_t *) data;
+    double rise = (ramp->high - ramp->low) / ramp->slope;
+    double phase = fmod(t - EN50530_DWELL, 2.0 * (rise + EN50530_DWELL));
+    double g = ramp->low;
+    bool plateau = true;
+    if (t < EN50530_DWELL) {
+        g = ramp->low;
+    } else if (phase < rise) {
+        g = ramp->low + ramp->slope * phase;
+        plateau = false;
+    } else if (phase < rise + EN50530_DWELL) {
+        g = ramp->high;
+    } else if (phase < 2.0 * rise + EN50530_DWELL) {
+        g = ramp->high - ramp->slope * (phase - rise - EN50530_DWELL);
+        plateau = false;
+    }
+
+    if (plateau) {
+        if (array->irradiance[0] == g) return SIM_UNCHANGED;
+        PVArraySetIrradiance(array, g);
+        return SIM_EVENT;
+    }
+    if (fabs(g - array->irradiance[0]) < EN50530_RESOLUTION * g) return SIM_UNCHANGED;
+    PVArraySetIrradiance(array, g);
+    return SIM_DRIFT;
+}
@@ -0,0 +1,866 @@
+/**
+ * @file main.cpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Host simulation of the MPPT trackers. Reports the tracking efficiency,
+ *        steady state efficiency and convergence time of each tracker over a
+ *        set of irradiance profiles, the detection latency and false
+ *        detections of the change detector, the accuracy and cost of the
+ *        tracking efficiency meter, and two channels run from one tick loop.
+ * @version 0.1
+ * @date 2023-08-25
+ * @note Runs on the host, not the Sunscatter. Build and run from this folder:
+ *       g++ -std=gnu++14 -O2 -Wall -pthread -o host_sim main.cpp ../../inc/Filter/Filter.cpp ../../inc/cascaded_controller/cascaded_controller.cpp ../../inc/control_arbiter/control_arbiter.cpp ../../inc/mppt/perturb_observe.cpp ../../inc/mppt/incremental_conductance.cpp ../../inc/mppt/global_scan.cpp ../../inc/mppt/extremum_seeking.cpp ../../inc/mppt/model_predictor.cpp ../../inc/mppt/fractional_voc.cpp ../../inc/mppt/change_detector.cpp ../../inc/mppt/efficiency_meter.cpp ../../inc/mppt/mppt_strategy.cpp ../../inc/mpc/explicit_mpc.cpp ../../inc/channel_control/channel_control.cpp && ./host_sim
+ *       Pass `trace [profile] [scan]` to print a CSV trace of the first
+ *       tracker instead of the report. Pass `en50530 [full] [tracker]` for
+ *       the EN 50530 static and dynamic efficiencies instead, of one tracker
+ *       or all of them, or `en50530 check` to fail unless the step trackers
+ *       reach EN50530_CHECK_MIN at low irradiance. Pass `skew` for the bias
+ *       of the array power from the time skew of the voltage and current
+ *       conversions instead, or `control` for the settling time, overshoot
+ *       and constraint violations of the cascaded PI loops and the explicit
+ *       MPC over the same reference and irradiance steps. Pass `ripple` for
+ *       what the mid-on and mid-off conversions of the switched plant see of
+ *       the slope of the array power. Pass `switching` first to switch the
+ *       plant within every PWM period instead of averaging it (slower). Runs
+ *       go in parallel on all hardware threads. The quick EN 50530 set
+ *       simulates about 1000 s per tracker, which takes about 35 s on one
+ *       core: name the tracker under change to score it in under a minute, or
+ *       run all of them on 4 or more threads.
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../../inc/mppt/change_detector.hpp"
+#include "../../inc/mppt/extremum_seeking.hpp"
+#include "../../inc/mppt/fractional_voc.hpp"
+#include "../../inc/mppt/global_scan.hpp"
+#include "../../inc/mppt/incremental_conductance.hpp"
+#include "../../inc/mppt/model_predictor.hpp"
+#include "../../inc/mppt/mppt_strategy.hpp"
+#include "../../inc/mppt/perturb_observe.hpp"
+#include "./en50530.hpp"
+#include "./simulation.hpp"
+#include "./skew.hpp"
+
+#define ARR_V_MAX 70.0 // V, below the INP_OVL redline.
+#define ARR_V_MIN 20.0 // V
+#define ARR_V_START 45.0 // V, away from the MPP to measure convergence.
+#define ARR_VOC_COLD 76.0 // V, 100 cells at 0 C.
+#define ARR_SUBSTRINGS 5
+#define SCAN_INTERVAL 2080 // Outer ticks, 2 s.
+#define SCAN_BACKSTOP 624000 // Outer ticks, 10 min, with the change detector.
+#define ARR_CELLS 100
+#define ARR_R_S 0.0035 // Ohms per cell.
+#define ARR_R_SH 40.0 // Ohms per cell.
+#define VOC_K 0.86 // Initial fraction of V_oc at the MPP, V_mpp / V_oc of the cell at STC.
+#define VOC_WINDOW 10 // Inner ticks.
+#define VOC_INTERVAL 21 // Tracker steps, 1 s.
+#define METER_AMPLITUDE 1.5 // V
+#define METER_POINTS 5
+#define METER_SETTLE 16 // Outer ticks.
+#define METER_AVERAGE 16 // Outer ticks.
+#define METER_INTERVAL 5200 // Outer ticks, 5 s.
+#define METER_DURATION 60.0 // s
+
+/**
+ * Constant 800 W/m^2, for the steady state loss. Below 1000 W/m^2 since at STC
+ * I_mpp (5.9 A) clips the 5.79 A full scale of the array current sensor.
+ */
+enum SimChange profile_constant(double t, PVArray_t * array, const void *) {
+    if (array->irradiance[0] == 800.0) return SIM_UNCHANGED;
+    PVArraySetIrradiance(array, 800.0);
+    return SIM_EVENT;
+}
+
+/** Irradiance steps: 1000 W/m^2, 400 W/m^2 at 3 s, 800 W/m^2 at 6 s. */
+enum SimChange profile_steps(double t, PVArray_t * array, const void *) {
+    double g = t < 3.0 ? 1000.0 : t < 6.0 ? 400.0 : 800.0;
+    if (array->irradiance[0] == g) return SIM_UNCHANGED;
+    PVArraySetIrradiance(array, g);
+    return SIM_EVENT;
+}
+
+/**
+ * Cloud edge: ramps 1000 to 300 W/m^2 over 1 s and back, held in between.
+ * Convergence is measured from the end of each ramp.
+ */
+enum SimChange profile_ramp(double t, PVArray_t * array, const void *) {
+    double g = 1000.0;
+    if (t >= 2.0 && t < 3.0) g = 1000.0 - 700.0 * (t - 2.0);
+    else if (t >= 3.0 && t < 5.0) g = 300.0;
+    else if (t >= 5.0 && t < 6.0) g = 300.0 + 700.0 * (t - 5.0);
+    if (array->irradiance[0] == g) return SIM_UNCHANGED;
+    bool plateau = g == 300.0 || g == 1000.0;
+    PVArraySetIrradiance(array, g);
+    return plateau ? SIM_EVENT : SIM_DRIFT;
+}
+
+/**
+ * Partial shading: uniform 1000 W/m^2, then two substrings shaded to 300 W/m^2
+ * at 3 s, then a gradient at 6 s. The shaded curves have their global maximum
+ * well below the local maximum next to the unshaded MPP.
+ */
+enum SimChange profile_shade(double t, PVArray_t * array, const void *) {
+    static const double patterns[3][5] = {
+        { 1000.0, 1000.0, 1000.0, 1000.0, 1000.0 },
+        { 1000.0, 1000.0, 1000.0, 300.0, 300.0 },
+        { 1000.0, 600.0, 600.0, 300.0, 300.0 },
+    };
+    const double * g = patterns[t < 3.0 ? 0 : t < 6.0 ? 1 : 2];
+    bool changed = false;
+    for (int k = 0; k < array->numSubstrings; ++k) {
+        if (array->irradiance[k] != g[k]) changed = true;
+        array->irradiance[k] = g[k];
+    }
+    return changed ? SIM_EVENT : SIM_UNCHANGED;
+}
+
+void trace(double t, const BoostModel_t * model, const PVCurve_t * curve, float reference) {
+    printf("%f, %f, %f, %f, %f, %f\n", t, reference, model->vArr, model->vArr * model->iArr, curve->vmpp, curve->pmpp);
+}
+
+/** Every strategy from ARR_V_START, P&O with po, and `id` selected. */
+MPPT_t trackers_mppt(PerturbObserve_t po, enum MPPTStrategyID id) {
+    return MPPTInit(
+        po,
+        IncrementalConductanceInit(ARR_V_MAX, ARR_V_MIN, 2.0, 0.25, 0.2, 3.0, SIM_MPPT_WINDOW * 4, ARR_V_START),
+        ExtremumSeekingInit(ARR_V_MAX, ARR_V_MIN, 0.5, 2.0, 0.5, ARR_V_START),
+        FractionalVocInit(ARR_V_MAX, ARR_V_MIN, VOC_K, 0.25, 0.2, VOC_WINDOW, VOC_INTERVAL, ARR_V_START),
+        id,
+        ARR_V_START
+    );
+}
+
+/**
+ * Every tracker under test. Each run initializes its own, so runs can go in
+ * parallel. The predicted ones run P&O, with the model at the array
+ * temperature, 20 K off, and the trained table 20 K off; with scans, the V_oc
+ * measured after every scan sets their temperature.
+ */
+#define NUM_TRACKERS 8
+typedef struct {
+    SimTracker_t list[NUM_TRACKERS];
+} Trackers_t;
+
+void trackers_init(Trackers_t * t) {
+    PerturbObserve_t poAdaptive = PerturbObserveInit(ARR_V_MAX, ARR_V_MIN, 2.0, 0.25, 0.2, ARR_V_START);
+    PerturbObserve_t poFixed = PerturbObserveInit(ARR_V_MAX, ARR_V_MIN, 0.5, 0.5, 0.0, ARR_V_START);
+    ModelPredictor_t none = ModelPredictor_t();
+    SimTracker_t list[NUM_TRACKERS] = {
+        { "P&O adaptive", trackers_mppt(poAdaptive, MPPT_PERTURB_OBSERVE), false, none },
+        { "IncCond", trackers_mppt(poAdaptive, MPPT_INCREMENTAL_CONDUCTANCE), false, none },
+        { "P&O fixed 0.5 V", trackers_mppt(poFixed, MPPT_PERTURB_OBSERVE), false, none },
+        { "Extremum seeking", trackers_mppt(poAdaptive, MPPT_EXTREMUM_SEEKING), false, none },
+        {
+            "P&O + model", trackers_mppt(poAdaptive, MPPT_PERTURB_OBSERVE), true,
+            ModelPredictorInit(ARR_CELLS, ARR_R_S, ARR_R_SH, ARR_V_MAX, ARR_V_MIN, 0.1, 1.0, PV_T_REF, false)
+        },
+        {
+            "P&O + model, 20 K off", trackers_mppt(poAdaptive, MPPT_PERTURB_OBSERVE), true,
+            ModelPredictorInit(ARR_CELLS, ARR_R_S, ARR_R_SH, ARR_V_MAX, ARR_V_MIN, 0.1, 1.0, PV_T_REF + 20.0, false)
+        },
+        {
+            "P&O + table", trackers_mppt(poAdaptive, MPPT_PERTURB_OBSERVE), true,
+            ModelPredictorInit(ARR_CELLS, ARR_R_S, ARR_R_SH, ARR_V_MAX, ARR_V_MIN, 0.1, 1.0, PV_T_REF + 20.0, true)
+        },
+        { "Fractional Voc", trackers_mppt(poAdaptive, MPPT_FRACTIONAL_VOC), false, none },
+    };
+    for (int k = 0; k < NUM_TRACKERS; ++k) t->list[k] = list[k];
+}
+
+/** Runs job(k) for every k below count on all hardware threads. */
+template <typename Job>
+void run_parallel(size_t count, Job job) {
+    std::atomic<size_t> next(0);
+    unsigned numWorkers = std::thread::hardware_concurrency();
+    if (numWorkers == 0) numWorkers = 1;
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < numWorkers; ++w) {
+        workers.emplace_back([&]() {
+            for (size_t k = next++; k < count; k = next++) job(k);
+        });
+    }
+    for (auto & worker : workers) worker.join();
+}
+
+/** Runs tracker k of a fresh set. */
+SimMetrics_t run_tracker(size_t k, SimConfig_t config) {
+    Trackers_t trackers;
+    trackers_init(&trackers);
+    return SimRun(trackers.list[k], config);
+}
+
+/** Runs tracker k of a fresh set on each of NUM_CHANNELS channels. */
+#define NUM_CHANNELS 2
+SimLoad_t run_channels(size_t k, const SimConfig_t * configs, bool staggered, SimMetrics_t * metrics) {
+    Trackers_t trackers[NUM_CHANNELS];
+    SimTracker_t list[NUM_CHANNELS];
+    for (size_t c = 0; c < NUM_CHANNELS; ++c) {
+        trackers_init(&trackers[c]);
+        list[c] = trackers[c].list[k];
+    }
+    return SimRunChannels(list, configs, NUM_CHANNELS, staggered, metrics);
+}
+
+/**
+ * EN 50530 static and dynamic efficiencies of the trackers named `only`, or
+ * all of them, over the quick or the full ramp set.
+ */
+void en50530(bool full, const char * only, bool switching) {
+    Trackers_t names;
+    trackers_init(&names);
+    std::vector<size_t> selected;
+    for (size_t k = 0; k < NUM_TRACKERS; ++k) {
+        if (only == NULL || strcmp(only, names.list[k].name) == 0) selected.push_back(k);
+    }
+    std::vector<const EN50530Ramp_t *> ramps;
+    for (size_t r = 0; r < EN50530_NUM_RAMPS; ++r) {
+        if (full || EN50530_RAMPS[r].slope >= EN50530_QUICK_SLOPE) ramps.push_back(&EN50530_RAMPS[r]);
+    }
+
+    /* Every tracker runs every static level and every ramp. */
+    size_t perTracker = EN50530_NUM_STATIC + ramps.size();
+    std::vector<SimMetrics_t> results(selected.size() * perTracker);
+    std::vector<double> durations(results.size());
+    auto start = std::chrono::steady_clock::now();
+    run_parallel(results.size(), [&](size_t job) {
+        size_t test = job % perTracker;
+        SimConfig_t config = {
+            EN50530_STATIC_DURATION, 100.0, 0.05, 0.01, ARR_V_START, &EN50530Static, NULL,
+            NULL, SCAN_INTERVAL, switching, &EN50530_STATIC_LEVELS[test], EN50530_STATIC_SETTLE
+        };
+        if (test >= EN50530_NUM_STATIC) {
+            const EN50530Ramp_t * ramp = ramps[test - EN50530_NUM_STATIC];
+            config.duration = EN50530RampDuration(ramp, full ? ramp->cycles : 1);
+            config.profile = &EN50530Dynamic;
+            config.profileData = ramp;
+            config.settle = EN50530_DWELL;
+        }
+        durations[job] = config.duration;
+        results[job] = run_tracker(selected[job / perTracker], config);
+    });
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double simulated = 0.0;
+    for (double d : durations) simulated += d;
+
+    printf("EN 50530, %s ramp set\n", full ? "full" : "quick");
+    printf("Static MPPT efficiency (%%), from %.0f s at each level (W/m^2)\n", EN50530_STATIC_SETTLE);
+    printf("    %-24s", "tracker");
+    for (size_t l = 0; l < EN50530_NUM_STATIC; ++l) printf(" %7.0f", EN50530_STATIC_LEVELS[l]);
+    printf(" %9s\n", "weighted");
+    for (size_t k = 0; k < selected.size(); ++k) {
+        printf("    %-24s", names.list[selected[k]].name);
+        for (size_t l = 0; l < EN50530_NUM_STATIC; ++l) {
+            printf(" %7.2f", 100.0 * SimMetricsSettledEfficiency(&results[k * perTracker + l]));
+        }
+        double weighted = 0.0;
+        for (size_t l = 0; l < EN50530_NUM_STATIC; ++l) {
+            weighted += EN50530_STATIC_WEIGHTS[l] * SimMetricsSettledEfficiency(&results[k * perTracker + l]);
+        }
+        printf(" %9.2f\n", 100.0 * weighted);
+    }
+
+    /* One table per sequence, with a column per slope. */
+    for (size_t r = 0; r < ramps.size();) {
+        size_t end = r;
+        while (end < ramps.size() && ramps[end]->low == ramps[r]->low && ramps[end]->high == ramps[r]->high) ++end;
+        printf(
+            "Dynamic MPPT efficiency (%%), %.0f to %.0f W/m^2 at (W/m^2/s)\n",
+            ramps[r]->low,
+            ramps[r]->high
+        );
+        printf("    %-24s", "tracker");
+        for (size_t c = r; c < end; ++c) printf(" %7g", ramps[c]->slope);
+        printf("\n");
+        for (size_t k = 0; k < selected.size(); ++k) {
+            printf("    %-24s", names.list[selected[k]].name);
+            for (size_t c = r; c < end; ++c) {
+                printf(" %7.2f", 100.0 * SimMetricsSettledEfficiency(&results[k * perTracker + EN50530_NUM_STATIC + c]));
+            }
+            printf("\n");
+        }
+        r = end;
+    }
+
+    printf("Summary\n");
+    printf("    %-24s %9s %9s %10s %12s\n", "tracker", "static", "dynamic", "lost (J)", "cycles/step");
+    for (size_t k = 0; k < selected.size(); ++k) {
+        double weighted = 0.0;
+        double energy = 0.0;
+        double available = 0.0;
+        double cycles = 0.0;
+        long steps = 0;
+        for (size_t test = 0; test < perTracker; ++test) {
+            const SimMetrics_t * metrics = &results[k * perTracker + test];
+            if (test < EN50530_NUM_STATIC) {
+                weighted += EN50530_STATIC_WEIGHTS[test] * SimMetricsSettledEfficiency(metrics);
+            } else {
+                energy += metrics->settledEnergy;
+                available += metrics->settledAvailable;
+            }
+            cycles += metrics->stepCycles;
+            steps += metrics->steps;
+        }
+        printf(
+            "    %-24s %8.2f%% %8.2f%% %10.1f %12.0f\n",
+            names.list[selected[k]].name,
+            100.0 * weighted,
+            100.0 * energy / available,
+            available - energy,
+            steps > 0 ? cycles / steps : 0.0
+        );
+    }
+    unsigned threads = std::thread::hardware_concurrency();
+    printf("Simulated %.0f s in %.1f s on %u thread%s.\n", simulated, elapsed, threads, threads == 1 ? "" : "s");
+}
+
+/**
+ * EN 50530 static efficiencies at low irradiance of the step trackers, which
+ * decide on the power change of a step against the sensor noise.
+ *
+ * @return Whether every tracker settles above EN50530_CHECK_MIN.
+ */
+bool en50530_check(bool switching) {
+    static const size_t CHECKED[] = { 0, 1, 2 };
+    size_t numChecked = sizeof(CHECKED) / sizeof(CHECKED[0]);
+    std::vector<double> levels;
+    for (size_t l = 0; l < EN50530_NUM_STATIC; ++l) {
+        if (EN50530_STATIC_LEVELS[l] <= EN50530_CHECK_LEVEL) levels.push_back(EN50530_STATIC_LEVELS[l]);
+    }
+    std::vector<SimMetrics_t> results(numChecked * levels.size());
+    run_parallel(results.size(), [&](size_t job) {
+        SimConfig_t config = {
+            EN50530_STATIC_DURATION, 100.0, 0.05, 0.01, ARR_V_START, &EN50530Static, NULL,
+            NULL, SCAN_INTERVAL, switching, &levels[job % levels.size()], EN50530_STATIC_SETTLE
+        };
+        results[job] = run_tracker(CHECKED[job / levels.size()], config);
+    });
+
+    Trackers_t names;
+    trackers_init(&names);
+    bool passed = true;
+    printf("EN 50530 low irradiance check, static MPPT efficiency (%%) at least %.0f%%\n", 100.0 * EN50530_CHECK_MIN);
+    printf("    %-24s", "tracker");
+    for (double level : levels) printf(" %7.0f ", level);
+    printf("\n");
+    for (size_t k = 0; k < numChecked; ++k) {
+        printf("    %-24s", names.list[CHECKED[k]].name);
+        for (size_t l = 0; l < levels.size(); ++l) {
+            double efficiency = SimMetricsSettledEfficiency(&results[k * levels.size() + l]);
+            if (efficiency < EN50530_CHECK_MIN) passed = false;
+            printf(" %7.2f%c", 100.0 * efficiency, efficiency < EN50530_CHECK_MIN ? '!' : ' ');
+        }
+        printf("\n");
+    }
+    printf("%s\n", passed ? "Passed." : "Failed.");
+    return passed;
+}
+
+/**
+ * Bias of the array power from the skew of the voltage and current
+ * conversions, for every conversion order, at full and partial sun.
+ */
+void skew(void) {
+    static const double IRRADIANCES[] = { 1000.0, 300.0 };
+    size_t numIrradiances = sizeof(IRRADIANCES) / sizeof(IRRADIANCES[0]);
+    std::vector<SkewScheme_t> schemes = SkewSchemes();
+    std::vector<SkewResult_t> results(numIrradiances * schemes.size());
+    run_parallel(numIrradiances, [&](size_t g) {
+        SkewTrace_t trace = SkewRecord(IRRADIANCES[g], 100.0);
+        for (size_t k = 0; k < schemes.size(); ++k) {
+            results[g * schemes.size() + k] = SkewEvaluate(&trace, &schemes[k], 1);
+        }
+    });
+
+    for (size_t g = 0; g < numIrradiances; ++g) {
+        printf(
+            "Power sample error (W) at %.0f W/m^2, MPP, +-%g duty dither every %d ticks\n",
+            IRRADIANCES[g],
+            SKEW_DITHER,
+            SKEW_HALF
+        );
+        printf(
+            "    %-16s %-8s %10s %10s %12s %12s %10s\n",
+            "timing", "order", "bias", "RMS", "step bias", "step RMS", "step"
+        );
+        for (size_t k = 0; k < schemes.size(); ++k) {
+            const SkewResult_t & result = results[g * schemes.size() + k];
+            printf(
+                "    %-16s %-8s %10.4f %10.4f %12.4f %12.4f %10.3f\n",
+                schemes[k].timing,
+                schemes[k].order,
+                result.bias,
+                result.rms,
+                result.stepBias,
+                result.stepRms,
+                result.step
+            );
+        }
+    }
+}
+
+/**
+ * What the mid-on and mid-off conversions of the switched plant see of the
+ * slope of the array power, the signal of switching ripple correlation. At a
+ * held reference below, at and above the MPP, the duty is frozen and every
+ * PWM period gives the differences of the array voltage, the inductor current
+ * the sensor measures, and the array current it does not, from the mid-on to
+ * the mid-off point. See docs/RIPPLE_CORRELATION.md.
+ */
+void ripple(void) {
+    static const double IRRADIANCES[] = { 800.0, 100.0 };
+    static const double FRACTIONS[] = { 0.85, 1.0, 1.1 };
+    static const int PERIODS = 2000;
+    size_t numFractions = sizeof(FRACTIONS) / sizeof(FRACTIONS[0]);
+
+    printf("Switching ripple, mean mid-off minus mid-on difference over %d PWM periods\n", PERIODS);
+    printf(
+        "    %-6s %-8s %9s %9s %11s %11s %11s %11s\n",
+        "W/m^2", "V/V_mpp", "dv (V)", "dv (LSB)", "di_L (A)", "di_arr (A)", "dP_L (W)", "dP_arr (W)"
+    );
+    for (const double & irradiance : IRRADIANCES) {
+        for (size_t f = 0; f < numFractions; ++f) {
+            PVArray_t array = PVArrayInit();
+            PVArraySetIrradiance(&array, irradiance);
+            PVCurve_t curve = PVCurveBuild(&array, 2000);
+            Trackers_t trackers;
+            trackers_init(&trackers);
+            SimConfig_t config = {
+                1.0, 100.0, 0.0, 0.0, FRACTIONS[f] * curve.vmpp, &EN50530Static, NULL, NULL, SCAN_INTERVAL,
+                true, &irradiance, 0.0, NULL, NULL, false, true
+            };
+            SimChannel_t channel;
+            SimChannelInit(&channel, trackers.list[0], config, 1, 0, 0);
+
+            /* Settle on the held reference with the loops closed. */
+            double dt = SIM_INNER_DECIMATION / SIM_F_SW;
+            for (double t = 0.0; t < 0.8; t += dt) {
+                SimChannelControl(&channel, t);
+                channel.triggerDuty = channel.duty;
+                SimChannelPlant(&channel, t);
+            }
+
+            BoostModel_t & model = channel.model;
+            double d = channel.duty;
+            double midOn = (1.0 - d) / 2.0;
+            double midOff = 1.0 - d / 2.0;
+            double h = 1.0 / (SIM_F_SW * SIM_SWITCHING_SUBSTEPS);
+            double vOn = 0.0, iLOn = 0.0, iArrOn = 0.0;
+            double dv = 0.0, diL = 0.0, diArr = 0.0;
+            for (int period = 0; period < PERIODS; ++period) {
+                for (int k = 0; k < SIM_SWITCHING_SUBSTEPS; ++k) {
+                    double on = (k + 1.0) - (1.0 - d) * SIM_SWITCHING_SUBSTEPS;
+                    if (on < 0.0) on = 0.0;
+                    else if (on > 1.0) on = 1.0;
+                    BoostModelStep(&model, &curve, on, h);
+                    double before = (double) k / SIM_SWITCHING_SUBSTEPS;
+                    double after = (double) (k + 1) / SIM_SWITCHING_SUBSTEPS;
+                    if (before < midOn && midOn <= after) {
+                        vOn = model.vArr;
+                        iLOn = model.iL;
+                        iArrOn = model.iArr;
+                    }
+                    if (before < midOff && midOff <= after) {
+                        dv += (model.vArr - vOn) / PERIODS;
+                        diL += (model.iL - iLOn) / PERIODS;
+                        diArr += (model.iArr - iArrOn) / PERIODS;
+                    }
+                }
+            }
+            printf(
+                "    %-6.0f %-8.2f %9.4f %9.1f %+11.5f %+11.5f %+11.4f %+11.4f\n",
+                irradiance,
+                FRACTIONS[f],
+                dv,
+                dv / (114.0 / 4096.0),
+                diL,
+                diArr,
+                model.vArr * diL + model.iArr * dv,
+                model.vArr * diArr + model.iArr * dv
+            );
+        }
+    }
+}
+
+/** Array voltage reference and irradiance of each event of the step response. */
+struct ControlEvent { double t; double reference; double irradiance; const char * name; };
+static const ControlEvent CONTROL_EVENTS[] = {
+    { 0.5, 60.0, 800.0, "ref 55 > 60 V" },
+    { 1.0, 50.0, 800.0, "ref 60 > 50 V" },
+    { 1.5, 58.0, 800.0, "ref 50 > 58 V" },
+    { 2.0, 58.0, 300.0, "800 > 300 W/m^2" },
+    { 2.5, 58.0, 800.0, "300 > 800 W/m^2" },
+};
+#define NUM_CONTROL_EVENTS (sizeof(CONTROL_EVENTS) / sizeof(CONTROL_EVENTS[0]))
+#define CONTROL_START 55.0 // V, held at 800 W/m^2 from open circuit until the first event.
+#define CONTROL_EVENT_LENGTH 0.5 // s
+#define CONTROL_BAND 0.25 // V, settled within this of the reference.
+
+/** Irradiance of the last event of CONTROL_EVENTS due at t. */
+enum SimChange profile_control(double t, PVArray_t * array, const void *) {
+    double g = 800.0;
+    for (const ControlEvent & event : CONTROL_EVENTS) {
+        if (t >= event.t) g = event.irradiance;
+    }
+    if (array->irradiance[0] == g) return SIM_UNCHANGED;
+    PVArraySetIrradiance(array, g);
+    return SIM_EVENT;
+}
+
+/** Step response of one event. */
+struct ControlResponse {
+    /** Time from the event until the array voltage last left CONTROL_BAND (s), or -1. */
+    double settling;
+
+    /** Largest excursion past the reference, in the direction of a reference step, or either way (V). */
+    double overshoot;
+
+    /** Inner ticks with the duty cycle outside its range, or the inductor current above the limit. */
+    int dutyViolations;
+    int currentViolations;
+
+    /** Peak inductor current (A). */
+    double currentPeak;
+};
+
+/**
+ * Step response of the cascaded PI loops or the explicit MPC to the
+ * reference and irradiance steps of CONTROL_EVENTS, with the tracker held.
+ */
+std::vector<ControlResponse> control_run(bool mpc, bool switching) {
+    Trackers_t trackers;
+    trackers_init(&trackers);
+    SimConfig_t config = {
+        CONTROL_EVENTS[NUM_CONTROL_EVENTS - 1].t + CONTROL_EVENT_LENGTH, 100.0, 0.05, 0.01, CONTROL_START,
+        &profile_control, NULL, NULL, SCAN_INTERVAL, switching, NULL, 0.0, NULL, NULL, mpc, true
+    };
+    SimChannel_t channel;
+    SimChannelInit(&channel, trackers.list[0], config, 1, 0, 0);
+
+    std::vector<ControlResponse> responses(NUM_CONTROL_EVENTS, { -1.0, 0.0, 0, 0, 0.0 });
+    double reference = CONTROL_START;
+    double step = 0.0;
+    size_t next = 0;
+    double dt = SIM_INNER_DECIMATION / SIM_F_SW;
+    for (double t = 0.0; t < config.duration; t += dt) {
+        if (next < NUM_CONTROL_EVENTS && t >= CONTROL_EVENTS[next].t) {
+            step = CONTROL_EVENTS[next].reference - reference;
+            reference = CONTROL_EVENTS[next].reference;
+            ControlArbiterSetReference(&channel.control.arbiter, LOOP_MPPT, (float) reference);
+            ++next;
+        }
+        SimChannelControl(&channel, t);
+        channel.triggerDuty = channel.duty;
+        SimChannelPlant(&channel, t);
+        if (next == 0) continue;
+
+        ControlResponse & response = responses[next - 1];
+        double error = channel.model.vArr - reference;
+        double excursion = step > 0.0 ? error : step < 0.0 ? -error : fabs(error);
+        response.overshoot = fmax(response.overshoot, excursion);
+        if (fabs(error) > CONTROL_BAND) response.settling = t + dt - CONTROL_EVENTS[next - 1].t;
+        if (channel.duty < SIM_DUTY_MIN - 1E-6 || channel.duty > SIM_DUTY_MAX + 1E-6) ++response.dutyViolations;
+        if (channel.model.iL > SIM_CURRENT_MAX) ++response.currentViolations;
+        response.currentPeak = fmax(response.currentPeak, channel.model.iL);
+    }
+    return responses;
+}
+
+/**
+ * Settling time, overshoot and constraint violations of the cascaded PI loops
+ * and the explicit MPC over the same reference and irradiance steps.
+ */
+void control(bool switching) {
+    static const char * NAMES[] = { "cascaded PI", "explicit MPC" };
+    std::vector<ControlResponse> responses[2];
+    run_parallel(2, [&](size_t k) { responses[k] = control_run(k == 1, switching); });
+
+    printf(
+        "Step response, settled within %.2f V, duty in [%.2f, %.2f], inductor current below %.1f A\n",
+        CONTROL_BAND,
+        SIM_DUTY_MIN,
+        SIM_DUTY_MAX,
+        SIM_CURRENT_MAX
+    );
+    printf(
+        "    %-14s %-17s %13s %13s %10s %13s %10s\n",
+        "controller", "event", "settling (ms)", "overshoot (V)", "duty viol.", "current viol.", "peak (A)"
+    );
+    for (size_t k = 0; k < 2; ++k) {
+        for (size_t e = 0; e < NUM_CONTROL_EVENTS; ++e) {
+            const ControlResponse & response = responses[k][e];
+            printf("    %-14s %-17s ", NAMES[k], CONTROL_EVENTS[e].name);
+            if (response.settling < 0.0) printf("%13s", "0");
+            else if (response.settling >= CONTROL_EVENT_LENGTH - 1E-9) printf("%13s", "never");
+            else printf("%13.1f", response.settling * 1E3);
+            printf(
+                " %13.2f %10d %13d %10.2f\n",
+                response.overshoot,
+                response.dutyViolations,
+                response.currentViolations,
+                response.currentPeak
+            );
+        }
+    }
+}
+
+int main(int argc, char ** argv) {
+    bool switching = argc > 1 && strcmp(argv[1], "switching") == 0;
+    if (switching) {
+        --argc;
+        ++argv;
+    }
+    bool tracing = argc > 1 && strcmp(argv[1], "trace") == 0;
+
+    if (argc > 1 && strcmp(argv[1], "skew") == 0) {
+        skew();
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "ripple") == 0) {
+        ripple();
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "control") == 0) {
+        control(switching);
+        return 0;
+    }
+
+    if (argc > 2 && strcmp(argv[1], "en50530") == 0 && strcmp(argv[2], "check") == 0) {
+        return en50530_check(switching) ? 0 : 1;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "en50530") == 0) {
+        bool full = argc > 2 && strcmp(argv[2], "full") == 0;
+        int named = full ? 3 : 2;
+        en50530(full, argc > named ? argv[named] : NULL, switching);
+        return 0;
+    }
+
+    struct { const char * name; enum SimChange (*profile)(double, PVArray_t *, const void *); double duration; } profiles[] = {
+        { "constant", &profile_constant, 6.0 },
+        { "steps", &profile_steps, 9.0 },
+        { "ramp", &profile_ramp, 8.0 },
+        { "shade", &profile_shade, 9.0 },
+    };
+    GlobalScan_t scan = GlobalScanInit(
+        ARR_V_MIN,
+        ARR_V_MAX,
+        ARR_VOC_COLD,
+        ARR_SUBSTRINGS,
+        SIM_CURRENT_MAX,
+        200.0,
+        2000.0,
+        6.0,
+        15E-6,
+        SIM_F_SW / SIM_INNER_DECIMATION
+    );
+
+    if (tracing) {
+        auto & profile = profiles[0];
+        for (auto & p : profiles) {
+            if (argc > 2 && strcmp(argv[2], p.name) == 0) profile = p;
+        }
+        bool scanning = argc > 3 && strcmp(argv[3], "scan") == 0;
+        SimConfig_t config = {
+            profile.duration, 100.0, 0.05, 0.01, ARR_V_START, profile.profile, &trace,
+            scanning ? &scan : NULL, SCAN_INTERVAL, switching
+        };
+        run_tracker(0, config);
+        return 0;
+    }
+
+    /*
+     * Every tracker alone, then with periodic global scans P&O, and the
+     * trackers that learn from them.
+     */
+    static const size_t SCANNED[] = { 0, 5, 7 };
+    std::vector<std::pair<size_t, bool>> rows;
+    for (size_t k = 0; k < NUM_TRACKERS; ++k) rows.push_back({ k, false });
+    for (size_t k : SCANNED) rows.push_back({ k, true });
+    size_t numRows = rows.size();
+    size_t numProfiles = sizeof(profiles) / sizeof(profiles[0]);
+    std::vector<SimMetrics_t> results(numProfiles * numRows);
+    run_parallel(results.size(), [&](size_t job) {
+        auto & profile = profiles[job / numRows];
+        bool scanning = rows[job % numRows].second;
+        SimConfig_t config = {
+            profile.duration, 100.0, 0.05, 0.01, ARR_V_START, profile.profile, NULL,
+            scanning ? &scan : NULL, SCAN_INTERVAL, switching
+        };
+        results[job] = run_tracker(rows[job % numRows].first, config);
+    });
+
+    Trackers_t names;
+    trackers_init(&names);
+    for (size_t p = 0; p < numProfiles; ++p) {
+        printf("Profile: %s\n", profiles[p].name);
+        printf("    %-28s %12s %12s %s\n", "tracker", "efficiency", "steady", "convergence per event (ms)");
+        for (size_t k = 0; k < numRows; ++k) {
+            bool scanning = rows[k].second;
+            const SimMetrics_t & metrics = results[p * numRows + k];
+            char name[40];
+            snprintf(name, sizeof(name), scanning ? "%s + scan" : "%s", names.list[rows[k].first].name);
+            printf(
+                "    %-28s %11.2f%% %11.2f%% ",
+                name,
+                100.0 * SimMetricsEfficiency(&metrics),
+                100.0 * SimMetricsSteadyEfficiency(&metrics)
+            );
+            for (double c : metrics.convergence) {
+                if (c < 0.0) printf(" never");
+                else printf(" %.0f", c * 1E3);
+            }
+            printf("\n");
+            if (scanning && metrics.scans > 0) {
+                printf(
+                    "    %-28s %d scans, %.1f ms and %.2f J lost per scan\n",
+                    "",
+                    metrics.scans,
+                    metrics.scanTime / metrics.scans * 1E3,
+                    metrics.scanLost / metrics.scans
+                );
+            }
+        }
+    }
+
+    /*
+     * Scans on the events the change detector classifies as shading, with
+     * only the backstop timer, for P&O and the trackers that jump on uniform
+     * changes. A minute of constant irradiance counts the false detections
+     * on sensor noise.
+     */
+    static const size_t DETECTED[] = { 0, 4, 5 };
+    size_t numDetected = sizeof(DETECTED) / sizeof(DETECTED[0]);
+    size_t numDetectProfiles = numProfiles + 1;
+    ChangeDetector_t detector = ChangeDetectorInit(0.01, 0.05, 0.005, 20, 1.0, 0.3, 3.0);
+    std::vector<SimMetrics_t> detected(numDetectProfiles * numDetected);
+    run_parallel(detected.size(), [&](size_t job) {
+        size_t p = job / numDetected;
+        SimConfig_t config = {
+            p < numProfiles ? profiles[p].duration : 60.0, 100.0, 0.05, 0.01, ARR_V_START,
+            p < numProfiles ? profiles[p].profile : &profile_constant, NULL, &scan, SCAN_BACKSTOP, switching,
+            NULL, 0.0, &detector
+        };
+        detected[job] = run_tracker(DETECTED[job % numDetected], config);
+    });
+
+    printf("Change detection, scans on shading\n");
+    printf(
+        "    %-28s %-9s %11s %6s %10s %s\n",
+        "tracker", "profile", "efficiency", "scans", "false/min", "latency per change (ms)"
+    );
+    for (size_t p = 0; p < numDetectProfiles; ++p) {
+        for (size_t k = 0; k < numDetected; ++k) {
+            const SimMetrics_t & metrics = detected[p * numDetected + k];
+            double duration = p < numProfiles ? profiles[p].duration : 60.0;
+            printf(
+                "    %-28s %-9s %10.2f%% %6d %10.2f ",
+                names.list[DETECTED[k]].name,
+                p < numProfiles ? profiles[p].name : "steady",
+                100.0 * SimMetricsEfficiency(&metrics),
+                metrics.scans,
+                metrics.falseDetections * 60.0 / duration
+            );
+            for (size_t c = 0; c < metrics.detection.size(); ++c) {
+                if (metrics.detection[c] < 0.0) printf(" never");
+                else printf(" %.0f%c", metrics.detection[c] * 1E3, metrics.classes[c]);
+            }
+            printf("\n");
+        }
+    }
+
+    /*
+     * The efficiency meter on a few trackers over a minute of steady
+     * irradiance, against the true local efficiency at the reference of each
+     * sweep.
+     */
+    static const size_t METERED[] = { 0, 1, 2, 3, 7 };
+    size_t numMetered = sizeof(METERED) / sizeof(METERED[0]);
+    EfficiencyMeter_t meter = EfficiencyMeterInit(
+        METER_AMPLITUDE, METER_POINTS, METER_SETTLE, METER_AVERAGE, METER_INTERVAL, 0.01,
+        SIM_F_SW / (SIM_INNER_DECIMATION * SIM_OUTER_DECIMATION)
+    );
+    std::vector<SimMetrics_t> metered(2 * numMetered);
+    run_parallel(metered.size(), [&](size_t job) {
+        SimConfig_t config = {
+            METER_DURATION, 100.0, 0.05, 0.01, ARR_V_START, &profile_constant, NULL, NULL, SCAN_INTERVAL, switching,
+            NULL, 0.0, NULL, job >= numMetered ? &meter : NULL
+        };
+        metered[job] = run_tracker(METERED[job % numMetered], config);
+    });
+
+    printf(
+        "Tracking efficiency meter, %.1f V x %d points every %.1f s\n",
+        meter.amplitude,
+        meter.points,
+        meter.interval / (SIM_F_SW / (SIM_INNER_DECIMATION * SIM_OUTER_DECIMATION))
+    );
+    printf(
+        "    %-28s %11s %11s %7s %9s %9s %9s %9s\n",
+        "tracker", "unmetered", "metered", "sweeps", "reported", "true", "max error", "lost"
+    );
+    for (size_t k = 0; k < numMetered; ++k) {
+        const SimMetrics_t & metrics = metered[numMetered + k];
+        double reported = 0.0, actual = 0.0, error = 0.0;
+        for (size_t s = 0; s < metrics.metered.size(); ++s) {
+            reported += metrics.metered[s];
+            actual += metrics.meteredTrue[s];
+            error = fmax(error, fabs(metrics.metered[s] - metrics.meteredTrue[s]));
+        }
+        size_t sweeps = metrics.metered.size();
+        printf(
+            "    %-28s %10.3f%% %10.3f%% %7zu %8.2f%% %8.2f%% %8.2f%% %8.4f%%\n",
+            names.list[METERED[k]].name,
+            100.0 * SimMetricsEfficiency(&metered[k]),
+            100.0 * SimMetricsEfficiency(&metrics),
+            sweeps,
+            sweeps > 0 ? 100.0 * reported / sweeps : 0.0,
+            sweeps > 0 ? 100.0 * actual / sweeps : 0.0,
+            100.0 * error,
+            metrics.energy > 0.0 ? 100.0 * metrics.meterLost / metrics.energy : 0.0
+        );
+    }
+
+    /*
+     * Two channels with P&O and periodic scans from one tick loop, on the
+     * steps and the shade profile, with their outer stages in the same tick
+     * or staggered.
+     */
+    SimConfig_t channelConfigs[NUM_CHANNELS] = {
+        { 9.0, 100.0, 0.05, 0.01, ARR_V_START, &profile_steps, NULL, &scan, SCAN_INTERVAL, switching },
+        { 9.0, 100.0, 0.05, 0.01, ARR_V_START, &profile_shade, NULL, &scan, SCAN_INTERVAL, switching },
+    };
+    SimMetrics_t channelMetrics[2][NUM_CHANNELS];
+    SimLoad_t loads[2];
+    run_parallel(2, [&](size_t job) {
+        loads[job] = run_channels(0, channelConfigs, job == 1, channelMetrics[job]);
+    });
+
+    printf("Two channels from one tick loop, %s + scan\n", names.list[0].name);
+    printf(
+        "    %-10s %12s %12s %11s %11s %12s %18s\n",
+        "schedule", "steps ch0", "shade ch1", "outer/tick", "steps/tick", "cycles/tick", "cycles/outer tick"
+    );
+    for (size_t job = 0; job < 2; ++job) {
+        printf(
+            "    %-10s %11.2f%% %11.2f%% %11d %11d %12.0f %18.0f\n",
+            job == 1 ? "staggered" : "aligned",
+            100.0 * SimMetricsEfficiency(&channelMetrics[job][0]),
+            100.0 * SimMetricsEfficiency(&channelMetrics[job][1]),
+            loads[job].outerMax,
+            loads[job].stepsMax,
+            loads[job].cycles,
+            loads[job].cyclesOuter
+        );
+    }
+    return 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file pv_model.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Single diode PV array model for the host simulation. Mirrors
+ *        sw/design_procedures/solar_cell_nonideal_model.py, with the array
+ *        split into bypass diode protected substrings for partial shading.
+ * @version 0.1
+ * @date 2023-08-25
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <math.h>
+#include <vector>
+
+
+/*
+Each cell follows the single diode model
+
+    I = I_ph - I_0 (exp((V + I R_s) / (n V_t)) - 1) - (V + I R_s) / R_sh
+
+with the reference parameters of the Maxeon Gen III cell used in
+sw/design_files/design_specs.json. The array is `numSubstrings` substrings in
+series, each of `cellsPerSubstring` cells with its own irradiance and a bypass
+diode that clamps the substring at -vBypass when it is driven into reverse.
+
+Solving the array current for a voltage requires a nested solve, so the
+simulation tabulates the I-V curve with PVCurveBuild whenever the conditions
+change, and interpolates it on every integration step. The table is built by
+sweeping the current, where each point is one Newton solve per substring, and
+resampling onto a uniform voltage grid.
+*/
+
+#define PV_MAX_SUBSTRINGS 8
+
+/** @brief Definition of the PV array and its operating conditions. */
+typedef struct PVArray {
+    /** @brief Number of substrings in series. */
+    int numSubstrings;
+
+    /** @brief Number of cells per substring. */
+    int cellsPerSubstring;
+
+    /** @brief Irradiance of each substring (W/m^2). */
+    double irradiance[PV_MAX_SUBSTRINGS];
+
+    /** @brief Cell temperature (K). */
+    double temperature;
+
+    /** @brief Series resistance per cell (Ohms). */
+    double rS;
+
+    /** @brief Shunt resistance per cell (Ohms). */
+    double rSh;
+
+    /** @brief Forward voltage of a bypass diode (V). */
+    double vBypass;
+} PVArray_t;
+
+/** @brief Definition of a tabulated I-V curve. */
+typedef struct PVCurve {
+    /** @brief Voltage step between points (V). */
+    double dv;
+
+    /** @brief Current at each point, from 0 V to v_oc (A). */
+    std::vector<double> current;
+
+    /** @brief Open circuit voltage (V). */
+    double voc;
+
+    /** @brief Short circuit current (A). */
+    double isc;
+
+    /** @brief Global maximum power point voltage (V). */
+    double vmpp;
+
+    /** @brief Global maximum power (W). */
+    double pmpp;
+} PVCurve_t;
+
+/** Reference cell parameters, see solar_cell_nonideal_model.py. */
+static const double PV_ISC_REF = 6.15;
+static const double PV_VOC_REF = 0.721;
+static const double PV_G_REF = 1000.0;
+static const double PV_T_REF = 298.15;
+static const double PV_T_COEFF_ISC = 0.005;
+static const double PV_T_COEFF_VOC = -0.0022;
+static const double PV_N = 1.0;
+static const double PV_K_Q = 1.380649E-23 / 1.602176634E-19;
+
+/**
+ * @brief PVArrayInit returns the 100 cell array of design_specs.json as five
+ *        substrings of 20 cells, uniformly lit at STC.
+ */
+inline PVArray_t PVArrayInit(void) {
+    PVArray_t array = { 5, 20, { 0 }, PV_T_REF, 0.0035, 40.0, 0.4 };
+    for (int k = 0; k < PV_MAX_SUBSTRINGS; ++k) array.irradiance[k] = PV_G_REF;
+    return array;
+}
+
+/** @brief Sets every substring to irradiance `g` (W/m^2). */
+inline void PVArraySetIrradiance(PVArray_t * array, double g) {
+    for (int k = 0; k < array->numSubstrings; ++k) array->irradiance[k] = g;
+}
+
+/** @brief Photo current of a cell at irradiance g and temperature t (A). */
+inline double PVCellPhotoCurrent(const PVArray_t * array, double g, double t) {
+    double isc = PV_ISC_REF * (g / PV_G_REF) * (1 - PV_T_COEFF_ISC * (PV_T_REF - t));
+    return isc * (array->rSh + array->rS) / array->rSh;
+}
+
+/** @brief Cell voltage for a cell current i, by Newton's method (V). */
+inline double PVCellVoltage(const PVArray_t * array, double g, double t, double i) {
+    if (g <= 0.0) g = 1E-3;
+    double vt = PV_N * PV_K_Q * t;
+    double isc = PV_ISC_REF * (g / PV_G_REF) * (1 - PV_T_COEFF_ISC * (PV_T_REF - t));
+    double voc = PV_VOC_REF * (1 - PV_T_COEFF_VOC * (PV_T_REF - t)) + vt * log(g / PV_G_REF);
+    double i0 = isc / (exp(voc / vt) - 1);
+    double iph = PVCellPhotoCurrent(array, g, t);
+
+    /* Solve for the diode voltage vd = v + i r_s. */
+    double vd = iph > i ? vt * log((iph - i) / i0 + 1) : -(i - iph) * array->rSh;
+    for (int iter = 0; iter < 50; ++iter) {
+        double e = exp(vd / vt);
+        double f = iph - i0 * (e - 1) - vd / array->rSh - i;
+        double df = -i0 * e / vt - 1 / array->rSh;
+        double step = f / df;
+        vd -= step;
+        if (fabs(step) < 1E-9) break;
+    }
+    return vd - i * array->rS;
+}
+
+/** @brief Array voltage for an array current i, with bypass diodes (V). */
+inline double PVArrayVoltage(const PVArray_t * array, double i) {
+    /* Uniformly lit substrings share one solve. */
+    bool uniform = true;
+    for (int k = 1; k < array->numSubstrings; ++k) {
+        if (array->irradiance[k] != array->irradiance[0]) uniform = false;
+    }
+    if (uniform) {
+        double vSub = array->cellsPerSubstring
+            * PVCellVoltage(array, array->irradiance[0], array->temperature, i);
+        return array->numSubstrings * (vSub > -array->vBypass ? vSub : -array->vBypass);
+    }
+
+    double v = 0.0;
+    for (int k = 0; k < array->numSubstrings; ++k) {
+        double vSub = array->cellsPerSubstring
+            * PVCellVoltage(array, array->irradiance[k], array->temperature, i);
+        v += vSub > -array->vBypass ? vSub : -array->vBypass;
+    }
+    return v;
+}
+
+/** @brief Array current at array voltage v, by bisection (A). */
+inline double PVArrayCurrent(const PVArray_t * array, double v) {
+    double lo = 0.0;
+    double hi = 0.0;
+    for (int k = 0; k < array->numSubstrings; ++k) {
+        double iph = PVCellPhotoCurrent(array, array->irradiance[k], array->temperature);
+        if (iph > hi) hi = iph;
+    }
+    hi *= 1.1;
+    if (PVArrayVoltage(array, 0.0) <= v) return 0.0;
+    for (int iter = 0; iter < 60; ++iter) {
+        double mid = (lo + hi) / 2;
+        if (PVArrayVoltage(array, mid) > v) lo = mid;
+        else hi = mid;
+    }
+    return (lo + hi) / 2;
+}
+
+/**
+ * @brief PVCurveBuild tabulates the I-V curve of the array under its current
+ *        conditions, and finds the global maximum power point.
+ *
+ * @param array  PV array and conditions.
+ * @param points Number of points between 0 V and v_oc.
+ */
+inline PVCurve_t PVCurveBuild(const PVArray_t * array, int points) {
+    PVCurve_t curve;
+    double iMax = 0.0;
+    for (int k = 0; k < array->numSubstrings; ++k) {
+        double iph = PVCellPhotoCurrent(array, array->irradiance[k], array->temperature);
+        if (iph > iMax) iMax = iph;
+    }
+
+    /* Sweep the current; V(I) is monotonically decreasing. */
+    int sweep = 4 * points;
+    std::vector<double> vs(sweep + 1);
+    std::vector<double> is(sweep + 1);
+    for (int k = 0; k <= sweep; ++k) {
+        is[k] = iMax * k / sweep;
+        vs[k] = PVArrayVoltage(array, is[k]);
+    }
+
+    curve.voc = vs[0] > 0.0 ? vs[0] : 0.0;
+    curve.dv = curve.voc / (points - 1);
+    curve.current.resize(points);
+    curve.vmpp = 0.0;
+    curve.pmpp = 0.0;
+    int j = sweep;
+    for (int k = 0; k < points; ++k) {
+        double v = k * curve.dv;
+        /* Walk up the sweep (down in current) to bracket v. */
+        while (j > 0 && vs[j - 1] <= v) --j;
+        double i = 0.0;
+        if (k == points - 1 || j == 0) i = 0.0;
+        else if (vs[j] >= v) i = is[j];
+        else i = is[j] + (v - vs[j]) * (is[j - 1] - is[j]) / (vs[j - 1] - vs[j]);
+        curve.current[k] = i;
+    }
+    curve.isc = curve.current[0];
+
+    /* Global MPP from the sweep, which is densest around the knees. */
+    for (int k = 0; k <= sweep; ++k) {
+        if (vs[k] * is[k] > curve.pmpp) {
+            curve.pmpp = vs[k] * is[k];
+            curve.vmpp = vs[k];
+        }
+    }
+    return curve;
+}
+
+/** @brief Interpolated array current of a tabulated curve at voltage v (A). */
+inline double PVCurveCurrent(const PVCurve_t * curve, double v) {
+    if (v <= 0.0) return curve->isc;
+    if (v >= curve->voc || curve->dv <= 0.0) return 0.0;
+    double x = v / curve->dv;
+    size_t k = (size_t) x;
+    if (k + 1 >= curve->current.size()) return 0.0;
+    double frac = x - k;
+    return curve->current[k] + frac * (curve->current[k + 1] - curve->current[k]);
+}
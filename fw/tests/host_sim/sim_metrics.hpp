@@ -0,0 +1,262 @@
+/**
+ * @file sim_metrics.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Tracking efficiency and convergence time hooks for the host
+ *        simulation.
+ * @version 0.1
+ * @date 2023-08-25
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <string>
+#include <vector>
+
+
+/*
+- Tracking efficiency is the harvested array energy over the energy available
+  at the global MPP, integrated over the whole run.
+- Convergence time is measured per event (the start of the run, every step
+  in conditions, and the end of every ramp). It is the time from the event
+  until the array power last entered the band [band * P_mpp, P_mpp] and stayed
+  there until the next event or ramp. An event that never settles into the
+  band records -1. Samples during a ramp do not count towards any event, and
+  a global scan does not count as leaving the band.
+- Steady state efficiency is the harvested over the available energy during
+  the converged stretch of every event, from the convergence time to the next
+  event. It isolates the loss of the tracker dithering around the MPP.
+- Settled efficiency is the harvested over the available energy from a fixed
+  time on, i.e. after the tracker found the MPP at the start of the run. The
+  EN 50530 static and dynamic efficiencies are settled efficiencies.
+- Cycles per step is the mean cost on the host, from the time stamp counter,
+  of the control ticks that step the tracker: the whole ChannelControlStep,
+  with the arbiter and the inner loop.
+- Detection latency is measured per change (every step in conditions, and the
+  start of every ramp; not the start of the run). It is the time from the
+  change until the change detector classified it, with the class it gave: 'u'
+  for uniform, 's' for shading. A change that is never classified before the
+  next one records -1 and '-'. A classification without a change or ramp
+  within SIM_DETECT_WINDOW before it is a false detection.
+*/
+
+#define SIM_DETECT_WINDOW 1.0 // s
+
+/** @brief Definition of the simulation metrics. */
+typedef struct SimMetrics {
+    /** @brief Fraction of P_mpp that counts as converged. */
+    double band;
+
+    /** @brief Harvested array energy (J). */
+    double energy;
+
+    /** @brief Available energy at the global MPP (J). */
+    double available;
+
+    /** @brief Time of the last event, or -1 during a ramp (s). */
+    double event;
+
+    /** @brief Time the power last entered the band, or -1 if outside (s). */
+    double entered;
+
+    /** @brief Harvested energy since the power last entered the band (J). */
+    double stretchEnergy;
+
+    /** @brief Available energy since the power last entered the band (J). */
+    double stretchAvailable;
+
+    /** @brief Harvested energy over the converged stretches (J). */
+    double steadyEnergy;
+
+    /** @brief Available energy over the converged stretches (J). */
+    double steadyAvailable;
+
+    /** @brief Number of global scans. */
+    int scans;
+
+    /** @brief Total duration of the global scans (s). */
+    double scanTime;
+
+    /** @brief Total harvest lost during the global scans (J). */
+    double scanLost;
+
+    /** @brief Time from which the settled energies are integrated (s). */
+    double settle;
+
+    /** @brief Harvested energy from the settle time (J). */
+    double settledEnergy;
+
+    /** @brief Available energy from the settle time (J). */
+    double settledAvailable;
+
+    /** @brief Number of tracker steps. */
+    long steps;
+
+    /** @brief Host cycles spent in the control ticks of the tracker steps. */
+    double stepCycles;
+
+    /** @brief Convergence time of each event (s). */
+    std::vector<double> convergence;
+
+    /** @brief Time of the last change not yet classified, or -1 (s). */
+    double undetected;
+
+    /** @brief Time of the last change, including every ramp sample (s). */
+    double changed;
+
+    /** @brief Detection latency of each change (s). */
+    std::vector<double> detection;
+
+    /** @brief Class of each change: 'u'niform, 's'hading, or '-'. */
+    std::string classes;
+
+    /** @brief Number of false detections. */
+    int falseDetections;
+
+    /** @brief Efficiency of each efficiency meter sweep, metered and true. */
+    std::vector<double> metered;
+    std::vector<double> meteredTrue;
+
+    /** @brief Harvest the efficiency meter sweeps lost (J). */
+    double meterLost;
+} SimMetrics_t;
+
+/** @brief Starts a run at time 0, which counts as the first event. */
+inline SimMetrics_t SimMetricsInit(double band, double settle) {
+    SimMetrics_t metrics = {
+        band, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0, 0.0, 0.0,
+        settle, 0.0, 0.0, 0, 0.0, std::vector<double>(),
+        -1.0, 0.0, std::vector<double>(), std::string(), 0,
+        std::vector<double>(), std::vector<double>(), 0.0
+    };
+    return metrics;
+}
+
+/** @brief Closes the convergence record of the current event, if any. */
+inline void SimMetricsClose(SimMetrics_t * metrics) {
+    if (metrics->event < 0.0) return;
+    metrics->convergence.push_back(
+        metrics->entered < 0.0 ? -1.0 : metrics->entered - metrics->event
+    );
+    if (metrics->entered >= 0.0) {
+        metrics->steadyEnergy += metrics->stretchEnergy;
+        metrics->steadyAvailable += metrics->stretchAvailable;
+    }
+    metrics->event = -1.0;
+}
+
+/** @brief Starts the detection record of a change at time t. */
+inline void SimMetricsChange(SimMetrics_t * metrics, double t) {
+    if (metrics->undetected >= 0.0) {
+        metrics->detection.push_back(-1.0);
+        metrics->classes.push_back('-');
+    }
+    metrics->undetected = t;
+}
+
+/** @brief Marks a step in conditions, or the end of a ramp, at time t. */
+inline void SimMetricsEvent(SimMetrics_t * metrics, double t) {
+    if (metrics->event >= 0.0) SimMetricsChange(metrics, t);
+    metrics->changed = t;
+    SimMetricsClose(metrics);
+    metrics->event = t;
+    metrics->entered = -1.0;
+    metrics->stretchEnergy = 0.0;
+    metrics->stretchAvailable = 0.0;
+}
+
+/** @brief Marks a ramp in progress at time t; closes the current event. */
+inline void SimMetricsDrift(SimMetrics_t * metrics, double t) {
+    if (metrics->event >= 0.0) SimMetricsChange(metrics, t);
+    metrics->changed = t;
+    SimMetricsClose(metrics);
+}
+
+/** @brief Records a classification of the change detector at time t. */
+inline void SimMetricsDetect(SimMetrics_t * metrics, double t, bool shading) {
+    if (metrics->undetected >= 0.0) {
+        metrics->detection.push_back(t - metrics->undetected);
+        metrics->classes.push_back(shading ? 's' : 'u');
+        metrics->undetected = -1.0;
+    } else if (t - metrics->changed > SIM_DETECT_WINDOW) {
+        ++metrics->falseDetections;
+    }
+}
+
+/**
+ * @brief Records the efficiency an efficiency meter sweep reported, the true
+ *        one, and the harvest the sweeps lost so far.
+ */
+inline void SimMetricsMeter(SimMetrics_t * metrics, double metered, double actual, double lost) {
+    metrics->metered.push_back(metered);
+    metrics->meteredTrue.push_back(actual);
+    metrics->meterLost = lost;
+}
+
+/** @brief Closes the records of the run. */
+inline void SimMetricsFinish(SimMetrics_t * metrics) {
+    SimMetricsClose(metrics);
+    SimMetricsChange(metrics, -1.0);
+}
+
+/**
+ * @brief Records the array power p against the available p_mpp over dt. During
+ *        a deliberate excursion, i.e. a global scan, the power counts but the
+ *        band is not considered left.
+ */
+inline void SimMetricsSample(SimMetrics_t * metrics, double t, double dt, double p, double pMpp, bool excursion) {
+    metrics->energy += p * dt;
+    metrics->available += pMpp * dt;
+    if (t >= metrics->settle) {
+        metrics->settledEnergy += p * dt;
+        metrics->settledAvailable += pMpp * dt;
+    }
+    bool inside = excursion ? metrics->entered >= 0.0 : p >= metrics->band * pMpp;
+    if (!inside) {
+        metrics->entered = -1.0;
+        metrics->stretchEnergy = 0.0;
+        metrics->stretchAvailable = 0.0;
+    } else {
+        if (metrics->entered < 0.0) metrics->entered = t;
+        metrics->stretchEnergy += p * dt;
+        metrics->stretchAvailable += pMpp * dt;
+    }
+}
+
+/** @brief Records a completed global scan. */
+inline void SimMetricsScan(SimMetrics_t * metrics, double duration, double lost) {
+    ++metrics->scans;
+    metrics->scanTime += duration;
+    metrics->scanLost += lost;
+}
+
+/** @brief Records the host cycles of the control tick of a tracker step. */
+inline void SimMetricsStep(SimMetrics_t * metrics, double cycles) {
+    ++metrics->steps;
+    metrics->stepCycles += cycles;
+}
+
+/** @brief Mean host cycles per tracker step. */
+inline double SimMetricsCyclesPerStep(const SimMetrics_t * metrics) {
+    return metrics->steps > 0 ? metrics->stepCycles / metrics->steps : 0.0;
+}
+
+/** @brief Settled efficiency of the run so far. */
+inline double SimMetricsSettledEfficiency(const SimMetrics_t * metrics) {
+    return metrics->settledAvailable > 0.0 ? metrics->settledEnergy / metrics->settledAvailable : 0.0;
+}
+
+/** @brief Energy lost against the global MPP since the settle time (J). */
+inline double SimMetricsSettledLost(const SimMetrics_t * metrics) {
+    return metrics->settledAvailable - metrics->settledEnergy;
+}
+
+/** @brief Steady state efficiency of the run so far. */
+inline double SimMetricsSteadyEfficiency(const SimMetrics_t * metrics) {
+    return metrics->steadyAvailable > 0.0 ? metrics->steadyEnergy / metrics->steadyAvailable : 0.0;
+}
+
+/** @brief Tracking efficiency of the run so far. */
+inline double SimMetricsEfficiency(const SimMetrics_t * metrics) {
+    return metrics->available > 0.0 ? metrics->energy / metrics->available : 0.0;
+}
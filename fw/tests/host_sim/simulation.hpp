@@ -0,0 +1,619 @@
+/**
+ * @file simulation.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Closed loop host simulation of the Sunscatter. Runs the firmware
+ *        controller libraries against the averaged boost and PV models, on the
+ *        same tick structure as run_controller() in fw/src/main.cpp.
+ * @version 0.1
+ * @date 2023-08-25
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/** Device Specific imports. */
+#include "../../inc/channel_control/channel_control.hpp"
+#include "./boost_model.hpp"
+#include "./pv_model.hpp"
+#include "./sim_metrics.hpp"
+
+
+/*
+Every inner tick (F_SW / INNER_DECIMATION) the simulation:
+1. reads the block means of the last DMA scan like read_sensor(). Every
+   conversion is quantized to 12 bits with optional gaussian noise, and every
+   sensor is converted at both trigger points of the scan, see below;
+2. hands them to ChannelControlSense and ChannelControlStep of
+   fw/inc/channel_control, the code the control ISR of fw/src/main.cpp runs:
+   the sensor filters, the tracker with its global scans, change detector,
+   model predictor and efficiency meter, the arbiter and the inner current
+   loop. The events they raise are recorded into the metrics;
+3. integrates the plant over the tick, either averaged, or switched within
+   every PWM period.
+
+The tracker under test sets the strategy and the predictor; the run sets the
+rest of the ChannelOptions_t. A global scan starts every scanInterval outer
+ticks while the MPPT loop is in control, or, with a change detector, when it
+classifies a change as shading; scanInterval is then the backstop. Every
+classification is recorded into the metrics.
+
+The sensors follow the DMA scan of fw/src/main.cpp, triggered at both points
+(ADC_TRIGGER_BOTH) with the array voltage centered on the array current, one
+scan per block. With the plant switched, the scan runs on its own, one rank
+pair per PWM period over SIM_SCAN_PERIODS periods, and the points follow the
+duty cycle of the first channel like AdcScanSetDuty():
+
+    period  scanOffset      scanOffset + 1   2                SIM_SCAN_PERIODS - 2
+    mid on  array voltage   array current    battery current  battery voltage
+    mid off array current   array voltage    battery current  battery voltage
+
+Only the first channel has a battery current sensor, like channel_pins; the
+second estimates its battery current from the power balance.
+
+Every sensor is the mean of its two conversions, and the means of a scan are
+handed over when it completes, after the VREFINT period; the control reads the
+last complete scan. The array voltage and current are then both taken half a
+period apart, on the average of the ripple rather than at its peak. With the
+plant averaged there is no ripple, and both conversions are taken at the end
+of the tick.
+
+Fractional V_oc asks for a V_oc measurement every VOC_INTERVAL steps while
+selected, and after every global scan whatever the strategy. While the window
+is open the plant runs with both switches off, and the power counts like a
+scan until SIM_VOC_RECOVERY after the window.
+
+With an efficiency meter, its sweeps take the place of the tracker steps. The
+efficiency each accepted sweep reports is recorded with
+the true one: the power of the curve at the reference over the local maximum
+the reference climbs to.
+
+Every control tick that steps the tracker is timed with SimCycles() into the
+metrics.
+
+A SimChannel_t holds all of the above for one converter. SimRun runs a single
+one; SimRunChannels runs several from the same tick loop, each on its own
+array and profile, with the outer stages staggered over the inner ticks like
+the channels of fw/src/main.cpp, and reports the control load per tick.
+
+The conditions are re-evaluated through the profile callback every
+PROFILE_PERIOD. When the profile reports a change, the I-V curve is rebuilt;
+when it reports an event (a step, or the end of a ramp), a metrics event is
+also recorded so that convergence is measured from there.
+*/
+
+/** Mirrors fw/src/main.cpp. */
+#define SIM_F_SW 104000.0
+#define SIM_INNER_DECIMATION 10
+#define SIM_OUTER_DECIMATION 10
+#define SIM_MPPT_DECIMATION 50
+#define SIM_MPPT_WINDOW CHANNEL_MPPT_WINDOW
+#define SIM_DUTY_MAX 0.90
+#define SIM_DUTY_MIN 0.10
+#define SIM_CURRENT_MAX 6.0
+#define SIM_CURRENT_MIN 0.0
+#define SIM_SUBSTEPS 64
+#define SIM_SWITCHING_SUBSTEPS 32
+#define SIM_PROFILE_PERIOD 10E-3
+#define SIM_VOC_RECOVERY 5E-3 // s after a V_oc measurement that counts like a scan.
+#define SIM_SCAN_PERIODS 7 // PWM periods per scan of two channels, triggered at both points.
+
+/** @brief Change in conditions reported by a profile. */
+enum SimChange { SIM_UNCHANGED, SIM_DRIFT, SIM_EVENT };
+
+/** @brief Definition of a tracker under test. */
+typedef struct SimTracker {
+    /** @brief Name used in the report. */
+    const char * name;
+
+    /** @brief Trackers, with the strategy under test selected. */
+    MPPT_t mppt;
+
+    /** @brief Whether the averaged strategy jumps to the predicted MPP. */
+    bool predict;
+    ModelPredictor_t predictor;
+} SimTracker_t;
+
+/** @brief Definition of a simulation run. */
+typedef struct SimConfig {
+    /** @brief Length of the run (s). */
+    double duration;
+
+    /** @brief Battery voltage (V). */
+    double vBatt;
+
+    /** @brief Standard deviation of the array voltage sense noise per conversion (V). */
+    double noiseVoltage;
+
+    /** @brief Standard deviation of the array current sense noise per conversion (A). */
+    double noiseCurrent;
+
+    /** @brief Initial array voltage reference (V). */
+    double reference;
+
+    /** @brief Updates the array conditions at time t, given profileData. */
+    enum SimChange (*profile)(double t, PVArray_t * array, const void * data);
+
+    /** @brief Optional trace callback, called every outer tick. */
+    void (*trace)(double t, const BoostModel_t * model, const PVCurve_t * curve, float reference);
+
+    /** @brief Optional global scan parameters. Copied; NULL disables scans. */
+    const GlobalScan_t * scan;
+
+    /** @brief Outer ticks between global scans. */
+    uint32_t scanInterval;
+
+    /**
+     * @brief Whether to switch the plant within every PWM period instead of
+     *        averaging it. The sensors then convert at the trigger points of
+     *        the scan.
+     */
+    bool switching;
+
+    /** @brief Optional parameters of the profile. */
+    const void * profileData;
+
+    /** @brief Time from which the settled efficiency is integrated (s). */
+    double settle;
+
+    /**
+     * @brief Optional change detector. Copied; NULL disables it. With a
+     *        detector, scanInterval is the backstop between scans.
+     */
+    const ChangeDetector_t * detector;
+
+    /** @brief Optional efficiency meter, stepped every outer tick. Copied; NULL disables it. */
+    const EfficiencyMeter_t * meter;
+
+    /** @brief Whether the explicit MPC replaces the cascaded PI loops. */
+    bool mpc;
+
+    /**
+     * @brief Whether the tracker holds the reference, so that the caller can
+     *        step it with ControlArbiterSetReference.
+     */
+    bool hold;
+} SimConfig_t;
+
+/** @brief Host time stamp counter, or nanoseconds where there is none. */
+inline uint64_t SimCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+#endif
+}
+
+/** @brief Quantizes a sensed value like the 12 bit ADC and calibration. */
+inline float SimSense(double value, double fullScale, double noise, std::mt19937 * rng) {
+    std::normal_distribution<double> dist(0.0, 1.0);
+    double v = value + (noise > 0.0 ? noise * dist(*rng) : 0.0);
+    double code = floor(v / fullScale * 4096.0);
+    if (code < 0.0) code = 0.0;
+    if (code > 4095.0) code = 4095.0;
+    return (float) (code / 4096.0 * fullScale);
+}
+
+/** @brief Block means of the sensors of a channel, as the DMA scan hands them over. */
+typedef struct SimSensed {
+    /** @brief Array voltage and current (V, A). */
+    float arrVoltage;
+    float arrCurrent;
+
+    /** @brief Battery voltage and current (V, A). */
+    float battVoltage;
+    float battCurrent;
+} SimSensed_t;
+
+/** @brief Power of the curve at v over the local maximum v climbs to. */
+inline double SimLocalEfficiency(const PVCurve_t * curve, double v) {
+    double p = v * PVCurveCurrent(curve, v);
+    double step = 0.01;
+    if ((v + step) * PVCurveCurrent(curve, v + step) < p) step = -step;
+    double best = p;
+    for (double u = v + step; u > 0.0 && u < curve->voc; u += step) {
+        double q = u * PVCurveCurrent(curve, u);
+        if (q < best) break;
+        best = q;
+    }
+    return best > 0.0 ? p / best : 1.0;
+}
+
+/** @brief Definition of the state of a simulated converter channel. */
+typedef struct SimChannel {
+    /** @brief Run parameters. */
+    SimConfig_t config;
+
+    /** @brief Sensor noise source. */
+    std::mt19937 rng;
+
+    /** @brief Array conditions, I-V curve and converter. */
+    PVArray_t array;
+    PVCurve_t curve;
+    BoostModel_t model;
+
+    /** @brief Metrics of the run. */
+    SimMetrics_t metrics;
+
+    /** @brief Firmware of the channel, with the tracker under test. */
+    ChannelControl_t control;
+
+    /**
+     * @brief Block means of the last complete DMA scan, the sums of the scan
+     *        in progress, its PWM period, and that of the array sensors.
+     */
+    SimSensed_t sensed;
+    SimSensed_t pending;
+    uint8_t scanPeriod;
+    uint8_t scanOffset;
+
+    /** @brief Duty cycle the trigger points of the scan follow. */
+    float triggerDuty;
+
+    /** @brief End of the recovery from the last V_oc measurement (s). */
+    double recovered;
+
+    /** @brief Time of the next profile update (s). */
+    double nextProfile;
+
+    /** @brief Duty cycle applied over the tick. */
+    float duty;
+
+    /** @brief Whether the last control step ran the outer stage, and a tracker step. */
+    bool outer;
+    bool stepped;
+} SimChannel_t;
+
+/**
+ * @brief SimChannelConvert converts the sensors of the rank pair of a PWM
+ *        period of the scan at one of its trigger points, into the sums of
+ *        the scan in progress.
+ *
+ * @param channel Channel to sense.
+ * @param period  PWM period within the scan.
+ * @param on      Whether at the middle of the on time of the PWM pin, i.e.
+ *                of the high side, rather than the off time.
+ */
+inline void SimChannelConvert(SimChannel_t * channel, uint8_t period, bool on) {
+    const BoostModel_t & model = channel->model;
+    const SimConfig_t & config = channel->config;
+    SimSensed_t & pending = channel->pending;
+    if (period == channel->scanOffset || period == channel->scanOffset + 1) {
+        /* V_on I_off, then I_on V_off. */
+        if (on == (period == channel->scanOffset)) {
+            pending.arrVoltage += SimSense(model.vArr, 114.0, config.noiseVoltage, &channel->rng);
+        } else {
+            pending.arrCurrent += SimSense(model.iL, 5.79, config.noiseCurrent, &channel->rng);
+        }
+    }
+    if (channel->scanOffset == 0 && period == 2) {
+        pending.battCurrent += SimSense((1 - channel->duty) * model.iL, 5.8, 0.0, &channel->rng);
+    }
+    if (period == SIM_SCAN_PERIODS - 2) {
+        pending.battVoltage += SimSense(model.vBatt, 168.0, 0.0, &channel->rng);
+    }
+}
+
+/**
+ * @brief SimChannelSenseAveraged takes both conversions of every sensor of a
+ *        channel at once, and hands the means over, for the plant without
+ *        ripple.
+ *
+ * @param channel Channel to sense.
+ */
+inline void SimChannelSenseAveraged(SimChannel_t * channel) {
+    channel->pending = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int point = 0; point < 2; ++point) {
+        for (uint8_t period = 0; period < SIM_SCAN_PERIODS - 1; ++period) {
+            SimChannelConvert(channel, period, point == 0);
+        }
+    }
+    channel->sensed = {
+        channel->pending.arrVoltage / 2,
+        channel->pending.arrCurrent / 2,
+        channel->pending.battVoltage / 2,
+        channel->pending.battCurrent / 2
+    };
+    channel->pending = { 0.0f, 0.0f, 0.0f, 0.0f };
+}
+
+/**
+ * @brief SimChannelInit starts a channel at time 0.
+ *
+ * @param channel Channel to initialize.
+ * @param tracker Tracker under test.
+ * @param config  Run parameters and array profile.
+ * @param seed    Seed of the sensor noise.
+ * @param phase   Inner ticks the outer stage runs after the first.
+ * @param index   Index of the channel, for its place in the DMA scan; 0 or 1.
+ */
+inline void SimChannelInit(
+    SimChannel_t * channel,
+    SimTracker_t tracker,
+    SimConfig_t config,
+    uint32_t seed,
+    uint16_t phase,
+    uint8_t index
+) {
+    channel->config = config;
+    channel->rng.seed(seed);
+    channel->array = PVArrayInit();
+    config.profile(0.0, &channel->array, config.profileData);
+    channel->curve = PVCurveBuild(&channel->array, 2000);
+    channel->model = BoostModelInit(config.vBatt, channel->curve.voc);
+    channel->metrics = SimMetricsInit(0.98, config.settle);
+
+    /* Battery limits are raised so that only the MPPT loop is active. With
+       the MPC the MPPT limiter is pinned to the current limit, like
+       __CONTROL__ 1 of fw/src/main.cpp. */
+    ChannelOptions_t options = {
+        !config.hold,
+        config.scan != NULL,
+        config.scanInterval,
+        config.detector != NULL,
+        tracker.predict,
+        config.meter != NULL,
+        config.mpc,
+        index == 0,
+        SIM_MPPT_DECIMATION
+    };
+    ChannelControlInit(
+        &channel->control,
+        options,
+        CascadedControllerInit(
+            PILoopInit(SIM_CURRENT_MAX, SIM_CURRENT_MIN, 0.5, 5E-3, 1.0),
+            PILoopInit(SIM_DUTY_MAX, SIM_DUTY_MIN, 5E-3, 1E-3, 1.0),
+            ARRAY_VOLTAGE,
+            SIM_OUTER_DECIMATION
+        ),
+        ControlArbiterInit(
+            config.mpc
+                ? ControlLimiterInit(PILoopInit(SIM_CURRENT_MAX, SIM_CURRENT_MAX, 0.0, 0.0, 0.0), config.reference, -1.0)
+                : ControlLimiterInit(PILoopInit(SIM_CURRENT_MAX, SIM_CURRENT_MIN, 0.5, 5E-3, 1.0), config.reference, -1.0),
+            ControlLimiterInit(PILoopInit(SIM_CURRENT_MAX, SIM_CURRENT_MIN, 0.5, 5E-3, 1.0), 1000.0, 1.0),
+            ControlLimiterInit(PILoopInit(SIM_CURRENT_MAX, SIM_CURRENT_MIN, 1.0, 2E-2, 1.0), 1000.0, 1.0)
+        ),
+        ExplicitMPCInit(15E-6),
+        tracker.mppt,
+        config.scan != NULL ? *config.scan : GlobalScan_t(),
+        config.detector != NULL ? *config.detector : ChangeDetector_t(),
+        config.meter != NULL ? *config.meter : EfficiencyMeter_t(),
+        tracker.predictor
+    );
+    MPPTReset(&channel->control.mppt, (float) config.reference);
+    channel->recovered = 0.0;
+
+    channel->nextProfile = SIM_PROFILE_PERIOD;
+    channel->duty = SIM_DUTY_MIN;
+    channel->triggerDuty = SIM_DUTY_MIN;
+    channel->scanOffset = 3 * index;
+    channel->scanPeriod = 0;
+    SimChannelSenseAveraged(channel);
+    ChannelControlStart(&channel->control, phase);
+    channel->outer = false;
+    channel->stepped = false;
+}
+
+/**
+ * @brief SimChannelControl runs the firmware of a channel for the inner tick
+ *        at time t: the profile, the sensors and the control loops.
+ *
+ * @param channel Channel to step.
+ * @param t       Time of the tick (s).
+ */
+inline void SimChannelControl(SimChannel_t * channel, double t) {
+    ChannelControl_t & control = channel->control;
+    const SimConfig_t & config = channel->config;
+    SimMetrics_t & metrics = channel->metrics;
+    double dt = SIM_INNER_DECIMATION / SIM_F_SW;
+    channel->outer = false;
+    channel->stepped = false;
+
+    if (t >= channel->nextProfile) {
+        channel->nextProfile += SIM_PROFILE_PERIOD;
+        enum SimChange change = config.profile(t, &channel->array, config.profileData);
+        if (change != SIM_UNCHANGED) channel->curve = PVCurveBuild(&channel->array, 2000);
+        if (change == SIM_EVENT) SimMetricsEvent(&metrics, t);
+        else if (change == SIM_DRIFT) SimMetricsDrift(&metrics, t);
+    }
+
+    /* read_sensor(): the DMA scan converted every sensor. */
+    ChannelSample_t sample = {
+        channel->sensed.arrVoltage,
+        channel->sensed.arrCurrent,
+        channel->sensed.battVoltage,
+        channel->sensed.battCurrent,
+        CHANNEL_ARR_VOLTAGE | CHANNEL_ARR_CURRENT | CHANNEL_BATT_VOLTAGE | CHANNEL_BATT_CURRENT
+    };
+    if (!ChannelControlSense(&control, &sample)) {
+        if (control.events & CHANNEL_CLOSED) channel->recovered = t + SIM_VOC_RECOVERY;
+        return;
+    }
+    uint64_t start = SimCycles();
+    channel->duty = ChannelControlStep(&control);
+    uint64_t cycles = SimCycles() - start;
+
+    uint8_t events = control.events;
+    channel->outer = events & CHANNEL_OUTER;
+    channel->stepped = events & CHANNEL_STEPPED;
+    if (events & CHANNEL_STEPPED) SimMetricsStep(&metrics, (double) cycles);
+    if (events & CHANNEL_UNIFORM) SimMetricsDetect(&metrics, t, false);
+    if (events & CHANNEL_SHADING) SimMetricsDetect(&metrics, t, true);
+    if (events & CHANNEL_SWEPT) {
+        EfficiencyMeter_t & meter = control.meter;
+        SimMetricsMeter(&metrics, meter.ratio, SimLocalEfficiency(&channel->curve, meter.center), meter.lost);
+    }
+    if (events & CHANNEL_SCANNED) SimMetricsScan(&metrics, control.scan.samples * dt, control.scan.lost);
+    if ((events & CHANNEL_OUTER) && config.trace != NULL) {
+        config.trace(t, &channel->model, &channel->curve, control.arbiter.limiters[LOOP_MPPT].reference);
+    }
+}
+
+/**
+ * @brief SimChannelPlant integrates the plant of a channel over the inner tick
+ *        at time t, and records its power into the metrics.
+ *
+ * @param channel Channel to step.
+ * @param t       Time of the tick (s).
+ */
+inline void SimChannelPlant(SimChannel_t * channel, double t) {
+    BoostModel_t & model = channel->model;
+    const PVCurve_t * curve = &channel->curve;
+    double dt = SIM_INNER_DECIMATION / SIM_F_SW;
+    bool open = channel->control.mppt.fv.measuring;
+
+    double energy = 0.0;
+    if (channel->config.switching && !open) {
+        /* Inverse logic: the high side conducts first, then the low side. The
+           scan converts at the middle of either, as placed for triggerDuty. */
+        double midOn = (1.0 - channel->triggerDuty) / 2.0;
+        double midOff = 1.0 - channel->triggerDuty / 2.0;
+        for (int period = 0; period < SIM_INNER_DECIMATION; ++period) {
+            for (int k = 0; k < SIM_SWITCHING_SUBSTEPS; ++k) {
+                /* The substep of the edge switches for its share of it. */
+                double on = (k + 1.0) - (1.0 - channel->duty) * SIM_SWITCHING_SUBSTEPS;
+                if (on < 0.0) on = 0.0;
+                else if (on > 1.0) on = 1.0;
+                double h = 1.0 / (SIM_F_SW * SIM_SWITCHING_SUBSTEPS);
+                BoostModelStep(&model, curve, on, h);
+                energy += model.vArr * model.iArr * h;
+                double before = (double) k / SIM_SWITCHING_SUBSTEPS;
+                double after = (double) (k + 1) / SIM_SWITCHING_SUBSTEPS;
+                if (before < midOn && midOn <= after) SimChannelConvert(channel, channel->scanPeriod, true);
+                if (before < midOff && midOff <= after) SimChannelConvert(channel, channel->scanPeriod, false);
+            }
+            if (++channel->scanPeriod >= SIM_SCAN_PERIODS) {
+                /* VREFINT took the last period; the scan is complete. */
+                channel->scanPeriod = 0;
+                channel->sensed = {
+                    channel->pending.arrVoltage / 2,
+                    channel->pending.arrCurrent / 2,
+                    channel->pending.battVoltage / 2,
+                    channel->pending.battCurrent / 2
+                };
+                channel->pending = { 0.0f, 0.0f, 0.0f, 0.0f };
+            }
+        }
+    } else {
+        for (int k = 0; k < SIM_SUBSTEPS; ++k) {
+            if (open) BoostModelStepOpen(&model, curve, dt / SIM_SUBSTEPS);
+            else BoostModelStep(&model, curve, channel->duty, dt / SIM_SUBSTEPS);
+            energy += model.vArr * model.iArr * dt / SIM_SUBSTEPS;
+        }
+        SimChannelSenseAveraged(channel);
+    }
+    SimMetricsSample(
+        &channel->metrics,
+        t,
+        dt,
+        energy / dt,
+        curve->pmpp,
+        GlobalScanRunning(&channel->control.scan) || open || t < channel->recovered
+    );
+}
+
+/**
+ * @brief SimRun runs a tracker through a simulation and returns its metrics.
+ *
+ * @param tracker Tracker under test.
+ * @param config  Run parameters and array profile.
+ * @return Tracking efficiency and convergence times of the run.
+ */
+inline SimMetrics_t SimRun(SimTracker_t tracker, SimConfig_t config) {
+    SimChannel_t channel;
+    SimChannelInit(&channel, tracker, config, 1, 0, 0);
+    double dt = SIM_INNER_DECIMATION / SIM_F_SW;
+    for (double t = 0.0; t < config.duration; t += dt) {
+        SimChannelControl(&channel, t);
+        channel.triggerDuty = channel.duty;
+        SimChannelPlant(&channel, t);
+    }
+    SimMetricsFinish(&channel.metrics);
+    return channel.metrics;
+}
+
+/** @brief Definition of the control load of a run with several channels. */
+typedef struct SimLoad {
+    /** @brief Most outer stages run in one inner tick. */
+    int outerMax;
+
+    /** @brief Most tracker steps run in one inner tick. */
+    int stepsMax;
+
+    /** @brief Mean host cycles of the control of all channels per inner tick. */
+    double cycles;
+
+    /** @brief Mean host cycles of the inner ticks that run an outer stage. */
+    double cyclesOuter;
+} SimLoad_t;
+
+/**
+ * @brief SimRunChannels runs several channels from one tick loop, like
+ *        run_controller() with NUM_CHANNELS, and returns their metrics.
+ *
+ * @param trackers  Tracker of each channel.
+ * @param configs   Run parameters and array profile of each channel. The
+ *                  duration of the first applies to all.
+ * @param count     Number of channels.
+ * @param staggered Whether channel k runs its outer stage
+ *                  k * OUTER_DECIMATION / count inner ticks after channel 0,
+ *                  instead of in the same tick.
+ * @param metrics   Metrics of each channel.
+ * @return Control load per inner tick.
+ */
+inline SimLoad_t SimRunChannels(
+    const SimTracker_t * trackers,
+    const SimConfig_t * configs,
+    size_t count,
+    bool staggered,
+    SimMetrics_t * metrics
+) {
+    std::vector<SimChannel_t> channels(count);
+    for (size_t k = 0; k < count; ++k) {
+        uint16_t phase = staggered ? (uint16_t) (k * SIM_OUTER_DECIMATION / count) : 0;
+        SimChannelInit(&channels[k], trackers[k], configs[k], (uint32_t) (1 + k), phase, (uint8_t) k);
+    }
+
+    SimLoad_t load = { 0, 0, 0.0, 0.0 };
+    long ticks = 0;
+    long outerTicks = 0;
+    double dt = SIM_INNER_DECIMATION / SIM_F_SW;
+    for (double t = 0.0; t < configs[0].duration; t += dt) {
+        uint64_t start = SimCycles();
+        for (size_t k = 0; k < count; ++k) SimChannelControl(&channels[k], t);
+        double cycles = (double) (SimCycles() - start);
+
+        int outer = 0;
+        int steps = 0;
+        for (size_t k = 0; k < count; ++k) {
+            if (channels[k].outer) ++outer;
+            if (channels[k].stepped) ++steps;
+            channels[k].triggerDuty = channels[0].duty;
+            SimChannelPlant(&channels[k], t);
+        }
+        if (outer > load.outerMax) load.outerMax = outer;
+        if (steps > load.stepsMax) load.stepsMax = steps;
+        load.cycles += cycles;
+        ++ticks;
+        if (outer > 0) {
+            load.cyclesOuter += cycles;
+            ++outerTicks;
+        }
+    }
+    load.cycles /= ticks > 0 ? ticks : 1;
+    load.cyclesOuter /= outerTicks > 0 ? outerTicks : 1;
+    for (size_t k = 0; k < count; ++k) {
+        SimMetricsFinish(&channels[k].metrics);
+        metrics[k] = channels[k].metrics;
+    }
+    return load;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file skew.hpp
+ * @author Matthew Yu (matthewjkyu@gmail.com)
+ * @brief Bias of the array power from the time skew between the array voltage
+ *        and current conversions, for the conversion orders of the DMA scan.
+ * @version 0.1
+ * @date 2023-09-10
+ * @copyright Copyright (c) 2023
+ */
+#pragma once
+
+/** General imports. */
+#include <math.h>
+#include <random>
+#include <vector>
+
+/** Device Specific imports. */
+#include "./boost_model.hpp"
+#include "./pv_model.hpp"
+#include "./simulation.hpp"
+
+
+/*
+The ADC converts one channel at a time, so the array voltage and current of
+a power sample are never taken at the same instant. The test holds the
+switched plant open loop at the MPP duty cycle, and dithers the duty cycle by
++-SKEW_DITHER every SKEW_HALF inner ticks, like the steps of a step tracker
+or the dither of extremum seeking; the array voltage and inductor current
+then ring at the corner of the inductor and the input capacitor after every
+step, on top of the switching ripple. The plant is recorded at SKEW_SUBSTEPS
+per PWM period, and every inner tick each scheme samples the recording like
+the DMA scan would:
+
+- continuous:    one conversion every SKEW_CONVERSION, at a phase of the PWM
+                 period that drifts with the free running scan.
+- continuous x4: the same, oversampled 4 times; every conversion is the mean
+                 of 4 back to back.
+- mid on:        one conversion per PWM period, at the middle of the on time.
+- both:          one conversion per half PWM period, at the middle of the on
+                 and the off time; each sensor is converted at both.
+
+The sequential orders convert the voltage, then the current (V-I, or V-V-I-I
+for both). The centered orders bracket the current with the voltage (V-I-V,
+or V-I-I-V for both), so that the mean time of the voltage conversions is
+that of the current conversions.
+
+The reference of every tick is the product of the voltage and the current,
+both at the instants the current was converted. The report gives the mean
+(bias) and the RMS of the error of the sensed power against it, and the same
+of the difference in mean power between the halves of the dither, which is
+what the trackers act upon. Sensing is exact, without quantization or noise,
+so that only the skew remains.
+*/
+
+#define SKEW_SUBSTEPS 64
+#define SKEW_SETTLE 20E-3 // s
+#define SKEW_DURATION 0.25 // s
+#define SKEW_DITHER 0.0025 // Duty cycle, 0.25 V at the array on a 100 V battery.
+#define SKEW_HALF 26 // Inner ticks, a 200 Hz dither.
+#define SKEW_CONVERSION 3E-6 // s, (47.5 + 12.5) cycles at 20 MHz.
+#define SKEW_MAX_SAMPLES 12
+
+/** @brief Definition of the conversions of one power sample. */
+typedef struct SkewScheme {
+    /** @brief Names of the timing and the order in the report. */
+    const char * timing;
+    const char * order;
+
+    /**
+     * @brief Whether the first conversion is at the middle of the on time, or
+     *        at a phase of the PWM period that drifts.
+     */
+    bool midOn;
+
+    /** @brief Conversions, as 'V' or 'I', and their offsets from the first (s). */
+    uint8_t count;
+    char sensor[SKEW_MAX_SAMPLES];
+    double offset[SKEW_MAX_SAMPLES];
+} SkewScheme_t;
+
+/** @brief Definition of the errors of a scheme. */
+typedef struct SkewResult {
+    /** @brief Mean and RMS error of the power samples (W). */
+    double bias;
+    double rms;
+
+    /** @brief Mean and RMS error of the power step between dither halves (W). */
+    double stepBias;
+    double stepRms;
+
+    /** @brief Mean magnitude of the power step of the reference (W). */
+    double step;
+} SkewResult_t;
+
+/** @brief Recording of the plant at SKEW_SUBSTEPS per PWM period. */
+typedef struct SkewTrace {
+    /** @brief Array voltage and inductor current at every substep (V, A). */
+    std::vector<double> v;
+    std::vector<double> i;
+
+    /** @brief Duty cycle of every inner tick. */
+    std::vector<double> duty;
+
+    /** @brief Substep (s). */
+    double h;
+} SkewTrace_t;
+
+/** @brief Value of a recording at time t, linearly interpolated. */
+inline double SkewAt(const std::vector<double> & x, double h, double t) {
+    double k = t / h;
+    size_t j = (size_t) k;
+    if (j + 1 >= x.size()) return x.back();
+    return x[j] + (k - j) * (x[j + 1] - x[j]);
+}
+
+/** @brief Records the dithered plant at irradiance g (W/m^2). */
+inline SkewTrace_t SkewRecord(double g, double vBatt) {
+    PVArray_t array = PVArrayInit();
+    PVArraySetIrradiance(&array, g);
+    PVCurve_t curve = PVCurveBuild(&array, 2000);
+    BoostModel_t model = BoostModelInit(vBatt, curve.voc);
+    double center = 1.0 - curve.vmpp / vBatt;
+    model.vArr = curve.vmpp;
+    model.iL = PVCurveCurrent(&curve, curve.vmpp);
+
+    SkewTrace_t trace;
+    trace.h = 1.0 / (SIM_F_SW * SKEW_SUBSTEPS);
+    long settle = (long) (SKEW_SETTLE * SIM_F_SW / SIM_INNER_DECIMATION);
+    long ticks = settle + (long) (SKEW_DURATION * SIM_F_SW / SIM_INNER_DECIMATION);
+    for (long tick = 0; tick < ticks; ++tick) {
+        double duty = center + ((tick / SKEW_HALF) % 2 == 0 ? SKEW_DITHER : -SKEW_DITHER);
+        if (tick >= settle) trace.duty.push_back(duty);
+        for (int period = 0; period < SIM_INNER_DECIMATION; ++period) {
+            /* Inverse logic like SimChannelPlant: the high side conducts first,
+               and the substep of the edge switches for its share of it. */
+            for (int k = 0; k < SKEW_SUBSTEPS; ++k) {
+                double on = (k + 1.0) - (1.0 - duty) * SKEW_SUBSTEPS;
+                if (on < 0.0) on = 0.0;
+                else if (on > 1.0) on = 1.0;
+                BoostModelStep(&model, &curve, on, trace.h);
+                if (tick >= settle) {
+                    trace.v.push_back(model.vArr);
+                    trace.i.push_back(model.iL);
+                }
+            }
+        }
+    }
+    return trace;
+}
+
+/** @brief Samples the recording with a scheme and accumulates its errors. */
+inline SkewResult_t SkewEvaluate(const SkewTrace_t * trace, const SkewScheme_t * scheme, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> drift(0.0, 1.0);
+    double period = 1.0 / SIM_F_SW;
+    size_t perTick = SKEW_SUBSTEPS * SIM_INNER_DECIMATION;
+    size_t ticks = trace->v.size() / perTick;
+
+    double sum = 0.0;
+    double squares = 0.0;
+    double half = 0.0;
+    double halfRef = 0.0;
+    double previous = 0.0;
+    double previousRef = 0.0;
+    double stepSum = 0.0;
+    double stepSquares = 0.0;
+    double stepMagnitude = 0.0;
+    long steps = 0;
+    for (size_t tick = 0; tick + 1 < ticks; ++tick) {
+        double start = tick * perTick * trace->h;
+        double duty = trace->duty[tick];
+        double phase = scheme->midOn ? (1.0 - duty) / 2.0 : drift(rng);
+        double first = start + phase * period;
+
+        double v = 0.0;
+        double i = 0.0;
+        double vRef = 0.0;
+        int numV = 0;
+        int numI = 0;
+        for (uint8_t k = 0; k < scheme->count; ++k) {
+            double t = first + scheme->offset[k];
+            if (scheme->sensor[k] == 'V') {
+                v += SkewAt(trace->v, trace->h, t);
+                ++numV;
+            } else {
+                i += SkewAt(trace->i, trace->h, t);
+                vRef += SkewAt(trace->v, trace->h, t);
+                ++numI;
+            }
+        }
+        double p = v / numV * i / numI;
+        double pRef = vRef / numI * i / numI;
+        sum += p - pRef;
+        squares += (p - pRef) * (p - pRef);
+
+        /* Mean power of every dither half; a step is high minus low. */
+        half += p;
+        halfRef += pRef;
+        if ((tick + 1) % SKEW_HALF == 0) {
+            half /= SKEW_HALF;
+            halfRef /= SKEW_HALF;
+            if ((tick + 1) % (2 * SKEW_HALF) == 0) {
+                double step = previous - half;
+                double stepRef = previousRef - halfRef;
+                stepSum += step - stepRef;
+                stepSquares += (step - stepRef) * (step - stepRef);
+                stepMagnitude += fabs(stepRef);
+                ++steps;
+            }
+            previous = half;
+            previousRef = halfRef;
+            half = 0.0;
+            halfRef = 0.0;
+        }
+    }
+
+    SkewResult_t result;
+    size_t n = ticks - 1;
+    result.bias = sum / n;
+    result.rms = sqrt(squares / n);
+    result.stepBias = steps > 0 ? stepSum / steps : 0.0;
+    result.stepRms = steps > 0 ? sqrt(stepSquares / steps) : 0.0;
+    result.step = steps > 0 ? stepMagnitude / steps : 0.0;
+    return result;
+}
+
+/** @brief Appends n conversions of a sensor, `spacing` apart, to a scheme. */
+inline void SkewAppend(SkewScheme_t * scheme, char sensor, int n, double spacing) {
+    double t = scheme->count > 0 ? scheme->offset[scheme->count - 1] + spacing : 0.0;
+    for (int k = 0; k < n; ++k) {
+        scheme->sensor[scheme->count] = sensor;
+        scheme->offset[scheme->count] = t;
+        ++scheme->count;
+        t += spacing;
+    }
+}
+
+/** @brief Schemes of every timing of the DMA scan, sequential then centered. */
+inline std::vector<SkewScheme_t> SkewSchemes(void) {
+    std::vector<SkewScheme_t> schemes;
+    double period = 1.0 / SIM_F_SW;
+    struct { const char * timing; bool midOn; int oversampling; double spacing; } timings[] = {
+        { "continuous", false, 1, SKEW_CONVERSION },
+        { "continuous x4", false, 4, SKEW_CONVERSION },
+        { "mid on", true, 1, period },
+    };
+    for (auto & timing : timings) {
+        const char * orders[] = { "VI", "VIV" };
+        for (const char * order : orders) {
+            SkewScheme_t scheme = { timing.timing, order[2] ? "V-I-V" : "V-I", timing.midOn, 0, {}, {} };
+            for (const char * c = order; *c; ++c) SkewAppend(&scheme, *c, timing.oversampling, timing.spacing);
+            schemes.push_back(scheme);
+        }
+    }
+
+    /* Both points: conversions alternate between the middle of the on and
+       the off time, half a period apart. */
+    const char * orders[][2] = { { "VVII", "V-V-I-I" }, { "VIIV", "V-I-I-V" } };
+    for (auto & order : orders) {
+        SkewScheme_t scheme = { "both", order[1], true, 0, {}, {} };
+        for (const char * c = order[0]; *c; ++c) SkewAppend(&scheme, *c, 1, period / 2.0);
+        schemes.push_back(scheme);
+    }
+    return schemes;
+}
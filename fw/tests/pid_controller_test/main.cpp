@@ -15,6 +15,7 @@
 #include "FastPWM.h"
 #include "./pid_controller/pid_controller.hpp"
 #include "./Filter/SmaFilter.h"
+#include "../../inc/calibration/calibration_tables.hpp"
 
 #define F_SW 104000.0 // 104 khz switching
 #define TARGET 86.0
@@ -60,33 +61,19 @@ Ticker ticker_check_redlines;
 
 static int x = 0;
 
-float calibrate_arr_v(float inp) {
-    if (inp < 1.0) return inp * 114.0;
-    else return 114.0;
-}
-
-float calibrate_arr_i(float inp) {
-    if (inp < 1.0) return inp * 5.79 + 0.0042;
-    else return 5.79;
-}
-
-float calibrate_batt_v(float inp) {
-    if (inp < 1.0) return inp * 168.0 + 0.0393;
-    else return 168.0;
-}
-
-float calibrate_batt_i(float inp) {
-    if (inp < 1.0) return inp * 5.8 + 0.0167;
-    else return 5.8;
-}
+// Sensor calibration by raw code, see sw/calibration_fit.py.
+float calibrate_arr_v(uint16_t code) { return CalibrationApply(&CALIBRATION[0].arrVoltage, code); }
+float calibrate_arr_i(uint16_t code) { return CalibrationApply(&CALIBRATION[0].arrCurrent, code); }
+float calibrate_batt_v(uint16_t code) { return CalibrationApply(&CALIBRATION[0].battVoltage, code); }
+float calibrate_batt_i(uint16_t code) { return CalibrationApply(&CALIBRATION[0].battCurrent, code); }
 
 void heartbeat() { led_heartbeat = !led_heartbeat; }
 
 void read_sensor(void) {
-    float arr_v = calibrate_arr_v(arr_voltage_sensor.read());
-    float arr_i = calibrate_arr_i(arr_current_sensor.read());
-    float batt_v = calibrate_batt_v(batt_voltage_sensor.read());
-    float batt_i = calibrate_batt_i(batt_current_sensor.read());
+    float arr_v = calibrate_arr_v(arr_voltage_sensor.read_u16());
+    float arr_i = calibrate_arr_i(arr_current_sensor.read_u16());
+    float batt_v = calibrate_batt_v(batt_voltage_sensor.read_u16());
+    float batt_i = calibrate_batt_i(batt_current_sensor.read_u16());
 
     // INJECT NOISE :O
     float amplitude = TARGET * 0.001;
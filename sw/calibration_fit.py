@@ -0,0 +1,280 @@
+"""_summary_
+@file       calibration_fit.py
+@author     Matthew Yu (matthewjkyu@gmail.com)
+@brief      Fit the piecewise linear sensor calibration tables of the firmware
+            to bench measurements, and compile them into a header.
+
+@version    0.1.0
+@date       2023-09-09
+
+Usage: flash fw/tests/adc_test, and capture its CSV output while stepping the
+bench supply as described there, i.e. `cat /dev/ttyACM0 > channel0.csv`. Add
+a reference column per sensor, "arr_v ref (V)", "arr_i ref (A)",
+"batt_v ref (V)" or "batt_i ref (A)", holding the multimeter reading on the
+rows where it applies and empty elsewhere. Then run
+`python3 calibration_fit.py channel0.csv [channel1.csv ...] -o ../fw/inc/calibration/calibration_tables.hpp`,
+one capture per converter channel, in order. adc_test refers the raw codes to
+a 3.3 V supply through VREFINT, like the DMA scan of the firmware.
+
+Every table has a breakpoint every 4096 raw codes, see
+fw/inc/calibration/calibration.hpp. The breakpoints are fitted by least
+squares on the reference points, with a penalty on their second differences,
+so that segments without reference points continue the neighbouring slope
+rather than float. Sensors without reference points keep the linear fits the
+firmware used before the tables, from DEFAULTS. The table is then rounded to
+integers exactly like the firmware evaluates it, and the error on the
+reference points is reported and written into the header.
+"""
+
+import argparse
+import csv
+import logging
+import sys
+
+import numpy as np
+
+# Mirrors fw/inc/calibration/calibration.hpp.
+SHIFT = 12
+POINTS = (1 << (16 - SHIFT)) + 1
+
+# Sensor, struct member, unit, and the linear fit (gain, offset) on the
+# fraction of full scale the firmware used before.
+SENSORS = [
+    ("arr_v", "arrVoltage", "V", (114.0, 0.0)),
+    ("arr_i", "arrCurrent", "A", (5.79, 0.0042)),
+    ("batt_v", "battVoltage", "V", (168.0, 0.0393)),
+    ("batt_i", "battCurrent", "A", (5.8, 0.0167)),
+]
+
+
+def read_capture(path):
+    """_summary_
+    Reads the raw codes and reference values of every sensor from an adc_test
+    capture. Lines that are not CSV rows of the header's width, e.g. boot
+    messages, are skipped.
+
+    Args:
+        path (str): adc_test capture with reference columns.
+
+    Returns:
+        dict: Per sensor name, a tuple of code and reference arrays.
+    """
+    with open(path, newline="") as fp:
+        rows = list(csv.reader(fp))
+    header = None
+    points = {name: ([], []) for name, _, _, _ in SENSORS}
+    for row in rows:
+        row = [cell.strip() for cell in row]
+        if header is None:
+            if any(cell.endswith(" code") for cell in row):
+                header = {cell: idx for idx, cell in enumerate(row)}
+            continue
+        if len(row) > len(header) or len(row) < 2:
+            continue
+        for name, _, unit, _ in SENSORS:
+            code = header.get(f"{name} code")
+            ref = header.get(f"{name} ref ({unit})")
+            if code is None or ref is None or ref >= len(row) or row[ref] == "":
+                continue
+            try:
+                points[name][0].append(float(row[code]))
+                points[name][1].append(float(row[ref]))
+            except ValueError:
+                continue
+    if header is None:
+        raise ValueError(f"{path} has no header with raw code columns.")
+    return {name: (np.array(c), np.array(r)) for name, (c, r) in points.items()}
+
+
+def default_table(gain, offset):
+    """_summary_
+    Breakpoints of the linear fit the firmware used before the tables.
+    """
+    codes = np.arange(POINTS) * (1 << SHIFT)
+    return gain * codes / 65535 + offset
+
+
+def fit_table(codes, refs, smoothing):
+    """_summary_
+    Fits the breakpoints by least squares with a second difference penalty.
+
+    Args:
+        codes (np.array): Raw codes.
+        refs (np.array): Reference values at the codes.
+        smoothing (float): Weight of the second differences.
+
+    Returns:
+        np.array: Breakpoints, in the unit of refs.
+    """
+    k = np.minimum(codes.astype(int) >> SHIFT, POINTS - 2)
+    r = (codes - k * (1 << SHIFT)) / (1 << SHIFT)
+    a = np.zeros((len(codes), POINTS))
+    a[np.arange(len(codes)), k] = 1 - r
+    a[np.arange(len(codes)), k + 1] = r
+
+    d = np.zeros((POINTS - 2, POINTS))
+    for idx in range(POINTS - 2):
+        d[idx, idx : idx + 3] = [1, -2, 1]
+
+    lhs = np.vstack((a, np.sqrt(smoothing * len(codes)) * d))
+    rhs = np.concatenate((refs, np.zeros(POINTS - 2)))
+    points, *_ = np.linalg.lstsq(lhs, rhs, rcond=None)
+    return points
+
+
+def quantize(points):
+    """_summary_
+    Picks the finest decimal lsb at which the interpolation cannot overflow
+    32 bits, and rounds the breakpoints to it.
+
+    Returns:
+        (np.array, float): Integer breakpoints and their lsb.
+    """
+    step = np.max(np.abs(np.diff(points)))
+    for exponent in range(-6, 3):
+        lsb = 10.0**exponent
+        table = np.round(points / lsb).astype(np.int64)
+        if np.max(np.abs(np.diff(table))) * ((1 << SHIFT) - 1) < 2**31 and np.max(
+            np.abs(table)
+        ) < 2**31:
+            return table, lsb
+    raise ValueError(f"Segment step of {step:g} does not fit a table.")
+
+
+def evaluate(table, lsb, codes):
+    """_summary_
+    Evaluates the table exactly like CalibrationLookup.
+    """
+    codes = codes.astype(np.int64)
+    k = codes >> SHIFT
+    r = codes & ((1 << SHIFT) - 1)
+    return (table[k] + (((table[k + 1] - table[k]) * r) >> SHIFT)) * lsb
+
+
+def calibrate_channel(captured, args):
+    """_summary_
+    Fits every sensor of a channel, or keeps its default.
+
+    Returns:
+        [dict]: Per sensor, the member, unit, table, lsb, and the points and
+        errors of the fit (None for the default).
+    """
+    results = []
+    for name, member, unit, (gain, offset) in SENSORS:
+        codes, refs = captured.get(name, (np.array([]), np.array([])))
+        if len(np.unique(codes)) >= 2:
+            table, lsb = quantize(fit_table(codes, refs, args.smoothing))
+            error = evaluate(table, lsb, np.clip(codes, 0, 65535)) - refs
+            linear = gain * codes / 65535 + offset - refs
+            errors = (np.max(np.abs(error)), np.sqrt(np.mean(error**2)))
+            logging.info(
+                f"    {name}: {len(codes)} points, max error {errors[0]:.4g} {unit}, "
+                f"RMS {errors[1]:.4g} {unit}; linear max {np.max(np.abs(linear)):.4g} {unit}."
+            )
+        else:
+            table, lsb = quantize(default_table(gain, offset))
+            errors = None
+            logging.info(f"    {name}: no reference points, linear fit kept.")
+        results.append(
+            {
+                "member": member,
+                "unit": unit,
+                "table": table,
+                "lsb": lsb,
+                "points": len(codes),
+                "errors": errors,
+            }
+        )
+    return results
+
+
+def _literal(v):
+    s = f"{v:.6g}"
+    if "." not in s and "e" not in s:
+        s += ".0"
+    return s + "f"
+
+
+def emit_header(channels, sources, path):
+    lines = []
+    lines.append("/**")
+    lines.append(" * @file calibration_tables.hpp")
+    lines.append(" * @author Generated by sw/calibration_fit.py. Do not edit by hand.")
+    lines.append(" * @brief Sensor calibration tables of every converter channel.")
+    lines.append(f" * @note Source: {', '.join(sources)}")
+    lines.append(" */")
+    lines.append("#pragma once")
+    lines.append("")
+    lines.append("/** Device Specific imports. */")
+    lines.append('#include "./calibration.hpp"')
+    lines.append("")
+    lines.append("")
+    lines.append(f"#define CALIBRATION_CHANNELS {len(channels)}")
+    lines.append("")
+    lines.append("/** Calibration of every converter channel, by raw code. */")
+    lines.append("static constexpr CalibrationSet_t CALIBRATION[CALIBRATION_CHANNELS] = {")
+    for idx, (results, source) in enumerate(zip(channels, sources)):
+        lines.append(f"    {{ // Channel {idx}, {source}")
+        for result in results:
+            if result["errors"] is None:
+                note = "linear default"
+            else:
+                note = (
+                    f"{result['points']} points, max error "
+                    f"{result['errors'][0]:.3g} {result['unit']}"
+                )
+            lines.append(f"        {{ // .{result['member']}, {note}")
+            lines.append("            { " + ", ".join(str(v) for v in result["table"]) + " },")
+            lines.append(f"            {_literal(result['lsb'])}")
+            lines.append("        },")
+        lines.append("    },")
+    lines.append("};")
+    lines.append("")
+
+    with open(path, "w") as fp:
+        fp.write("\n".join(lines))
+
+
+if __name__ == "__main__":
+    if sys.version_info[0] < 3:
+        raise Exception("This program only supports Python 3.")
+
+    parser = argparse.ArgumentParser(
+        description="Fit the sensor calibration tables to adc_test captures."
+    )
+    parser.add_argument(
+        "captures", nargs="*", help="adc_test capture with reference columns, per channel."
+    )
+    parser.add_argument(
+        "-o",
+        "--output",
+        default="../fw/inc/calibration/calibration_tables.hpp",
+        help="Generated header.",
+    )
+    parser.add_argument(
+        "-n",
+        "--channels",
+        type=int,
+        default=2,
+        help="Converter channels; those without a capture keep the linear fits.",
+    )
+    parser.add_argument("--smoothing", type=float, default=1e-3)
+    args = parser.parse_args()
+
+    logging.basicConfig(format="%(message)s", level=logging.INFO)
+
+    channels = []
+    sources = []
+    for idx in range(max(args.channels, len(args.captures))):
+        if idx < len(args.captures):
+            logging.info(f"Channel {idx}: {args.captures[idx]}")
+            captured = read_capture(args.captures[idx])
+            sources.append(args.captures[idx])
+        else:
+            logging.info(f"Channel {idx}: no capture")
+            captured = {}
+            sources.append("linear defaults")
+        channels.append(calibrate_channel(captured, args))
+
+    emit_header(channels, sources, args.output)
+    logging.info(f"Wrote {args.output}.")
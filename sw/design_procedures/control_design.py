@@ -0,0 +1,268 @@
+"""_summary_
+@file       control_design.py
+@author     Matthew Yu (matthewjkyu@gmail.com)
+@brief      Control design procedures for the boost converter: the averaged
+            small signal model and an explicit MPC solved as a multiparametric
+            QP.
+@version    0.1.0
+@date       2023-08-23
+@file_overview
+    get_passives
+        derive L and C_i from the design parameters
+    get_model
+        averaged input side model, discretized with a zero order hold
+    solve_explicit_mpc
+        enumerate active sets of the mp-QP, build each critical region and
+        its affine control law
+"""
+
+import itertools
+import logging
+
+import numpy as np
+from scipy.linalg import expm, solve_discrete_are
+from scipy.optimize import linprog
+
+# Parameter vector of the explicit MPC. The first two entries are the state in
+# deviation coordinates; the rest enter the constraints and the law.
+THETA_NAMES = ["e_v", "d_i", "i_arr", "v_ref", "v_out", "i_lim"]
+
+
+def get_passives(design):
+    """_summary_
+    Derives the inductance and input capacitance from the ripple requirements
+    of a design, at the worst case of the design map.
+
+    Args:
+        design (dict): "DESIGN" entry of a design_parameters.json file.
+
+    Returns:
+        (double, double): Inductance (H), input capacitance (F).
+    """
+    f_sw = design["switches"]["f_sw"]
+    i_pp = design["inductor"]["i_pp"]
+    v_pp = design["input_cap"]["v_pp"]
+    map = design["map"]
+
+    l = 0.0
+    for vi in map["inp_vol"]:
+        for vo in map["out_vol"]:
+            d = 1 - vi / vo
+            l = max(l, d * vi / (f_sw * i_pp))
+    ci = i_pp / (8 * f_sw * v_pp)
+    return l, ci
+
+
+def get_model(l, ci, r_l, r_ci, t_s):
+    """_summary_
+    Averaged model of the input side of the boost converter, in deviation
+    coordinates around an operating point (v_ref, i_arr):
+
+        C_i de/dt   = -d_i
+        L   dd_i/dt = e - (r_ci + r_l) d_i - d_u
+
+    Where e = v_arr - v_ref, d_i = i_L - i_arr, and d_u is the switch node
+    voltage (1 - d) v_out relative to its steady state v_ref - r_l i_arr. The
+    array current is treated as a measured disturbance held over the horizon.
+
+    Args:
+        l (double): Inductance (H).
+        ci (double): Input capacitance (F).
+        r_l (double): Inductor DCR (Ohms).
+        r_ci (double): Input capacitor ESR (Ohms).
+        t_s (double): Sample period (s).
+
+    Returns:
+        (np.ndarray, np.ndarray): Discrete A (2x2), B (2x1).
+    """
+    a = np.array([[0.0, -1.0 / ci], [1.0 / l, -(r_ci + r_l) / l]])
+    b = np.array([[0.0], [-1.0 / l]])
+
+    # Zero order hold via the augmented matrix exponential.
+    m = np.zeros((3, 3))
+    m[:2, :2] = a
+    m[:2, 2:] = b
+    md = expm(m * t_s)
+    return md[:2, :2], md[:2, 2:]
+
+
+def _chebyshev(h, k):
+    """Returns the Chebyshev radius and center of {x | h x <= k}."""
+    norm = np.linalg.norm(h, axis=1)
+    c = np.zeros(h.shape[1] + 1)
+    c[-1] = -1.0
+    a_ub = np.hstack([h, norm[:, None]])
+    res = linprog(c, A_ub=a_ub, b_ub=k, bounds=[(None, None)] * h.shape[1] + [(0, None)])
+    if res.status != 0:
+        return 0.0, None
+    return res.x[-1], res.x[:-1]
+
+
+def _remove_redundant(h, k, eps=1e-9):
+    """Returns the rows of {x | h x <= k} that are not implied by the others."""
+    keep = []
+    for i in range(len(k)):
+        others = [j for j in range(len(k)) if j != i]
+        res = linprog(
+            -h[i], A_ub=h[others], b_ub=k[others] + eps, bounds=[(None, None)] * h.shape[1]
+        )
+        # Unbounded or exceeding the facet means the facet is needed.
+        if res.status != 0 or -res.fun > k[i] + 1e-7:
+            keep.append(i)
+    return keep
+
+
+def solve_explicit_mpc(a, b, q, r, n, r_l, duty, theta_min, theta_max):
+    """_summary_
+    Solves the explicit MPC for the model as a multiparametric QP by
+    enumerating active sets.
+
+    Decision variables are the horizon of switch node deviations d_u. The
+    constraints are the duty cycle range at every step and the inductor current
+    limit i_lim at every predicted step. The terminal cost is the LQR cost to
+    go.
+
+    Args:
+        a (np.ndarray): Discrete A.
+        b (np.ndarray): Discrete B.
+        q (np.ndarray): State weight (2x2).
+        r (double): Input weight.
+        n (int): Horizon.
+        r_l (double): Inductor DCR (Ohms), for the steady state switch node.
+        duty ([double, double]): Duty cycle range.
+        theta_min ([double]): Lower bound of each parameter.
+        theta_max ([double]): Upper bound of each parameter.
+
+    Returns:
+        [dict]: Critical regions with keys h, k (h theta <= k within the
+        parameter box), f, g (v_sw = f theta + g) and active (active set).
+    """
+    n_theta = len(THETA_NAMES)
+    theta_min = np.array(theta_min, dtype=float)
+    theta_max = np.array(theta_max, dtype=float)
+
+    # Prediction: z_k = A^k z_0 + sum A^(k-1-j) B u_j.
+    phi = np.vstack([np.linalg.matrix_power(a, k) for k in range(1, n + 1)])
+    gam = np.zeros((2 * n, n))
+    for k in range(1, n + 1):
+        for j in range(k):
+            gam[2 * (k - 1) : 2 * k, j : j + 1] = np.linalg.matrix_power(a, k - 1 - j) @ b
+
+    p = solve_discrete_are(a, b, q, np.array([[r]]))
+    q_bar = np.kron(np.eye(n), q)
+    q_bar[-2:, -2:] = p
+    h_qp = gam.T @ q_bar @ gam + r * np.eye(n)
+    h_inv = np.linalg.inv(h_qp)
+
+    # Linear term f_qp theta, with z_0 = theta[0:2].
+    f_qp = np.zeros((n, n_theta))
+    f_qp[:, 0:2] = gam.T @ q_bar @ phi
+
+    # Constraints g U <= s theta.
+    # Switch node: u = v_ref - r_l i_arr + d_u, (1 - d_max) v_out <= u <= (1 - d_min) v_out.
+    i_v_ref, i_i_arr, i_v_out, i_i_lim = 3, 2, 4, 5
+    g_rows = []
+    s_rows = []
+    for k in range(n):
+        row = np.zeros(n)
+        row[k] = 1.0
+        s = np.zeros(n_theta)
+        s[i_v_ref] = -1.0
+        s[i_i_arr] = r_l
+        s[i_v_out] = 1 - duty[0]
+        g_rows.append(row)
+        s_rows.append(s)
+
+        s = np.zeros(n_theta)
+        s[i_v_ref] = 1.0
+        s[i_i_arr] = -r_l
+        s[i_v_out] = -(1 - duty[1])
+        g_rows.append(-row)
+        s_rows.append(s)
+    # Current limit: i_arr + d_i_k <= i_lim.
+    for k in range(n):
+        g_rows.append(gam[2 * k + 1])
+        s = np.zeros(n_theta)
+        s[0:2] = -phi[2 * k + 1]
+        s[i_i_arr] = -1.0
+        s[i_i_lim] = 1.0
+        s_rows.append(s)
+    g = np.array(g_rows)
+    s = np.array(s_rows)
+
+    # Work in a normalized parameter box for conditioning.
+    center = (theta_max + theta_min) / 2
+    scale = (theta_max - theta_min) / 2
+    box_h = np.vstack([np.diag(1 / scale), -np.diag(1 / scale)])
+    box_k = np.concatenate([1 + center / scale, 1 - center / scale])
+
+    regions = []
+    n_con = len(g)
+    for n_active in range(0, n + 1):
+        for active in itertools.combinations(range(n_con), n_active):
+            active = list(active)
+            g_a = g[active]
+            if n_active > 0 and np.linalg.matrix_rank(g_a) < n_active:
+                continue
+
+            # U(theta) = k_u theta; lambda(theta) = k_l theta.
+            if n_active > 0:
+                m = g_a @ h_inv @ g_a.T
+                k_l = -np.linalg.solve(m, s[active] + g_a @ h_inv @ f_qp)
+                k_u = -h_inv @ (f_qp + g_a.T @ k_l)
+            else:
+                k_l = np.zeros((0, n_theta))
+                k_u = -h_inv @ f_qp
+
+            # Region: inactive primal feasibility and dual feasibility.
+            inactive = [i for i in range(n_con) if i not in active]
+            h_reg = np.vstack([g[inactive] @ k_u - s[inactive], -k_l])
+            k_reg = np.zeros(len(h_reg))
+
+            radius, _ = _chebyshev(np.vstack([h_reg, box_h]), np.concatenate([k_reg, box_k]))
+            if radius < 1e-6:
+                continue
+
+            # Drop facets implied by the others or by the box.
+            h_all = np.vstack([h_reg, box_h])
+            k_all = np.concatenate([k_reg, box_k])
+            keep = [i for i in _remove_redundant(h_all, k_all) if i < len(h_reg)]
+
+            # v_sw = v_ref - r_l i_arr + d_u_0.
+            f = k_u[0].copy()
+            f[i_v_ref] += 1.0
+            f[i_i_arr] -= r_l
+            regions.append(
+                {
+                    "h": h_reg[keep],
+                    "k": k_reg[keep],
+                    "f": f,
+                    "g": 0.0,
+                    "active": active,
+                    "radius": radius,
+                }
+            )
+            logging.info(f"Region {len(regions)}: active {active}, radius {radius:.4f}")
+
+    # Most likely regions first, i.e. the unconstrained law.
+    regions.sort(key=lambda region: (len(region["active"]), -region["radius"]))
+    return regions
+
+
+def evaluate_explicit_mpc(regions, theta, duty):
+    """_summary_
+    Host reference of the firmware lookup: first region containing theta.
+
+    Args:
+        regions ([dict]): Regions from solve_explicit_mpc.
+        theta (np.ndarray): Parameter vector, already clamped to the box.
+        duty ([double, double]): Duty cycle range.
+
+    Returns:
+        double: Duty cycle; d_min if no region contains theta.
+    """
+    for region in regions:
+        if np.all(region["h"] @ theta <= region["k"] + 1e-6):
+            v_sw = region["f"] @ theta + region["g"]
+            return min(max(1 - v_sw / theta[4], duty[0]), duty[1])
+    return duty[0]
@@ -0,0 +1,206 @@
+"""_summary_
+@file       fra.py
+@author     Matthew Yu (matthewjkyu@gmail.com)
+@brief      Decode frequency response analyzer tables streamed by the
+            firmware and fit the crossover frequency and phase margin.
+
+@version    0.1.0
+@date       2023-08-22
+
+Usage: capture the serial port of the Sunscatter with __FRA__ enabled in
+fw/src/main.cpp, i.e. `cat /dev/ttyACM0 > capture.bin`, then run
+`python3 fra.py capture.bin -o results/`.
+"""
+
+import argparse
+import struct
+import sys
+
+import matplotlib.pyplot as plt
+import numpy as np
+
+FRA_MAGIC = 0x31415246
+HEADER = struct.Struct("<IBBHf")
+POINT = struct.Struct("<fff")
+MODES = {0: "plant", 1: "loop", 2: "reference"}
+
+
+def fletcher16(data):
+    sum1 = 0
+    sum2 = 0
+    for byte in data:
+        sum1 = (sum1 + byte) % 255
+        sum2 = (sum2 + sum1) % 255
+    return (sum2 << 8) | sum1
+
+
+def parse_tables(data):
+    """_summary_
+    Finds every valid FRA table in a serial capture. The capture may contain
+    CSV telemetry interleaved with the binary tables.
+
+    Args:
+        data (bytes): Raw serial capture.
+
+    Returns:
+        [dict]: Tables with keys mode, sample_rate, measure_cycles, f, gain
+        (dB) and phase (deg).
+    """
+    tables = []
+    magic = struct.pack("<I", FRA_MAGIC)
+    idx = data.find(magic)
+    while idx != -1:
+        if idx + HEADER.size > len(data):
+            break
+        _, mode, num_points, cycles, sample_rate = HEADER.unpack_from(data, idx)
+        length = HEADER.size + num_points * POINT.size + 2
+        record = data[idx : idx + length]
+        if len(record) == length:
+            (checksum,) = struct.unpack_from("<H", record, length - 2)
+            if checksum == fletcher16(record[:-2]):
+                points = np.array(
+                    [
+                        POINT.unpack_from(record, HEADER.size + i * POINT.size)
+                        for i in range(num_points)
+                    ]
+                )
+                tables.append(
+                    {
+                        "mode": MODES.get(mode, "unknown"),
+                        "sample_rate": sample_rate,
+                        "measure_cycles": cycles,
+                        "f": points[:, 0],
+                        "gain": points[:, 1],
+                        "phase": points[:, 2],
+                    }
+                )
+                idx = data.find(magic, idx + length)
+                continue
+        idx = data.find(magic, idx + 1)
+    return tables
+
+
+def loop_gain(table):
+    """_summary_
+    Converts a measured table into the loop gain T(f).
+
+    Args:
+        table (dict): Table from parse_tables.
+
+    Returns:
+        np.ndarray: Complex loop gain per point, or None for a plant sweep.
+    """
+    h = 10 ** (table["gain"] / 20) * np.exp(1j * np.radians(table["phase"]))
+    match table["mode"]:
+        case "loop":
+            # Broken at the duty command: y = -T x.
+            return -h
+        case "reference":
+            # Unity feedback closed loop: H = T / (1 + T).
+            return h / (1 - h)
+        case _:
+            return None
+
+
+def margins(f, t):
+    """_summary_
+    Fits the crossover frequency, phase margin and gain margin of a loop gain
+    by interpolating between measured points in log frequency.
+
+    Args:
+        f (np.ndarray): Frequencies (Hz).
+        t (np.ndarray): Complex loop gain at each frequency.
+
+    Returns:
+        dict: f_c (Hz), phase_margin (deg), f_180 (Hz), gain_margin (dB). Any
+        value that is not bracketed by the sweep is None.
+    """
+    gain = 20 * np.log10(np.abs(t))
+    phase = np.degrees(np.unwrap(np.angle(t)))
+    log_f = np.log10(f)
+    result = {"f_c": None, "phase_margin": None, "f_180": None, "gain_margin": None}
+
+    for i in range(len(f) - 1):
+        if gain[i] >= 0 and gain[i + 1] < 0:
+            frac = gain[i] / (gain[i] - gain[i + 1])
+            result["f_c"] = 10 ** (log_f[i] + frac * (log_f[i + 1] - log_f[i]))
+            phase_c = phase[i] + frac * (phase[i + 1] - phase[i])
+            result["phase_margin"] = (phase_c + 180) % 360
+            if result["phase_margin"] > 180:
+                result["phase_margin"] -= 360
+            break
+
+    # Phase crossover, where the unwrapped phase first falls through -180 deg.
+    for i in range(len(f) - 1):
+        if phase[i] > -180 and phase[i + 1] <= -180:
+            frac = (phase[i] + 180) / (phase[i] - phase[i + 1])
+            result["f_180"] = 10 ** (log_f[i] + frac * (log_f[i + 1] - log_f[i]))
+            gain_180 = gain[i] + frac * (gain[i + 1] - gain[i])
+            result["gain_margin"] = -gain_180
+            break
+
+    return result
+
+
+def plot(table, t, result, output_path, idx):
+    fig, (ax1, ax2) = plt.subplots(2, 1, sharex=True)
+    fig.suptitle(f"FRA Sweep {idx} ({table['mode']})")
+    ax1.semilogx(table["f"], table["gain"], "o-", label="measured")
+    ax2.semilogx(table["f"], table["phase"], "o-", label="measured")
+    if t is not None:
+        ax1.semilogx(table["f"], 20 * np.log10(np.abs(t)), "x--", label="loop gain")
+        ax2.semilogx(
+            table["f"], np.degrees(np.unwrap(np.angle(t))), "x--", label="loop gain"
+        )
+    if result is not None and result["f_c"] is not None:
+        ax1.axvline(result["f_c"], color="r", linestyle=":")
+        ax2.axvline(result["f_c"], color="r", linestyle=":")
+    ax1.set_ylabel("Gain (dB)")
+    ax1.grid(True, "both", "both")
+    ax1.legend()
+    ax2.set_xlabel("Frequency (Hz)")
+    ax2.set_ylabel("Phase (deg)")
+    ax2.grid(True, "both", "both")
+    plt.tight_layout()
+    plt.savefig(f"{output_path}/fra_{idx:02d}_{table['mode']}.png")
+    plt.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode FRA tables and fit crossover frequency and phase margin."
+    )
+    parser.add_argument("capture", help="Raw serial capture containing FRA tables.")
+    parser.add_argument("-o", "--output", default=None, help="Directory for plots.")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as fp:
+        tables = parse_tables(fp.read())
+
+    if len(tables) == 0:
+        print("No valid FRA tables found.")
+        sys.exit(1)
+
+    for idx, table in enumerate(tables):
+        print(
+            f"Sweep {idx}: {table['mode']}, {len(table['f'])} points, "
+            f"fs = {table['sample_rate']:.0f} Hz, {table['measure_cycles']} cycles/point"
+        )
+        for f, g, p in zip(table["f"], table["gain"], table["phase"]):
+            print(f"    {f:10.2f} Hz {g:8.2f} dB {p:8.2f} deg")
+
+        t = loop_gain(table)
+        result = None
+        if t is not None:
+            result = margins(table["f"], t)
+            fmt = lambda v, unit: "n/a" if v is None else f"{v:.2f} {unit}"
+            print(f"    Crossover:    {fmt(result['f_c'], 'Hz')}")
+            print(f"    Phase margin: {fmt(result['phase_margin'], 'deg')}")
+            print(f"    Gain margin:  {fmt(result['gain_margin'], 'dB')}")
+
+        if args.output is not None:
+            plot(table, t, result, args.output, idx)
+
+
+if __name__ == "__main__":
+    main()
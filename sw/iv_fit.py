@@ -0,0 +1,361 @@
+"""_summary_
+@file       iv_fit.py
+@author     Matthew Yu (matthewjkyu@gmail.com)
+@brief      Fit the single diode parameters of the array to traced I-V curves,
+            with confidence intervals, for the design specs and the firmware
+            model predictor.
+
+@version    0.1.0
+@date       2023-09-07
+
+Usage:
+`python3 iv_fit.py capture.bin results/iv_00.csv -s design_files/design_specs.json -o fit.json`
+
+Curves are read from the binary captures of iv_tracer.py, or from the CSVs it
+writes (any CSV with "v (V)" and "i (A)" columns, otherwise the first two).
+Every curve is fitted to the single diode model of the num_cells series cells
+of the array, as in design_procedures/solar_cell_nonideal_model.py:
+
+    I = I_ph - I_0 (exp((V + I R_s) / a) - 1) - (V + I R_s) / R_sh,    a = n N V_t
+
+with Levenberg-Marquardt on the current residuals. The model current at each
+measured voltage is solved in closed form with the Lambert W function, and the
+Jacobian follows analytically from the implicit function theorem:
+
+    dI/dp = (df/dp) / D,    D = I_0 exp(u) R_s / a + R_s / R_sh + 1
+
+with f the right hand side minus I and u = (V + I R_s) / a. I_0, R_s and R_sh
+are fitted in log space, so that they stay positive and their steps scale
+with their magnitudes. The 95 % confidence intervals come from the covariance
+s^2 (J^T J)^-1 at the optimum, with a Student t quantile; in log space they
+are asymmetric. I_0 and n are strongly correlated, so their intervals are
+wide even when the curve is fitted well; R_s comes from the slope near V_oc,
+and R_sh from the slope near I_sc, which a trace that starts at the current
+limit (see fw/inc/iv_tracer) only partially covers.
+
+Curves are fitted in parallel across cores. I_ph and I_0 depend on the
+irradiance and the temperature of each curve, so only R_s, R_sh and n, which
+do not, are pooled across curves, by inverse variance weighting, into the
+input_source fields of design_specs.json. `--update` writes r_s and r_sh back
+into the design specs; ARR_R_S and ARR_R_SH in fw/src/main.cpp should then be
+set to the same values for the model predictor.
+"""
+
+import argparse
+import concurrent.futures
+import json
+import logging
+import os
+import re
+import sys
+
+import iv_tracer
+import numpy as np
+from scipy import constants, special, stats
+
+NAMES = ["i_ph", "i_0", "n", "r_s", "r_sh"]
+LOG = [False, True, False, True, True]  # Parameters fitted in log space.
+
+# Bounds on n, R_s and R_sh per cell, and the largest step of the fitted
+# vector per iteration. Without them, a parameter the curve barely constrains,
+# like R_sh on a noisy trace, can take a step that overflows the model.
+BOUNDS = {"n": (0.5, 3.0), "r_s": (1e-5, 0.1), "r_sh": (0.1, 1e4)}
+STEP_MAX = np.array([0.1, 0.5, 0.2, 0.5, 0.5])  # I_ph as a fraction.
+
+
+def lambertw_exp(y):
+    """_summary_
+    W(exp(y)), without overflowing exp(y) for large y.
+    """
+    w = np.empty_like(y)
+    small = y < 500.0
+    w[small] = special.lambertw(np.exp(y[small])).real
+    big = ~small
+    if np.any(big):
+        w_big = y[big] - np.log(y[big])
+        for _ in range(4):
+            w_big = w_big - (w_big + np.log(w_big) - y[big]) / (1.0 + 1.0 / w_big)
+        w[big] = w_big
+    return w
+
+
+def unpack(p, cells, v_t):
+    """_summary_
+    Array parameters from the fitted vector [I_ph, ln I_0, n, ln R_s, ln R_sh].
+    """
+    i_ph, i_0, n, r_s, r_sh = [np.exp(x) if log else x for x, log in zip(p, LOG)]
+    return i_ph, i_0, n, r_s, r_sh, n * cells * v_t
+
+
+def model_current(p, v, cells, v_t):
+    """_summary_
+    Array current at voltages v, and its Jacobian against the fitted vector.
+    """
+    i_ph, i_0, n, r_s, r_sh, a = unpack(p, cells, v_t)
+    g = r_s + r_sh
+    y = np.log(r_s * r_sh * i_0 / (a * g)) + r_sh * (r_s * (i_ph + i_0) + v) / (a * g)
+    i = (r_sh * (i_ph + i_0) - v) / g - a / r_s * lambertw_exp(y)
+
+    u = (v + i * r_s) / a
+    e = np.exp(np.minimum(np.log(i_0) + u, 700.0))  # I_0 exp(u)
+    d = e * r_s / a + r_s / r_sh + 1.0
+    jac = np.column_stack(
+        [
+            np.ones_like(v),  # I_ph
+            i_0 - e,  # ln I_0, i.e. I_0 df/dI_0
+            e * u / n,  # n
+            -(e * i / a + i / r_sh) * r_s,  # ln R_s
+            (v + i * r_s) / r_sh,  # ln R_sh, i.e. R_sh df/dR_sh
+        ]
+    ) / d[:, None]
+    return i, jac
+
+
+def initial_guess(v, i, voc, cells, v_t):
+    """_summary_
+    Seeds the fit from the slopes at either end of the curve and from V_oc.
+    """
+    order = np.argsort(v)
+    v, i = v[order], i[order]
+    k = max(len(v) // 10, 2)
+    slope_sc = np.polyfit(v[:k], i[:k], 1)[0]
+    k = max(len(v) // 50, 2)
+    slope_oc = np.polyfit(v[-k:], i[-k:], 1)[0]
+    r_sh = 1.0 / max(-slope_sc, 1e-5)
+    n = 1.0
+    a = n * cells * v_t
+    i_ph = i[0] + v[0] / r_sh
+    # Near V_oc, -dV/dI = R_s + a / (I_ph - I).
+    r_s = max(-1.0 / min(slope_oc, -1e-6) - a / max(i_ph - i[-1], 1e-3), 1e-3)
+    i_0 = max(i_ph - voc / r_sh, 1e-3) / np.expm1(voc / a)
+    return clip(np.array([i_ph, np.log(i_0), n, np.log(r_s), np.log(r_sh)]), cells)
+
+
+def clip(p, cells):
+    """_summary_
+    Clips the fitted vector to BOUNDS.
+    """
+    p = p.copy()
+    p[2] = np.clip(p[2], *BOUNDS["n"])
+    p[3] = np.clip(p[3], *np.log(np.multiply(BOUNDS["r_s"], cells)))
+    p[4] = np.clip(p[4], *np.log(np.multiply(BOUNDS["r_sh"], cells)))
+    return p
+
+
+def levenberg_marquardt(v, i, p, cells, v_t, iterations=200, tol=1e-10):
+    """_summary_
+    Minimizes the sum of squared current residuals, with Marquardt's scaling of
+    the damping by the diagonal of J^T J.
+
+    Returns:
+        (np.ndarray, np.ndarray, np.ndarray, int): Fitted vector, residuals,
+        Jacobian at the optimum and the iterations taken.
+    """
+    lam = 1e-3
+    model, jac = model_current(p, v, cells, v_t)
+    r = model - i
+    cost = r @ r
+    for it in range(iterations):
+        jtj = jac.T @ jac
+        grad = jac.T @ r
+        step_max = STEP_MAX * [abs(p[0]), 1.0, 1.0, 1.0, 1.0]
+        while True:
+            lam *= 10.0
+            if lam > 1e12:
+                return p, r, jac, it
+            try:
+                step = np.linalg.solve(jtj + lam / 10.0 * np.diag(np.diag(jtj)), -grad)
+            except np.linalg.LinAlgError:
+                continue
+            candidate = clip(p + np.clip(step, -step_max, step_max), cells)
+            model_c, jac_c = model_current(candidate, v, cells, v_t)
+            r_c = model_c - i
+            cost_c = r_c @ r_c
+            if np.isfinite(cost_c) and cost_c < cost:
+                lam = max(lam / 100.0, 1e-12)
+                break
+        done = cost - cost_c <= tol * cost
+        p, r, jac, cost = candidate, r_c, jac_c, cost_c
+        if done:
+            break
+    return p, r, jac, it + 1
+
+
+def fit_curve(job):
+    """_summary_
+    Fits one curve. Runs in a worker process.
+
+    Returns:
+        dict: Per cell fitted parameters, their 95 % confidence intervals and
+        standard errors in the fitted space, and the fit quality.
+    """
+    name, v, i, voc, cells, v_t = job
+    if voc is not None:
+        v = np.append(v, voc)
+        i = np.append(i, 0.0)
+
+    p0 = initial_guess(v, i, voc if voc is not None else v.max(), cells, v_t)
+    p, r, jac, iterations = levenberg_marquardt(v, i, p0, cells, v_t)
+
+    dof = max(len(v) - len(p), 1)
+    s2 = r @ r / dof
+    try:
+        cov = s2 * np.linalg.inv(jac.T @ jac)
+        se = np.sqrt(np.maximum(np.diag(cov), 0.0))
+    except np.linalg.LinAlgError:
+        se = np.full(len(p), np.inf)
+    t = stats.t.ppf(0.975, dof)
+
+    # Series resistances scale with the cell count; currents do not.
+    scale = [1.0, 1.0, 1.0, 1.0 / cells, 1.0 / cells]
+    values, intervals = {}, {}
+    for k, key in enumerate(NAMES):
+        lo, mid, hi = p[k] - t * se[k], p[k], p[k] + t * se[k]
+        if LOG[k]:
+            with np.errstate(over="ignore"):
+                lo, mid, hi = np.exp(lo), np.exp(mid), np.exp(hi)
+        values[key] = float(mid * scale[k])
+        # A parameter the curve does not constrain has no interval.
+        intervals[key] = [
+            float(x * scale[k]) if np.isfinite(x) else None for x in (lo, hi)
+        ]
+
+    return {
+        "source": name,
+        "points": len(v),
+        "iterations": iterations,
+        "rmse (A)": float(np.sqrt(r @ r / len(v))),
+        **values,
+        "confidence (95%)": intervals,
+        "_p": p.tolist(),
+        "_se": se.tolist(),
+    }
+
+
+def pool(fits):
+    """_summary_
+    Inverse variance weighted mean of R_s, R_sh and n over the curves, in the
+    space they were fitted in.
+    """
+    result, intervals = {}, {}
+    for k, key in enumerate(NAMES):
+        if key in ("i_ph", "i_0"):
+            continue
+        p = np.array([f["_p"][k] for f in fits])
+        se = np.array([f["_se"][k] for f in fits])
+        ok = np.isfinite(se) & (se > 0)
+        if not np.any(ok):
+            continue
+        w = 1.0 / se[ok] ** 2
+        mid = np.sum(w * p[ok]) / np.sum(w)
+        half = 1.96 / np.sqrt(np.sum(w))
+        lo, hi = mid - half, mid + half
+        if LOG[k]:
+            lo, mid, hi = np.exp(lo), np.exp(mid), np.exp(hi)
+        scale = 1.0 if key == "n" else 1.0 / fits[0]["_cells"]
+        result[key] = float(mid * scale)
+        intervals[key] = [float(lo * scale), float(hi * scale)]
+    result["confidence (95%)"] = intervals
+    return result
+
+
+def load_curves(paths, capacitance):
+    """_summary_
+    Reads every curve of the binary captures and CSVs.
+
+    Returns:
+        [(str, np.ndarray, np.ndarray, float)]: Name, voltage (V), current (A)
+        and V_oc (V, None if unknown) of every curve.
+    """
+    curves = []
+    for path in paths:
+        if path.lower().endswith(".csv"):
+            with open(path) as fp:
+                header = [h.strip() for h in fp.readline().split(",")]
+            data = np.loadtxt(path, delimiter=",", skiprows=1, ndmin=2)
+            cv = header.index("v (V)") if "v (V)" in header else 0
+            ci = header.index("i (A)") if "i (A)" in header else 1
+            curves.append((path, data[:, cv], data[:, ci], None))
+        else:
+            with open(path, "rb") as fp:
+                records = iv_tracer.parse_records(fp.read(), capacitance)
+            for idx, record in enumerate(records):
+                if record["end"] == "aborted":
+                    logging.warning(f"{path}#{idx}: aborted trace, skipped.")
+                    continue
+                curves.append((f"{path}#{idx}", record["v"], record["i"], record["voc"]))
+    return curves
+
+
+if __name__ == "__main__":
+    if sys.version_info[0] < 3:
+        raise Exception("This program only supports Python 3.")
+
+    parser = argparse.ArgumentParser(
+        description="Fit single diode parameters to traced I-V curves."
+    )
+    parser.add_argument("curves", nargs="+", help="Binary captures or CSVs of iv_tracer.py.")
+    parser.add_argument("-s", "--specs", default="design_files/design_specs.json")
+    parser.add_argument("-o", "--output", default=None, help="Output JSON of the fits.")
+    parser.add_argument("-t", "--temperature", type=float, default=25.0, help="Cell, C.")
+    parser.add_argument(
+        "-c", "--capacitance", type=float, default=15e-6, help="Input capacitance (F)."
+    )
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count())
+    parser.add_argument(
+        "--update", action="store_true", help="Write r_s and r_sh back into the design specs."
+    )
+    args = parser.parse_args()
+
+    logging.basicConfig(format="%(message)s", level=logging.INFO)
+
+    with open(args.specs) as fp:
+        specs = json.load(fp)
+    source = specs["DESIGN"]["input_source"]
+    cells = source["num_cells"]
+    v_t = constants.k * (args.temperature + 273.15) / constants.e
+
+    curves = load_curves(args.curves, args.capacitance)
+    if len(curves) == 0:
+        logging.error("No curves to fit.")
+        sys.exit(1)
+
+    jobs = [(name, v, i, voc, cells, v_t) for name, v, i, voc in curves]
+    with concurrent.futures.ProcessPoolExecutor(max_workers=args.jobs) as executor:
+        fits = list(executor.map(fit_curve, jobs))
+
+    for fit in fits:
+        fit["_cells"] = cells
+        ci = fit["confidence (95%)"]
+        logging.info(
+            f"{fit['source']}: {fit['points']} points, {fit['iterations']} iterations, "
+            f"rmse {fit['rmse (A)'] * 1e3:.2f} mA"
+        )
+        for key in NAMES:
+            lo, hi = ["-" if x is None else f"{x:.4g}" for x in ci[key]]
+            logging.info(f"    {key:5s} {fit[key]:.4g} [{lo}, {hi}]")
+
+    pooled = pool(fits)
+    logging.info(f"Pooled over {len(fits)} curves, per cell:")
+    for key, (lo, hi) in pooled["confidence (95%)"].items():
+        logging.info(f"    {key:5s} {pooled[key]:.4g} [{lo:.4g}, {hi:.4g}]")
+
+    for fit in fits:
+        for key in ("_p", "_se", "_cells"):
+            del fit[key]
+
+    if args.output is not None:
+        with open(args.output, "w") as fp:
+            json.dump({"input_source": pooled, "curves": fits}, fp, indent=4)
+
+    if args.update and "r_s" in pooled and "r_sh" in pooled:
+        # Only the two values are replaced, to keep the layout of the file.
+        r_s = f"{pooled['r_s']:.4g}"
+        r_sh = f"{pooled['r_sh']:.4g}"
+        with open(args.specs) as fp:
+            text = fp.read()
+        text = re.sub(r'("r_s":\s*)[^,\n]+', rf"\g<1>{r_s}", text, count=1)
+        text = re.sub(r'("r_sh":\s*)[^,\n]+', rf"\g<1>{r_sh}", text, count=1)
+        with open(args.specs, "w") as fp:
+            fp.write(text)
+        logging.info(f"Updated {args.specs}. Set ARR_R_S {r_s} and ARR_R_SH {r_sh} in fw/src/main.cpp.")
@@ -0,0 +1,202 @@
+"""_summary_
+@file       iv_tracer.py
+@author     Matthew Yu (matthewjkyu@gmail.com)
+@brief      Decode I-V curve records streamed by the firmware tracer, and
+            report the short circuit current, open circuit voltage, maximum
+            power point and fill factor of each trace.
+
+@version    0.1.0
+@date       2023-09-06
+
+Usage: capture the serial port of the Sunscatter with __TRACE__ enabled in
+fw/src/main.cpp, i.e. `cat /dev/ttyACM0 > capture.bin`, sending 't' for every
+further trace, then run `python3 iv_tracer.py capture.bin -o results/`.
+"""
+
+import argparse
+import struct
+import sys
+
+import matplotlib.pyplot as plt
+import numpy as np
+
+IV_TRACER_MAGIC = 0x31545649
+HEADER = struct.Struct("<IHBBffffff")
+POINT = struct.Struct("<HH")
+ENDS = {0: "current", 1: "points", 2: "aborted"}
+
+
+def fletcher16(data):
+    sum1 = 0
+    sum2 = 0
+    for byte in data:
+        sum1 = (sum1 + byte) % 255
+        sum2 = (sum2 + sum1) % 255
+    return (sum2 << 8) | sum1
+
+
+def parse_records(data, capacitance):
+    """_summary_
+    Finds every valid I-V record in a serial capture. The capture may contain
+    CSV telemetry interleaved with the binary records.
+
+    Args:
+        data (bytes): Raw serial capture.
+        capacitance (float): Input capacitance (F). The sensed inductor current
+            is corrected by C dv/dt to the array current.
+
+    Returns:
+        [dict]: Records with keys end, sample_rate, duty (per point), t (s),
+        v (V), i (A), and voc (V, None if the trace was aborted). The open
+        circuit point is not included in v and i.
+    """
+    records = []
+    magic = struct.pack("<I", IV_TRACER_MAGIC)
+    idx = data.find(magic)
+    while idx != -1:
+        if idx + HEADER.size > len(data):
+            break
+        (_, count, end, _, sample_rate, v_scale, i_scale, duty_first, duty_step, voc) = (
+            HEADER.unpack_from(data, idx)
+        )
+        length = HEADER.size + count * POINT.size + 2
+        record = data[idx : idx + length]
+        if len(record) == length and count > 0:
+            (checksum,) = struct.unpack_from("<H", record, length - 2)
+            if checksum == fletcher16(record[:-2]):
+                points = np.array(
+                    [
+                        POINT.unpack_from(record, HEADER.size + k * POINT.size)
+                        for k in range(count)
+                    ],
+                    dtype=float,
+                )
+                t = np.arange(count) / sample_rate
+                v = points[:, 0] / 65535 * v_scale
+                i = points[:, 1] / 65535 * i_scale
+                if count > 2:
+                    i = i + capacitance * np.gradient(v, t)
+                records.append(
+                    {
+                        "end": ENDS.get(end, "unknown"),
+                        "sample_rate": sample_rate,
+                        "duty": duty_first - duty_step * np.arange(count),
+                        "t": t,
+                        "v": v,
+                        "i": i,
+                        "voc": voc if end != 2 else None,
+                    }
+                )
+                idx = data.find(magic, idx + length)
+                continue
+        idx = data.find(magic, idx + 1)
+    return records
+
+
+def characterize(record):
+    """_summary_
+    Extracts the parameters of the traced curve. The short circuit current is
+    extrapolated to 0 V from the points below half of the open circuit
+    voltage, where the curve is nearly flat.
+
+    Args:
+        record (dict): Record from parse_records.
+
+    Returns:
+        dict: i_sc (A), v_oc (V), v_mpp (V), i_mpp (A), p_mpp (W) and
+        fill_factor. Any value the trace does not cover is None.
+    """
+    v = record["v"]
+    i = record["i"]
+    v_oc = record["voc"]
+    result = {"i_sc": None, "v_oc": v_oc, "v_mpp": None, "i_mpp": None, "p_mpp": None}
+
+    p = v * i
+    k = int(np.argmax(p))
+    result.update({"v_mpp": v[k], "i_mpp": i[k], "p_mpp": p[k]})
+
+    if v_oc is not None:
+        flat = v < 0.5 * v_oc
+        if np.count_nonzero(flat) >= 2:
+            _, intercept = np.polyfit(v[flat], i[flat], 1)
+            result["i_sc"] = intercept
+
+    result["fill_factor"] = (
+        result["p_mpp"] / (result["i_sc"] * v_oc)
+        if result["i_sc"] is not None and v_oc is not None
+        else None
+    )
+    return result
+
+
+def plot(record, result, output_path, idx):
+    v = record["v"]
+    i = record["i"]
+    if record["voc"] is not None:
+        v = np.append(v, record["voc"])
+        i = np.append(i, 0.0)
+
+    fig, ax1 = plt.subplots()
+    fig.suptitle(f"I-V Trace {idx} ({len(record['v'])} points, {record['end']})")
+    ax1.plot(v, i, ".-", color="tab:blue", label="I")
+    ax1.set_xlabel("Array Voltage (V)")
+    ax1.set_ylabel("Array Current (A)")
+    ax1.grid(True)
+    ax2 = ax1.twinx()
+    ax2.plot(v, v * i, color="tab:orange", label="P")
+    ax2.set_ylabel("Array Power (W)")
+    if result["v_mpp"] is not None:
+        ax2.plot(result["v_mpp"], result["p_mpp"], "x", color="r")
+    plt.tight_layout()
+    plt.savefig(f"{output_path}/iv_{idx:02d}.png")
+    plt.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode I-V curve records and extract the curve parameters."
+    )
+    parser.add_argument("capture", help="Raw serial capture containing I-V records.")
+    parser.add_argument("-o", "--output", default=None, help="Directory for plots and CSVs.")
+    parser.add_argument(
+        "-c",
+        "--capacitance",
+        type=float,
+        default=15e-6,
+        help="Input capacitance (F), see docs/DESIGN.md.",
+    )
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as fp:
+        records = parse_records(fp.read(), args.capacitance)
+
+    if len(records) == 0:
+        print("No valid I-V records found.")
+        sys.exit(1)
+
+    fmt = lambda v, unit: "n/a" if v is None else f"{v:.3f} {unit}"
+    for idx, record in enumerate(records):
+        result = characterize(record)
+        print(
+            f"Trace {idx}: {len(record['v'])} points in "
+            f"{record['t'][-1] * 1e3:.1f} ms, ended on {record['end']}"
+        )
+        print(f"    I_sc:        {fmt(result['i_sc'], 'A')}")
+        print(f"    V_oc:        {fmt(result['v_oc'], 'V')}")
+        print(f"    MPP:         {fmt(result['v_mpp'], 'V')}, {fmt(result['i_mpp'], 'A')}")
+        print(f"    P_mpp:       {fmt(result['p_mpp'], 'W')}")
+        print(f"    Fill factor: {fmt(result['fill_factor'], '')}")
+
+        if args.output is not None:
+            plot(record, result, args.output, idx)
+            np.savetxt(
+                f"{args.output}/iv_{idx:02d}.csv",
+                np.column_stack((record["t"], record["duty"], record["v"], record["i"])),
+                delimiter=",",
+                header="t (s),duty,v (V),i (A)",
+                comments="",
+            )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,208 @@
+"""_summary_
+@file       mpc_design.py
+@author     Matthew Yu (matthewjkyu@gmail.com)
+@brief      Solve the explicit MPC of the boost converter offline and compile
+            it into a region lookup table for the firmware.
+
+@version    0.1.0
+@date       2023-08-23
+
+Usage:
+`python3 mpc_design.py ../docs/v0.3.0/automated/design_parameters.json ../fw/inc/mpc/mpc_table.hpp --ci 15e-6`
+
+The design parameters size C_i for the input ripple only; the board carries
+15 uF (INPUT_CAPACITANCE in fw/src/main.cpp), so pass it with --ci.
+"""
+
+import argparse
+import json
+import logging
+import sys
+
+import design_procedures.control_design as control
+import numpy as np
+
+# Parameter box the table is valid over. The firmware clamps to it.
+THETA_MIN = [-15.0, -6.0, 0.0, 20.0, 70.0, 0.0]
+THETA_MAX = [15.0, 6.0, 7.0, 75.0, 130.0, 6.0]
+
+
+def simulate(regions, l, ci, r_l, r_ci, t_s, duty, steps=200):
+    """_summary_
+    Closed loop step of the array voltage reference on the nonlinear averaged
+    model, with a constant current array, using the host reference of the
+    firmware lookup.
+
+    Returns:
+        (np.ndarray, np.ndarray, np.ndarray): Array voltage, inductor current
+        and duty at every step.
+    """
+    v_out, i_arr, i_lim = 100.0, 5.0, 6.0
+    v, i_l, v_ref = 55.0, i_arr, 60.0
+    sub = 20
+    vs, ils, ds = [], [], []
+    for _ in range(steps):
+        theta = np.clip(
+            [v - v_ref, i_l - i_arr, i_arr, v_ref, v_out, i_lim], THETA_MIN, THETA_MAX
+        )
+        d = control.evaluate_explicit_mpc(regions, theta, duty)
+        for _ in range(sub):
+            dt = t_s / sub
+            dv = (i_arr - i_l) / ci
+            di = (v + r_ci * (i_arr - i_l) - r_l * i_l - (1 - d) * v_out) / l
+            v += dv * dt
+            i_l = max(i_l + di * dt, 0.0)
+        vs.append(v)
+        ils.append(i_l)
+        ds.append(d)
+    return np.array(vs), np.array(ils), np.array(ds)
+
+
+def _literal(v):
+    s = f"{v:.9g}"
+    if "." not in s and "e" not in s and "n" not in s:
+        s += ".0"
+    return s + "f"
+
+
+def emit_header(regions, path, args, l, ci):
+    n_theta = len(control.THETA_NAMES)
+    offsets = [0]
+    for region in regions:
+        offsets.append(offsets[-1] + len(region["k"]))
+
+    fmt = _literal
+    lines = []
+    lines.append("/**")
+    lines.append(" * @file mpc_table.hpp")
+    lines.append(" * @author Generated by sw/mpc_design.py. Do not edit by hand.")
+    lines.append(" * @brief Explicit MPC region lookup table.")
+    lines.append(f" * @note Source: {args.design_parameters_path}")
+    lines.append(
+        f" *       L = {l * 1e6:.1f} uH, C_i = {ci * 1e6:.2f} uF, "
+        f"DCR = {args.dcr} Ohm, ESR = {args.esr} Ohm,"
+    )
+    lines.append(
+        f" *       f_ctrl = {args.f_ctrl} Hz, N = {args.horizon}, "
+        f"q = [{args.q_v}, {args.q_i}], r = {args.r}."
+    )
+    overrides = [
+        f"--{name} {value}" for name, value in (("l", args.l), ("ci", args.ci)) if value is not None
+    ]
+    if overrides:
+        lines.append(f" *       Overrides: {', '.join(overrides)}.")
+    lines.append(" */")
+    lines.append("#pragma once")
+    lines.append("")
+    lines.append("/** General imports. */")
+    lines.append("#include <stdint.h>")
+    lines.append("")
+    lines.append("")
+    lines.append(f"#define MPC_NUM_PARAMETERS {n_theta}")
+    lines.append(f"#define MPC_NUM_REGIONS {len(regions)}")
+    lines.append(f"#define MPC_NUM_FACETS {offsets[-1]}")
+    lines.append(f"#define MPC_SAMPLE_RATE {args.f_ctrl}")
+    lines.append(f"#define MPC_DUTY_MIN {fmt(args.duty[0])}")
+    lines.append(f"#define MPC_DUTY_MAX {fmt(args.duty[1])}")
+    lines.append("")
+    lines.append(
+        "/** Parameter order: " + ", ".join(control.THETA_NAMES) + ". */"
+    )
+    lines.append("static const float MPC_THETA_MIN[MPC_NUM_PARAMETERS] = {")
+    lines.append("    " + ", ".join(fmt(v) for v in THETA_MIN))
+    lines.append("};")
+    lines.append("static const float MPC_THETA_MAX[MPC_NUM_PARAMETERS] = {")
+    lines.append("    " + ", ".join(fmt(v) for v in THETA_MAX))
+    lines.append("};")
+    lines.append("")
+    lines.append("/** Facets of region r are rows MPC_OFFSETS[r] to MPC_OFFSETS[r + 1]. */")
+    lines.append("static const uint16_t MPC_OFFSETS[MPC_NUM_REGIONS + 1] = {")
+    lines.append("    " + ", ".join(str(v) for v in offsets))
+    lines.append("};")
+    lines.append("")
+    lines.append("/** Region r contains theta if MPC_H[i] theta <= MPC_K[i] for its facets. */")
+    lines.append("static const float MPC_H[MPC_NUM_FACETS][MPC_NUM_PARAMETERS] = {")
+    for region in regions:
+        for row in region["h"]:
+            lines.append("    { " + ", ".join(fmt(v) for v in row) + " },")
+    lines.append("};")
+    lines.append("static const float MPC_K[MPC_NUM_FACETS] = {")
+    for region in regions:
+        for v in region["k"]:
+            lines.append(f"    {fmt(v)},")
+    lines.append("};")
+    lines.append("")
+    lines.append("/** Switch node voltage law of region r: v_sw = MPC_F[r] theta + MPC_G[r]. */")
+    lines.append("static const float MPC_F[MPC_NUM_REGIONS][MPC_NUM_PARAMETERS] = {")
+    for region in regions:
+        lines.append("    { " + ", ".join(fmt(v) for v in region["f"]) + " },")
+    lines.append("};")
+    lines.append("static const float MPC_G[MPC_NUM_REGIONS] = {")
+    for region in regions:
+        lines.append(f"    {fmt(region['g'])},")
+    lines.append("};")
+    lines.append("")
+
+    with open(path, "w") as fp:
+        fp.write("\n".join(lines))
+
+
+if __name__ == "__main__":
+    if sys.version_info[0] < 3:
+        raise Exception("This program only supports Python 3.")
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("design_parameters_path")
+    parser.add_argument("output_path", help="Generated header, i.e. fw/inc/mpc/mpc_table.hpp.")
+    parser.add_argument("--l", type=float, default=None, help="Inductance override (H).")
+    parser.add_argument("--ci", type=float, default=None, help="Input capacitance override (F).")
+    parser.add_argument("--dcr", type=float, default=0.1, help="Inductor DCR (Ohms).")
+    parser.add_argument("--esr", type=float, default=0.01, help="Input capacitor ESR (Ohms).")
+    parser.add_argument("--f_ctrl", type=float, default=10400.0, help="Control rate (Hz).")
+    parser.add_argument("--horizon", type=int, default=3)
+    parser.add_argument("--q_v", type=float, default=0.1)
+    parser.add_argument("--q_i", type=float, default=1.0)
+    parser.add_argument("--r", type=float, default=1e-2)
+    parser.add_argument("--duty", type=float, nargs=2, default=[0.10, 0.90])
+    parser.add_argument("-s", "--simulate", action="store_true")
+    args = parser.parse_args()
+
+    logging.basicConfig(format="%(message)s", level=logging.INFO)
+
+    with open(args.design_parameters_path) as fp:
+        design = json.load(fp)["DESIGN"]
+
+    l, ci = control.get_passives(design)
+    l = args.l if args.l is not None else l
+    ci = args.ci if args.ci is not None else ci
+    t_s = 1.0 / args.f_ctrl
+    logging.info(f"L = {l * 1e6:.1f} uH, C_i = {ci * 1e6:.2f} uF, T_s = {t_s * 1e6:.1f} us")
+
+    a, b = control.get_model(l, ci, args.dcr, args.esr, t_s)
+    q = np.diag([args.q_v, args.q_i])
+    regions = control.solve_explicit_mpc(
+        a, b, q, args.r, args.horizon, args.dcr, args.duty, THETA_MIN, THETA_MAX
+    )
+    logging.info(
+        f"{len(regions)} regions, {sum(len(region['k']) for region in regions)} facets."
+    )
+    emit_header(regions, args.output_path, args, l, ci)
+
+    if args.simulate:
+        import matplotlib.pyplot as plt
+
+        v, i_l, d = simulate(regions, l, ci, args.dcr, args.esr, t_s, args.duty)
+        t = np.arange(len(v)) * t_s * 1e3
+        fig, (ax1, ax2, ax3) = plt.subplots(3, 1, sharex=True)
+        fig.suptitle("Explicit MPC Reference Step")
+        ax1.plot(t, v)
+        ax1.set_ylabel("Array Voltage (V)")
+        ax2.plot(t, i_l)
+        ax2.set_ylabel("Inductor Current (A)")
+        ax3.plot(t, d)
+        ax3.set_ylabel("Duty")
+        ax3.set_xlabel("Time (ms)")
+        for ax in (ax1, ax2, ax3):
+            ax.grid(True, "both", "both")
+        plt.tight_layout()
+        plt.show()
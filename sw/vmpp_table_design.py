@@ -0,0 +1,350 @@
+"""_summary_
+@file       vmpp_table_design.py
+@author     Matthew Yu (matthewjkyu@gmail.com)
+@brief      Train the MPP voltage lookup table of the firmware model predictor
+            on simulated array I-V curves, and compile it into a header.
+
+@version    0.1.0
+@date       2023-08-31
+
+Usage:
+`python3 vmpp_table_design.py design_files/design_specs.json ../fw/inc/mppt/vmpp_table.hpp`
+
+The single diode solve in fw/inc/mppt/model_predictor.cpp needs a handful of
+expf and logf per prediction, and assumes a uniformly lit array at a known
+temperature. This script instead samples array conditions (irradiance, cell
+temperature, and shading of the bypass diode protected substrings), solves
+every I-V curve and its global MPP, and picks random operating points on
+each curve, where a tracker could sit when the conditions change.
+
+The open circuit voltage and short circuit current cannot be measured while
+tracking, and their estimates at a nominal temperature are closed form
+functions of the operating point and the temperature. The table is therefore
+indexed by the estimated cell temperature and the operating point (I, V)
+directly, which folds them in: a trilinear lookup of the global MPP voltage,
+fitted by least squares with a curvature penalty so that sparsely sampled
+nodes stay smooth. Without the temperature axis the fit marginalizes over the
+temperature range, and its bias then varies with the irradiance, which the
+firmware cannot learn as a single offset. The curves are split into a training
+and a test set, and the error bounds on the test set are written into the
+header, for uniform and shaded arrays separately.
+
+Only the uniform curves are fitted. From one operating point the global MPP
+of a shaded array is ambiguous, and fitting the shaded curves pulls the
+uniform predictions toward the lower maxima; the firmware leaves those to the
+global scan, and the shaded curves only give the bounds.
+"""
+
+import argparse
+import json
+import logging
+import sys
+
+import design_procedures.solar_cell_nonideal_model as cell
+import numpy as np
+from scipy import constants, sparse
+from scipy.sparse import linalg
+
+# Operating points the predictor accepts, see MP_CURRENT_FRACTION.
+CURRENT_FRACTION = 0.25
+
+
+def cell_constants(t):
+    """_summary_
+    Thermal voltage, saturation current and photo current at 1000 W/m^2 of a
+    cell at temperature t, as in solar_cell_nonideal_model.py.
+    """
+    v_t = cell.n * constants.k * t / constants.e
+    i_sc = cell.i_sc_ref * (1 - cell.t_coeff_i_sc * (cell.T_ref - t))
+    v_oc = cell.v_oc_ref * (1 - cell.t_coeff_v_oc * (cell.T_ref - t))
+    i_0 = i_sc / (np.exp(v_oc / v_t) - 1)
+    return v_t, i_0, i_sc
+
+
+def cell_voltage(i, i_ph, v_t, i_0, r_s, r_sh):
+    """_summary_
+    Cell voltage at cell current i by Newton's method, vectorized.
+    """
+    v_d = np.where(
+        i_ph > i, v_t * np.log(np.maximum(i_ph - i, 1e-12) / i_0 + 1), -(i - i_ph) * r_sh
+    )
+    for _ in range(30):
+        e = np.exp(np.minimum(v_d / v_t, 80.0))
+        f = i_ph - i_0 * (e - 1) - v_d / r_sh - i
+        df = -i_0 * e / v_t - 1 / r_sh
+        v_d = v_d - f / df
+    return v_d - i * r_s
+
+
+def simulate_curves(source, args, rng):
+    """_summary_
+    Samples array conditions and sweeps their I-V curves.
+
+    Returns:
+        dict: Curves (V, I) by current sweep, their cell temperature (K),
+        global MPP, and whether each is shaded.
+    """
+    n = args.curves
+    cells = source["num_cells"] // args.substrings
+    g = rng.uniform(args.irradiance[0], args.irradiance[1], n)
+    t = rng.uniform(args.temperature[0], args.temperature[1], n) + 273.15
+
+    # Shaded arrays dim a random subset of substrings by a random factor.
+    shaded = rng.random(n) < args.shaded
+    dim = rng.uniform(0.2, 1.0, (n, args.substrings))
+    dimmed = shaded[:, None] & (rng.random((n, args.substrings)) < 0.5)
+    factors = np.where(dimmed, dim, 1.0)
+
+    v_t, i_0, i_sc = cell_constants(t)
+    i_ph = (i_sc * (source["r_sh"] + source["r_s"]) / source["r_sh"])[:, None]
+    i_ph = i_ph * (g / cell.G_ref)[:, None] * factors
+
+    i = i_ph.max(axis=1)[:, None] * np.linspace(0.0, 1.0, args.points)[None, :]
+    v = np.zeros_like(i)
+    for k in range(args.substrings):
+        v_sub = cells * cell_voltage(
+            i, i_ph[:, k : k + 1], v_t[:, None], i_0[:, None], source["r_s"], source["r_sh"]
+        )
+        v += np.maximum(v_sub, -args.v_bypass)
+
+    p = v * i
+    best = p.argmax(axis=1)
+    rows = np.arange(n)
+    return {
+        "v": v,
+        "i": i,
+        "i_ph": i_ph.max(axis=1),
+        "t": t,
+        "vmpp": v[rows, best],
+        "pmpp": p[rows, best],
+        "shaded": shaded,
+    }
+
+
+def sample_operating_points(curves, args, rng):
+    """_summary_
+    Picks random operating points on every curve, within the table and above
+    CURRENT_FRACTION of the photo current.
+
+    Returns:
+        (np.ndarray, np.ndarray, np.ndarray): Voltage, current, and the curve
+        of every point.
+    """
+    v, i, curve = [], [], []
+    for m in range(len(curves["vmpp"])):
+        candidates = np.where(
+            (curves["v"][m] >= args.voltage[0])
+            & (curves["v"][m] <= args.voltage[1])
+            & (curves["i"][m] >= CURRENT_FRACTION * curves["i_ph"][m])
+        )[0]
+        if len(candidates) == 0:
+            continue
+        for k in rng.choice(candidates, args.samples):
+            v.append(curves["v"][m][k])
+            i.append(curves["i"][m][k])
+            curve.append(m)
+    return np.array(v), np.array(i), np.array(curve)
+
+
+def interpolation_matrix(points, axes):
+    """_summary_
+    Multilinear weights of every sample on the table nodes, row major in the
+    order of the axes, as a sparse matrix.
+    """
+    shape = [len(axis) for axis in axes]
+    rows = np.arange(len(points[0]))
+    corners = [(np.zeros(len(rows), dtype=int), np.ones(len(rows)))]
+    for x, axis, size in zip(points, axes, shape):
+        u = np.clip((x - axis[0]) / (axis[-1] - axis[0]) * (size - 1), 0, size - 1 - 1e-9)
+        k = np.floor(u).astype(int)
+        f = u - k
+        corners = [
+            (index * size + k + d, weight * w)
+            for index, weight in corners
+            for d, w in ((0, 1 - f), (1, f))
+        ]
+    index = np.concatenate([c[0] for c in corners])
+    weight = np.concatenate([c[1] for c in corners])
+    return sparse.csr_matrix(
+        (weight, (np.tile(rows, len(corners)), index)), shape=(len(rows), np.prod(shape))
+    )
+
+
+def fit_table(points, vmpp, axes, smoothing):
+    """_summary_
+    Least squares node values, with a second difference penalty along every
+    axis.
+    """
+    shape = tuple(len(axis) for axis in axes)
+    a = interpolation_matrix(points, axes)
+    nodes = np.arange(np.prod(shape)).reshape(shape)
+    penalty = []
+    for d in range(len(shape)):
+        low = np.take(nodes, range(0, shape[d] - 2), axis=d).ravel()
+        mid = np.take(nodes, range(1, shape[d] - 1), axis=d).ravel()
+        high = np.take(nodes, range(2, shape[d]), axis=d).ravel()
+        rows = np.arange(len(mid))
+        penalty.append(
+            sparse.csr_matrix(
+                (
+                    np.concatenate([np.ones(len(rows)), -2 * np.ones(len(rows)), np.ones(len(rows))]),
+                    (np.tile(rows, 3), np.concatenate([low, mid, high])),
+                ),
+                shape=(len(rows), nodes.size),
+            )
+        )
+    penalty = np.sqrt(smoothing) * sparse.vstack(penalty)
+    lhs = sparse.vstack([a, penalty]).tocsr()
+    rhs = np.concatenate([vmpp, np.zeros(penalty.shape[0])])
+    table = linalg.lsqr(lhs, rhs, atol=1e-10, btol=1e-10, iter_lim=20000)[0]
+    return table.reshape(shape)
+
+
+def error_bounds(curves, predicted, curve, select):
+    """_summary_
+    Absolute MPP voltage error percentiles, and the fraction of the MPP power
+    harvested at the predicted voltage, over the selected points.
+    """
+    rows = np.where(select)[0]
+    error = np.abs(predicted[rows] - curves["vmpp"][curve[rows]])
+    harvest = np.array(
+        [
+            predicted[k]
+            * np.interp(predicted[k], curves["v"][curve[k]][::-1], curves["i"][curve[k]][::-1])
+            / curves["pmpp"][curve[k]]
+            for k in rows
+        ]
+    )
+    return {
+        "p50": np.percentile(error, 50),
+        "p95": np.percentile(error, 95),
+        "max": error.max(),
+        "harvest": harvest.mean(),
+        "harvest_p5": np.percentile(harvest, 5),
+    }
+
+
+def _literal(v):
+    s = f"{v:.6g}"
+    if "." not in s and "e" not in s and "n" not in s:
+        s += ".0"
+    return s + "f"
+
+
+def emit_header(table, axis_t, axis_i, axis_v, bounds, path, args, source):
+    fmt = _literal
+    lines = []
+    lines.append("/**")
+    lines.append(" * @file vmpp_table.hpp")
+    lines.append(" * @author Generated by sw/vmpp_table_design.py. Do not edit by hand.")
+    lines.append(" * @brief MPP voltage lookup table of the model predictor.")
+    lines.append(f" * @note Source: {args.design_specs_path}")
+    lines.append(
+        f" *       {source['num_cells']} cells in {args.substrings} substrings, "
+        f"r_s = {source['r_s']} Ohm, r_sh = {source['r_sh']} Ohm,"
+    )
+    lines.append(
+        f" *       {args.curves} curves, {args.irradiance[0]:g} to {args.irradiance[1]:g} W/m^2, "
+        f"{args.temperature[0]:g} to {args.temperature[1]:g} C, {args.shaded:g} shaded."
+    )
+    lines.append(" */")
+    lines.append("#pragma once")
+    lines.append("")
+    lines.append("")
+    lines.append(f"#define VMPP_TABLE_TEMPERATURES {len(axis_t)}")
+    lines.append(f"#define VMPP_TABLE_CURRENTS {len(axis_i)}")
+    lines.append(f"#define VMPP_TABLE_VOLTAGES {len(axis_v)}")
+    lines.append(f"#define VMPP_TABLE_TEMPERATURE_MIN {fmt(axis_t[0])}")
+    lines.append(f"#define VMPP_TABLE_TEMPERATURE_MAX {fmt(axis_t[-1])}")
+    lines.append(f"#define VMPP_TABLE_CURRENT_MIN {fmt(axis_i[0])}")
+    lines.append(f"#define VMPP_TABLE_CURRENT_MAX {fmt(axis_i[-1])}")
+    lines.append(f"#define VMPP_TABLE_VOLTAGE_MIN {fmt(axis_v[0])}")
+    lines.append(f"#define VMPP_TABLE_VOLTAGE_MAX {fmt(axis_v[-1])}")
+    lines.append("")
+    lines.append("/** Absolute error of the predicted MPP voltage on the test curves (V). */")
+    for name, b in (("UNIFORM", bounds["uniform"]), ("SHADED", bounds["shaded"])):
+        lines.append(f"#define VMPP_TABLE_{name}_ERROR_P50 {fmt(b['p50'])}")
+        lines.append(f"#define VMPP_TABLE_{name}_ERROR_P95 {fmt(b['p95'])}")
+        lines.append(f"#define VMPP_TABLE_{name}_ERROR_MAX {fmt(b['max'])}")
+    lines.append("")
+    lines.append("/** Mean fraction of the MPP power at the predicted voltage on the test curves. */")
+    lines.append(f"#define VMPP_TABLE_UNIFORM_HARVEST {fmt(bounds['uniform']['harvest'])}")
+    lines.append(f"#define VMPP_TABLE_SHADED_HARVEST {fmt(bounds['shaded']['harvest'])}")
+    lines.append("")
+    lines.append(
+        "/** Global MPP voltage (V) at evenly spaced cell temperatures (K), array currents and voltages. */"
+    )
+    lines.append(
+        "static constexpr float "
+        "VMPP_TABLE[VMPP_TABLE_TEMPERATURES][VMPP_TABLE_CURRENTS][VMPP_TABLE_VOLTAGES] = {"
+    )
+    for t, plane in zip(axis_t, table):
+        lines.append(f"    {{ // {t - 273.15:g} C")
+        for row in plane:
+            lines.append("        { " + ", ".join(fmt(v) for v in row) + " },")
+        lines.append("    },")
+    lines.append("};")
+    lines.append("")
+
+    with open(path, "w") as fp:
+        fp.write("\n".join(lines))
+
+
+if __name__ == "__main__":
+    if sys.version_info[0] < 3:
+        raise Exception("This program only supports Python 3.")
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("design_specs_path")
+    parser.add_argument("output_path", help="Generated header, i.e. fw/inc/mppt/vmpp_table.hpp.")
+    parser.add_argument("--curves", type=int, default=8000)
+    parser.add_argument("--points", type=int, default=600, help="Current sweep points per curve.")
+    parser.add_argument("--samples", type=int, default=4, help="Operating points per curve.")
+    parser.add_argument("--substrings", type=int, default=5)
+    parser.add_argument("--v_bypass", type=float, default=0.4, help="Bypass diode drop (V).")
+    parser.add_argument("--irradiance", type=float, nargs=2, default=[50.0, 1100.0], help="W/m^2.")
+    parser.add_argument("--temperature", type=float, nargs=2, default=[0.0, 70.0], help="Cell, C.")
+    parser.add_argument("--shaded", type=float, default=0.3, help="Fraction of shaded curves.")
+    parser.add_argument("--current", type=float, nargs=2, default=[0.0, 6.5], help="Table axis (A).")
+    parser.add_argument("--voltage", type=float, nargs=2, default=[20.0, 70.0], help="Table axis (V).")
+    parser.add_argument(
+        "--size", type=int, nargs=3, default=[8, 12, 16], help="Temperature by current by voltage nodes."
+    )
+    parser.add_argument("--smoothing", type=float, default=10.0)
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    logging.basicConfig(format="%(message)s", level=logging.INFO)
+
+    with open(args.design_specs_path) as fp:
+        source = json.load(fp)["DESIGN"]["input_source"]
+
+    rng = np.random.default_rng(args.seed)
+    curves = simulate_curves(source, args, rng)
+    v, i, curve = sample_operating_points(curves, args, rng)
+    t = curves["t"][curve]
+    shaded = curves["shaded"][curve]
+    test = (rng.random(args.curves) < 0.3)[curve]
+    train = ~test & ~shaded
+    logging.info(f"{len(v)} operating points on {len(np.unique(curve))} curves, {train.sum()} to train.")
+
+    axis_t = np.linspace(args.temperature[0], args.temperature[1], args.size[0]) + 273.15
+    axis_i = np.linspace(args.current[0], args.current[1], args.size[1])
+    axis_v = np.linspace(args.voltage[0], args.voltage[1], args.size[2])
+    axes = (axis_t, axis_i, axis_v)
+    points = (t, i, v)
+    table = fit_table(
+        [x[train] for x in points], curves["vmpp"][curve[train]], axes, args.smoothing
+    )
+    predicted = interpolation_matrix(points, axes) @ table.ravel()
+
+    bounds = {
+        "uniform": error_bounds(curves, predicted, curve, test & ~shaded),
+        "shaded": error_bounds(curves, predicted, curve, test & shaded),
+    }
+    for name, b in bounds.items():
+        logging.info(
+            f"{name}: |error| p50 {b['p50']:.2f} V, p95 {b['p95']:.2f} V, max {b['max']:.2f} V, "
+            f"harvest {100 * b['harvest']:.2f}% (p5 {100 * b['harvest_p5']:.2f}%)"
+        )
+    emit_header(table, axis_t, axis_i, axis_v, bounds, args.output_path, args, source)